@@ -0,0 +1,1033 @@
+/*! \file amelioration.c
+    \brief tournées approchées pour les grandes instances : tournée initiale (plus proche
+           voisin ou courbe de Hilbert) puis recherche locale 2-opt, Or-opt et chaînes de
+           Lin-Kernighan sur listes de voisins
+
+    Le solveur exact (vdc.c) ne dépasse pas quelques dizaines de villes ; ici la tournée
+    est d'abord construite en une passe, puis améliorée par des échanges locaux :
+      - une chaîne de Lin-Kernighan part d'une arête (t1,t2) de la tournée et enchaîne
+        des 2-opt : à chaque pas, une nouvelle arête (t2,t3) vers un voisin de t2 remplace
+        l'arête (t3,t4) de la tournée, et t4 devient l'extrémité libre. La chaîne s'arrête
+        quand le gain partiel devient nul ou à la profondeur maximale ; la tournée est
+        ramenée au meilleur pas fermé (arête (t4,t1)). Une arête ajoutée n'est jamais
+        retirée dans la même chaîne, ni une arête retirée remise. À la profondeur 1,
+        c'est un 2-opt ;
+      - un déplacement Or-opt réinsère un segment de 1 à 3 villes, dans un sens ou dans
+        l'autre, entre deux villes consécutives proches de ses extrémités.
+    Les candidats sont les k plus proches voisins de chaque ville (grille pour une
+    instance euclidienne, table des distances sinon). Les bits "ne pas regarder" sont
+    une file des villes actives : une ville n'est réexaminée que si une de ses arêtes a
+    changé depuis son dernier examen.
+
+    La tournée est un tableau (tour) et sa réciproque (pos) ; un 2-opt retourne le plus
+    court des deux morceaux, et un Or-opt s'écrit comme deux ou trois 2-opt.
+
+    MultiDepart lance une suite de descentes par thread, chacune depuis une tournée du plus
+    proche voisin tirée au hasard ou depuis un croisement avec la meilleure tournée
+    partagée. La longueur de celle-ci se lit sans verrou : seules les descentes qui la
+    battent prennent le verrou pour recopier leur tournée.
+
+    Usage : AEtoile.exe tournee graphe [options]
+            AEtoile.exe tournee --euclidien n [options]
+      --metrique           distances de plus court chemin (voir fermeture.c)
+      --floyd              comme --metrique, par Floyd-Warshall (voir floyd.c)
+      --exact              compare au solveur exact (heuristique 3), sur les petites cartes
+      --euclidien n        n villes tirées uniformément dans un carré de côté 10^6
+      --graine s           graine du tirage (défaut : 1)
+      --voisins k          voisins candidats par ville (défaut : AMELIORATION_VOISINS)
+      --profondeur p       échanges par chaîne (défaut : AMELIORATION_PROFONDEUR, 1 : 2-opt)
+      --sans-oropt         pas de déplacements Or-opt
+      --depart d           tournée initiale : glouton (plus proche voisin) ou hilbert
+                           (défaut : hilbert si les villes ont des coordonnées)
+      --duree ms           échéance de la recherche locale
+      --multi t            descentes parallèles sur t threads (0 : tous les coeurs), voir MultiDepart
+      --departs d          descentes par thread (défaut : une, sauf avec --duree ou une cible)
+      --echange e          une descente sur e repart d'un segment de la meilleure tournée (défaut : 4)
+      --cible c            arrêt dès qu'une tournée de longueur <= c est trouvée
+      --ecart p            cible à p % au-dessus de l'optimum (--exact) ou de l'estimation BHH
+*/
+#include "amelioration.h"
+#include "vdc.h"
+#include "fermeture.h"
+#include "floyd.h"
+#include "graphaux.h"
+#include <math.h>
+#include <omp.h>
+#include <pthread.h>
+
+/*! \def SUC(w, a)
+    \brief ville qui suit a dans la tournée
+*/
+#define SUC(w, a) ((w)->tour[((w)->pos[a] + 1 == (w)->n) ? 0 : (w)->pos[a] + 1])
+
+/*! \def PRE(w, a)
+    \brief ville qui précède a dans la tournée
+*/
+#define PRE(w, a) ((w)->tour[((w)->pos[a] == 0) ? (w)->n - 1 : (w)->pos[a] - 1])
+
+/*! \def D(w, a, b)
+    \brief distance entre les villes a et b
+*/
+#define D(w, a, b) DistanceInstance((w)->inst, a, b)
+
+/*! \def RAPPORT_BHH
+    \brief constante de Beardwood-Halton-Hammersley : une tournée optimale de n villes
+           uniformes sur un carré d'aire A mesure environ 0.7124 sqrt(n A)
+*/
+#define RAPPORT_BHH 0.7124
+
+/* ====================================================================== */
+/* ====================================================================== */
+/* INSTANCES */
+/* ====================================================================== */
+/* ====================================================================== */
+
+/* ====================================================================== */
+/*! \fn long DistanceInstance(InstanceTournee *inst, int a, int b)
+    \return la distance entre a et b (AMELIORATION_ABSENTE si la table n'a pas de route)
+*/
+long DistanceInstance(InstanceTournee *inst, int a, int b){
+  if (inst->ctx != NULL){
+    long d = ARETE(inst->ctx, a, b);
+    return (d < 0) ? AMELIORATION_ABSENTE : d;
+  }
+  double dx = inst->x[a] - inst->x[b], dy = inst->y[a] - inst->y[b];
+  return (long)(sqrt(dx * dx + dy * dy) + 0.5);
+}
+
+/* ====================================================================== */
+/*! \fn static void InsereVoisin(int *v, long *d, int k, int *m, int b, long db)
+    \brief insère b (à distance db) dans la liste triée v des m <= k plus proches
+*/
+static void InsereVoisin(int *v, long *d, int k, int *m, int b, long db){
+  int i;
+  if ((*m == k) && (db >= d[k - 1])) return;
+  i = (*m < k) ? (*m)++ : k - 1;
+  for (; (i > 0) && (d[i - 1] > db); i--){
+    v[i] = v[i - 1];
+    d[i] = d[i - 1];
+  }
+  v[i] = b;
+  d[i] = db;
+}
+
+/* ====================================================================== */
+/*! \fn static InstanceTournee* AlloueInstance(int n, int k)
+    \return une instance de n villes dont les listes de voisins sont à remplir
+*/
+static InstanceTournee* AlloueInstance(int n, int k){
+  InstanceTournee *inst = (InstanceTournee *)calloc(1, sizeof(InstanceTournee));
+  if (inst == NULL)
+  {   fprintf(stderr, "AlloueInstance : calloc failed\n");
+      exit(0);
+  }
+  inst->n = n;
+  inst->k = max(1, min(k, n - 1));
+  inst->voisins = (int *)malloc(((n > 0) ? (long)n * inst->k : 1) * sizeof(int));
+  if (inst->voisins == NULL)
+  {   fprintf(stderr, "AlloueInstance : malloc failed\n");
+      exit(0);
+  }
+  return inst;
+}
+
+/* ====================================================================== */
+/*! \fn InstanceTournee* InstanceContexte(ContexteSolveur *ctx, int k)
+    \param ctx : un contexte (ses distances, vues sans orientation, sont celles de l'instance)
+    \param k : nombre de voisins par ville
+    \return l'instance ; les coordonnées du graphe du contexte sont recopiées s'il en a
+    \brief les voisins sont cherchés dans toute la table, en O(n^2) (une ville par thread)
+*/
+InstanceTournee* InstanceContexte(ContexteSolveur *ctx, int k){
+  InstanceTournee *inst = AlloueInstance(ctx->nsom, k);
+  int n = ctx->nsom, a;
+
+  inst->ctx = ctx;
+  if ((ctx->G != NULL) && (ctx->villes == NULL)){
+    int coordonnees = 0;
+    for (a = 0; a < n; a++) if ((ctx->G->x[a] != 0) || (ctx->G->y[a] != 0)) coordonnees = 1;
+    if (coordonnees){
+      inst->x = (double *)malloc(n * sizeof(double));
+      inst->y = (double *)malloc(n * sizeof(double));
+      if ((inst->x == NULL) || (inst->y == NULL))
+      {   fprintf(stderr, "InstanceContexte : malloc failed\n");
+          exit(0);
+      }
+      memcpy(inst->x, ctx->G->x, n * sizeof(double));
+      memcpy(inst->y, ctx->G->y, n * sizeof(double));
+    }
+  }
+
+#pragma omp parallel
+  {
+    long *d = (long *)malloc(inst->k * sizeof(long));
+    int b, m, i;
+    if (d == NULL)
+    {   fprintf(stderr, "InstanceContexte : malloc failed\n");
+        exit(0);
+    }
+#pragma omp for schedule(dynamic, 16)
+    for (a = 0; a < n; a++){
+      int *v = inst->voisins + (long)a * inst->k;
+      for (m = 0, b = 0; b < n; b++)
+        if ((b != a) && (ARETE(ctx, a, b) >= 0)) InsereVoisin(v, d, inst->k, &m, b, ARETE(ctx, a, b));
+      for (i = m; i < inst->k; i++) v[i] = -1;
+    }
+    free(d);
+  }
+  return inst;
+}
+
+/* ====================================================================== */
+/*! \fn InstanceTournee* InstanceEuclidienne(double *x, double *y, int n, int k)
+    \param x, y : coordonnées des n villes (recopiées)
+    \param n : nombre de villes
+    \param k : nombre de voisins par ville
+    \return l'instance euclidienne
+    \brief les voisins sont cherchés dans une grille d'environ deux villes par case, par
+           couronnes de cases autour de la ville jusqu'à ce que la couronne suivante ne
+           puisse plus contenir de ville plus proche que le k-ième voisin
+*/
+InstanceTournee* InstanceEuclidienne(double *x, double *y, int n, int k){
+  InstanceTournee *inst = AlloueInstance(n, k);
+  double xmin = x[0], xmax = x[0], ymin = y[0], ymax = y[0], cote;
+  int g = max(1, (int)sqrt(n / 2.0)), a, c, *debut, *membres;
+
+  inst->x = (double *)malloc(n * sizeof(double));
+  inst->y = (double *)malloc(n * sizeof(double));
+  debut = (int *)calloc(g * g + 2, sizeof(int));
+  membres = (int *)malloc(n * sizeof(int));
+  if ((inst->x == NULL) || (inst->y == NULL) || (debut == NULL) || (membres == NULL))
+  {   fprintf(stderr, "InstanceEuclidienne : malloc failed\n");
+      exit(0);
+  }
+  memcpy(inst->x, x, n * sizeof(double));
+  memcpy(inst->y, y, n * sizeof(double));
+  for (a = 0; a < n; a++){
+    xmin = min(xmin, x[a]);
+    xmax = max(xmax, x[a]);
+    ymin = min(ymin, y[a]);
+    ymax = max(ymax, y[a]);
+  }
+  cote = max(max(xmax - xmin, ymax - ymin) / g, 1e-9) * (1 + 1e-9);
+
+  /* cases, rangées par tri par dénombrement */
+#define CASE_X(a) min(g - 1, (int)((x[a] - xmin) / cote))
+#define CASE_Y(a) min(g - 1, (int)((y[a] - ymin) / cote))
+  for (a = 0; a < n; a++) debut[CASE_Y(a) * g + CASE_X(a) + 2]++;
+  for (c = 0; c < g * g; c++) debut[c + 2] += debut[c + 1];
+  for (a = 0; a < n; a++) membres[debut[CASE_Y(a) * g + CASE_X(a) + 1]++] = a;
+
+#pragma omp parallel
+  {
+    long *d = (long *)malloc(inst->k * sizeof(long));
+    int b, m, i, r, cx, cy, px, py, e;
+    if (d == NULL)
+    {   fprintf(stderr, "InstanceEuclidienne : malloc failed\n");
+        exit(0);
+    }
+#pragma omp for schedule(dynamic, 64)
+    for (a = 0; a < n; a++){
+      int *v = inst->voisins + (long)a * inst->k;
+      cx = CASE_X(a);
+      cy = CASE_Y(a);
+      for (m = 0, r = 0; r <= g; r++){
+        if ((m == inst->k) && (d[m - 1] < (r - 1) * cote - 1)) break; /* couronne r trop loin */
+        for (py = cy - r; py <= cy + r; py++){
+          if ((py < 0) || (py >= g)) continue;
+          for (px = cx - r; px <= cx + r; px += ((py == cy - r) || (py == cy + r) || (r == 0)) ? 1 : 2 * r){
+            if ((px < 0) || (px >= g)) continue;
+            for (e = debut[py * g + px]; e < debut[py * g + px + 1]; e++)
+              if ((b = membres[e]) != a) InsereVoisin(v, d, inst->k, &m, b, DistanceInstance(inst, a, b));
+          }
+        }
+      }
+      for (i = m; i < inst->k; i++) v[i] = -1;
+    }
+    free(d);
+  }
+#undef CASE_X
+#undef CASE_Y
+  free(debut);
+  free(membres);
+  return inst;
+}
+
+/* ====================================================================== */
+/*! \fn void TermineInstanceTournee(InstanceTournee *inst)
+    \param inst : une instance (le contexte n'est pas libéré)
+*/
+void TermineInstanceTournee(InstanceTournee *inst){
+  free(inst->x);
+  free(inst->y);
+  free(inst->voisins);
+  free(inst);
+}
+
+/* ====================================================================== */
+/*! \fn long CoutTournee(InstanceTournee *inst, int *tournee)
+    \param inst : une instance
+    \param tournee : les n villes dans l'ordre de visite (retour implicite à la première)
+    \return la longueur de la tournée fermée
+*/
+long CoutTournee(InstanceTournee *inst, int *tournee){
+  long cout = 0;
+  int i;
+  for (i = 0; i < inst->n; i++) cout += DistanceInstance(inst, tournee[i], tournee[(i + 1) % inst->n]);
+  return cout;
+}
+
+/* ====================================================================== */
+/* ====================================================================== */
+/* TOURNEES INITIALES */
+/* ====================================================================== */
+/* ====================================================================== */
+
+/* ====================================================================== */
+/*! \fn static void PlusProcheVoisin(InstanceTournee *inst, int depart, Alea *a, int *tournee, char *visitee)
+    \param inst : une instance
+    \param depart : première ville
+    \param a : si non NULL, chaque voisin non visité est écarté avec une probabilité 1/4
+               (sauf le dernier), ce qui donne des tournées différentes d'un tirage à l'autre
+    \param tournee : (sortie) les n villes
+    \param visitee : tableau de travail de n cases
+    \brief va toujours à la plus proche ville non visitée : d'abord parmi les voisins,
+           sinon parmi toutes les villes
+*/
+static void PlusProcheVoisin(InstanceTournee *inst, int depart, Alea *a, int *tournee, char *visitee){
+  int n = inst->n, i, j, u, b, c;
+  long db;
+
+  memset(visitee, 0, n * sizeof(char));
+  tournee[0] = depart;
+  visitee[depart] = 1;
+  for (i = 1; i < n; i++){
+    u = tournee[i - 1];
+    for (b = -1, j = 0; (j < inst->k) && ((c = inst->voisins[(long)u * inst->k + j]) >= 0); j++)
+      if (!visitee[c]){
+        b = c;
+        if ((a == NULL) || (AleaEntier(a, 4) != 0)) break;
+      }
+    if (b < 0)
+      for (db = 0, j = 0; j < n; j++)
+        if (!visitee[j] && ((b < 0) || (DistanceInstance(inst, u, j) < db))){
+          b = j;
+          db = DistanceInstance(inst, u, j);
+        }
+    tournee[i] = b;
+    visitee[b] = 1;
+  }
+}
+
+/* ====================================================================== */
+/*! \fn int* TourneePlusProcheVoisin(InstanceTournee *inst, int depart)
+    \param inst : une instance
+    \param depart : première ville
+    \return la tournée (à libérer par l'appelant) qui va toujours à la plus proche ville
+            non visitée : d'abord parmi les voisins, sinon parmi toutes les villes
+*/
+int* TourneePlusProcheVoisin(InstanceTournee *inst, int depart){
+  int *tournee = (int *)malloc(inst->n * sizeof(int));
+  char *visitee = (char *)malloc(inst->n * sizeof(char));
+
+  if ((tournee == NULL) || (visitee == NULL))
+  {   fprintf(stderr, "TourneePlusProcheVoisin : malloc failed\n");
+      exit(0);
+  }
+  PlusProcheVoisin(inst, depart, NULL, tournee, visitee);
+  free(visitee);
+  return tournee;
+}
+
+/*! \struct CleVille
+    \brief ville et sa clé de tri
+*/
+typedef struct CleVille {
+  long long cle;
+  int ville;
+} CleVille;
+
+/* ====================================================================== */
+/*! \fn static int CompareCleVille(const void *a, const void *b)
+    \brief ordre croissant des clés
+*/
+static int CompareCleVille(const void *a, const void *b){
+  long long u = ((CleVille *)a)->cle, v = ((CleVille *)b)->cle;
+  return (u < v) ? -1 : (u > v) ? 1 : 0;
+}
+
+/* ====================================================================== */
+/*! \fn static long long IndiceHilbert(unsigned int x, unsigned int y)
+    \return la position du point (x,y) de la grille 2^16 x 2^16 le long de la courbe de Hilbert
+*/
+static long long IndiceHilbert(unsigned int x, unsigned int y){
+  const unsigned int cote = 1u << 16;
+  unsigned int s, rx, ry, t;
+  long long d = 0;
+  for (s = cote / 2; s > 0; s /= 2){
+    rx = (x & s) > 0;
+    ry = (y & s) > 0;
+    d += (long long)s * s * ((3 * rx) ^ ry);
+    if (ry == 0){ /* rotation du quadrant */
+      if (rx == 1){
+        x = cote - 1 - x;
+        y = cote - 1 - y;
+      }
+      t = x;
+      x = y;
+      y = t;
+    }
+  }
+  return d;
+}
+
+/* ====================================================================== */
+/*! \fn int* TourneeHilbert(InstanceTournee *inst)
+    \param inst : une instance
+    \return la tournée (à libérer par l'appelant) qui suit la courbe de Hilbert à travers
+            le carré englobant les villes, NULL si l'instance n'a pas de coordonnées
+*/
+int* TourneeHilbert(InstanceTournee *inst){
+  int n = inst->n, a, *tournee;
+  double xmin, ymin, cote = 0;
+  CleVille *cles;
+
+  if (inst->x == NULL) return NULL;
+  tournee = (int *)malloc(n * sizeof(int));
+  cles = (CleVille *)malloc(n * sizeof(CleVille));
+  if ((tournee == NULL) || (cles == NULL))
+  {   fprintf(stderr, "TourneeHilbert : malloc failed\n");
+      exit(0);
+  }
+  xmin = inst->x[0];
+  ymin = inst->y[0];
+  for (a = 0; a < n; a++){
+    xmin = min(xmin, inst->x[a]);
+    ymin = min(ymin, inst->y[a]);
+  }
+  for (a = 0; a < n; a++) cote = max(cote, max(inst->x[a] - xmin, inst->y[a] - ymin));
+  if (cote == 0) cote = 1;
+  for (a = 0; a < n; a++){
+    cles[a].ville = a;
+    cles[a].cle = IndiceHilbert((unsigned int)((inst->x[a] - xmin) / cote * 65535),
+                                (unsigned int)((inst->y[a] - ymin) / cote * 65535));
+  }
+  qsort(cles, n, sizeof(CleVille), CompareCleVille);
+  for (a = 0; a < n; a++) tournee[a] = cles[a].ville;
+  free(cles);
+  return tournee;
+}
+
+/* ====================================================================== */
+/* ====================================================================== */
+/* RECHERCHE LOCALE */
+/* ====================================================================== */
+/* ====================================================================== */
+
+/*! \struct TravailAmelioration
+    \brief état de la recherche locale
+*/
+typedef struct TravailAmelioration {
+  InstanceTournee *inst;
+  int n;
+//! tournee[i] : i-ème ville ; pos[a] : indice de a dans tour
+  int *tour, *pos;
+//! file circulaire des villes actives (bits "ne pas regarder" à zéro)
+  int *file;
+  int tete, nfile;
+  char *active;
+//! échanges de la chaîne en cours (arguments de DeuxOpt) et arêtes ajoutées et retirées
+  int journal[AMELIORATION_PROFONDEUR * 4 + 4][4];
+  int ajoutees[AMELIORATION_PROFONDEUR * 4 + 4][2];
+  int retirees[AMELIORATION_PROFONDEUR * 4 + 4][2];
+} TravailAmelioration;
+
+/* ====================================================================== */
+/*! \fn static void Active(TravailAmelioration *w, int a)
+    \brief remet a dans la file des villes à examiner
+*/
+static void Active(TravailAmelioration *w, int a){
+  if (w->active[a]) return;
+  w->active[a] = 1;
+  w->file[(w->tete + w->nfile++) % w->n] = a;
+}
+
+/* ====================================================================== */
+/*! \fn static void Inverse(TravailAmelioration *w, int a, int b)
+    \brief retourne le chemin de a à b (dans le sens de la tournée), ou le reste de la
+           tournée s'il est plus court : la tournée vue sans orientation est la même
+*/
+static void Inverse(TravailAmelioration *w, int a, int b){
+  int n = w->n, i = w->pos[a], j = w->pos[b], l = j - i, x;
+
+  if (l < 0) l += n;
+  l++;
+  if (2 * l > n){
+    i = (w->pos[b] + 1) % n;
+    j = (w->pos[a] + n - 1) % n;
+    l = n - l;
+  }
+  for (; l > 1; l -= 2){
+    x = w->tour[i];
+    w->tour[i] = w->tour[j];
+    w->tour[j] = x;
+    w->pos[w->tour[i]] = i;
+    w->pos[w->tour[j]] = j;
+    if (++i == n) i = 0;
+    if (--j < 0) j = n - 1;
+  }
+}
+
+/* ====================================================================== */
+/*! \fn static void DeuxOpt(TravailAmelioration *w, int a, int b, int c, int d)
+    \brief remplace les arêtes {a,b} et {c,d} de la tournée par {a,c} et {b,d} ; b suit a
+           si et seulement si d suit c
+*/
+static void DeuxOpt(TravailAmelioration *w, int a, int b, int c, int d){
+  if (SUC(w, a) == b) Inverse(w, b, c);
+  else Inverse(w, a, d);
+}
+
+/* ====================================================================== */
+/*! \fn static int AreteDans(int (*aretes)[2], int m, int a, int b)
+    \return 1 si l'arête {a,b} est parmi les m arêtes
+*/
+static int AreteDans(int (*aretes)[2], int m, int a, int b){
+  int i;
+  for (i = 0; i < m; i++)
+    if (((aretes[i][0] == a) && (aretes[i][1] == b)) || ((aretes[i][0] == b) && (aretes[i][1] == a))) return 1;
+  return 0;
+}
+
+/* ====================================================================== */
+/*! \fn static long ChaineLK(TravailAmelioration *w, int t1, int t2, int profondeur)
+    \return le gain de la chaîne appliquée depuis l'arête (t1,t2), 0 si aucune chaîne
+            n'améliore la tournée (elle est alors inchangée)
+    \brief les AMELIORATION_LARGEUR premiers voisins de t2 sont essayés comme premier
+           échange, puis la chaîne suit à chaque pas le meilleur candidat
+*/
+static long ChaineLK(TravailAmelioration *w, int t1, int t2, int profondeur){
+  InstanceTournee *inst = w->inst;
+  int essais = 0, i, j, m, meilleur_pas, t3, t4, u2, c, c4, choix;
+  long g, gi, fermeture, meilleur, valeur, valeur_choix;
+
+  for (i = 0; (i < inst->k) && (essais < AMELIORATION_LARGEUR); i++){
+    t3 = inst->voisins[(long)t2 * inst->k + i];
+    if (t3 < 0) break;
+    if (D(w, t1, t2) - D(w, t2, t3) <= 0) break; /* voisins triés : plus de gain possible */
+    if ((t3 == SUC(w, t2)) || (t3 == PRE(w, t2))) continue;
+    essais++;
+
+    g = D(w, t1, t2);
+    meilleur = 0;
+    meilleur_pas = 0;
+    m = 0;
+    w->retirees[0][0] = t1;
+    w->retirees[0][1] = t2;
+    u2 = t2;
+    for (;;){
+      t4 = (SUC(w, t1) == u2) ? PRE(w, t3) : SUC(w, t3);
+      w->journal[m][0] = u2;
+      w->journal[m][1] = t1;
+      w->journal[m][2] = t3;
+      w->journal[m][3] = t4;
+      DeuxOpt(w, u2, t1, t3, t4);
+      g += D(w, t3, t4) - D(w, u2, t3);
+      w->ajoutees[m][0] = u2;
+      w->ajoutees[m][1] = t3;
+      w->retirees[m + 1][0] = t3;
+      w->retirees[m + 1][1] = t4;
+      m++;
+      fermeture = g - D(w, t4, t1);
+      if (fermeture > meilleur){
+        meilleur = fermeture;
+        meilleur_pas = m;
+      }
+      u2 = t4;
+      if (m == profondeur) break;
+
+      /* pas suivant : le voisin c de u2 qui maximise g - d(u2,c) + d(c,c4) */
+      choix = -1;
+      valeur_choix = 0;
+      for (j = 0; j < inst->k; j++){
+        c = inst->voisins[(long)u2 * inst->k + j];
+        if (c < 0) break;
+        gi = g - D(w, u2, c);
+        if (gi <= 0) break;
+        if ((c == SUC(w, u2)) || (c == PRE(w, u2)) || AreteDans(w->retirees, m + 1, u2, c)) continue;
+        c4 = (SUC(w, t1) == u2) ? PRE(w, c) : SUC(w, c);
+        if (AreteDans(w->ajoutees, m, c, c4)) continue;
+        valeur = gi + D(w, c, c4);
+        if ((choix < 0) || (valeur > valeur_choix)){
+          choix = c;
+          valeur_choix = valeur;
+        }
+      }
+      if (choix < 0) break;
+      t3 = choix;
+    }
+
+    /* retour au meilleur pas fermé */
+    while (m > meilleur_pas){
+      m--;
+      DeuxOpt(w, w->journal[m][0], w->journal[m][2], w->journal[m][1], w->journal[m][3]);
+    }
+    if (meilleur > 0){
+      for (j = 0; j < m; j++)
+        for (c = 0; c < 4; c++) Active(w, w->journal[j][c]);
+      return meilleur;
+    }
+  }
+  return 0;
+}
+
+/* ====================================================================== */
+/*! \fn static int DansSegment(TravailAmelioration *w, int s1, int l, int c)
+    \return 1 si c est une des l villes qui commencent à s1
+*/
+static int DansSegment(TravailAmelioration *w, int s1, int l, int c){
+  int k = w->pos[c] - w->pos[s1];
+  if (k < 0) k += w->n;
+  return k < l;
+}
+
+/* ====================================================================== */
+/*! \fn static long OrOpt(TravailAmelioration *w, int t1)
+    \return le gain du premier déplacement Or-opt améliorant trouvé pour un segment de
+            1 à 3 villes commençant ou finissant à t1, 0 s'il n'y en a pas
+    \brief le segment s1..s2, entre p et q, est réinséré entre deux villes consécutives e
+           et f dont l'une est voisine de s1 ou de s2, dans le sens qui gagne le plus.
+           Les cas où e suit q ou f précède p sont des déplacements de q ou de p,
+           examinés depuis ces villes.
+*/
+static long OrOpt(TravailAmelioration *w, int t1){
+  InstanceTournee *inst = w->inst;
+  int l, sens, s1, s2, p, q, bout, i, j, c, e, f, cote;
+  long base, direct, inverse;
+
+  for (l = 1; l <= 3; l++)
+    for (sens = 0; sens < 2; sens++){
+      if ((l == 1) && sens) continue;
+      s1 = s2 = t1;
+      for (i = 1; i < l; i++){
+        if (sens) s1 = PRE(w, s1);
+        else s2 = SUC(w, s2);
+      }
+      p = PRE(w, s1);
+      q = SUC(w, s2);
+      base = D(w, p, s1) + D(w, s2, q) - D(w, p, q);
+      if (base <= 0) continue;
+      for (bout = 0; bout < 2; bout++){
+        int s = bout ? s2 : s1;
+        for (j = 0; j < inst->k; j++){
+          c = inst->voisins[(long)s * inst->k + j];
+          if ((c < 0) || (D(w, s, c) >= base)) break;
+          if (DansSegment(w, s1, l, c)) continue;
+          for (cote = 0; cote < 2; cote++){
+            e = cote ? PRE(w, c) : c;
+            f = cote ? c : SUC(w, c);
+            if (DansSegment(w, s1, l, e) || DansSegment(w, s1, l, f) || (e == q) || (f == p)) continue;
+            direct = base + D(w, e, f) - D(w, e, s1) - D(w, s2, f);
+            inverse = base + D(w, e, f) - D(w, e, s2) - D(w, s1, f);
+            if ((direct <= 0) && (inverse <= 0)) continue;
+            DeuxOpt(w, p, s1, e, f);  /* p e .. q s2 .. s1 f */
+            DeuxOpt(w, p, e, q, s2);  /* p q .. e s2 .. s1 f */
+            if (direct > inverse) DeuxOpt(w, e, s2, s1, f); /* e s1 .. s2 f */
+            Active(w, p);
+            Active(w, q);
+            Active(w, s1);
+            Active(w, s2);
+            Active(w, e);
+            Active(w, f);
+            return max(direct, inverse);
+          }
+        }
+      }
+    }
+  return 0;
+}
+
+/* ====================================================================== */
+/*! \fn void OptionsAmeliorationParDefaut(OptionsAmelioration *options)
+    \param options : options à remplir (chaînes de AMELIORATION_PROFONDEUR, Or-opt, sans échéance)
+*/
+void OptionsAmeliorationParDefaut(OptionsAmelioration *options){
+  options->profondeur = AMELIORATION_PROFONDEUR;
+  options->oropt = 1;
+  options->echeance_ns = 0;
+}
+
+/* ====================================================================== */
+/*! \fn long AmelioreTournee(InstanceTournee *inst, int *tournee, OptionsAmelioration *options, StatsAmelioration *stats)
+    \param inst : une instance
+    \param tournee : les n villes, améliorées sur place
+    \param options : paramètres (NULL : OptionsAmeliorationParDefaut)
+    \param stats : (sortie, peut être NULL) compteurs de la recherche
+    \return la longueur de la tournée améliorée
+    \brief toutes les villes sont actives au départ, dans l'ordre de la tournée ; chaque
+           ville sortie de la file essaie une chaîne depuis ses deux arêtes puis un Or-opt,
+           et reste active tant qu'elle améliore
+*/
+long AmelioreTournee(InstanceTournee *inst, int *tournee, OptionsAmelioration *options, StatsAmelioration *stats){
+  OptionsAmelioration defaut;
+  StatsAmelioration st;
+  TravailAmelioration w;
+  long long debut = horloge_ns();
+  int i, t1, sens, profondeur;
+
+  if (options == NULL){
+    OptionsAmeliorationParDefaut(&defaut);
+    options = &defaut;
+  }
+  memset(&st, 0, sizeof(StatsAmelioration));
+  profondeur = max(1, min(options->profondeur, AMELIORATION_PROFONDEUR * 4));
+  if (inst->n >= 5){
+    w.inst = inst;
+    w.n = inst->n;
+    w.tour = tournee;
+    w.pos = (int *)malloc(w.n * sizeof(int));
+    w.file = (int *)malloc(w.n * sizeof(int));
+    w.active = (char *)malloc(w.n * sizeof(char));
+    if ((w.pos == NULL) || (w.file == NULL) || (w.active == NULL))
+    {   fprintf(stderr, "AmelioreTournee : malloc failed\n");
+        exit(0);
+    }
+    for (i = 0; i < w.n; i++){
+      w.pos[tournee[i]] = i;
+      w.file[i] = tournee[i];
+      w.active[i] = 1;
+    }
+    w.tete = 0;
+    w.nfile = w.n;
+
+    while (w.nfile > 0){
+      if ((options->echeance_ns > 0) && ((st.examens & 255) == 0) && (horloge_ns() > options->echeance_ns)) break;
+      t1 = w.file[w.tete];
+      w.tete = (w.tete + 1) % w.n;
+      w.nfile--;
+      w.active[t1] = 0;
+      st.examens++;
+      for (sens = 0; sens < 2; sens++)
+        if (ChaineLK(&w, t1, sens ? PRE(&w, t1) : SUC(&w, t1), profondeur) > 0){
+          st.chaines++;
+          Active(&w, t1);
+          break;
+        }
+      if ((sens == 2) && options->oropt && (OrOpt(&w, t1) > 0)){
+        st.deplacements++;
+        Active(&w, t1);
+      }
+    }
+    free(w.pos);
+    free(w.file);
+    free(w.active);
+  }
+  st.duree_ns = horloge_ns() - debut;
+  if (stats != NULL) *stats = st;
+  return CoutTournee(inst, tournee);
+}
+
+/* ====================================================================== */
+/* ====================================================================== */
+/* DESCENTES PARALLELES */
+/* ====================================================================== */
+/* ====================================================================== */
+
+/*! \struct MeilleureTournee
+    \brief meilleure tournée partagée entre les threads : sa longueur se lit sans verrou,
+           la tournée n'est recopiée (dans un sens ou dans l'autre) que sous le verrou
+*/
+typedef struct MeilleureTournee {
+//! longueur de la meilleure tournée (lue et écrite atomiquement)
+  long cout;
+//! la meilleure tournée, NULL tant qu'il n'y en a pas
+  int *tournee;
+//! mis à 1 quand la cible est atteinte
+  int fin;
+  long long debut_ns;
+  StatsMultiDepart *stats;
+  pthread_mutex_t verrou;
+} MeilleureTournee;
+
+/* ====================================================================== */
+/*! \fn static void ProposeTournee(MeilleureTournee *m, int *tournee, int n, long cout)
+    \brief retient la tournée si elle est meilleure que la meilleure tournée partagée
+*/
+static void ProposeTournee(MeilleureTournee *m, int *tournee, int n, long cout){
+  if (cout >= __atomic_load_n(&(m->cout), __ATOMIC_RELAXED)) return;
+  pthread_mutex_lock(&(m->verrou));
+  if (cout < m->cout){
+    memcpy(m->tournee, tournee, n * sizeof(int));
+    __atomic_store_n(&(m->cout), cout, __ATOMIC_RELAXED);
+    m->stats->ameliorations++;
+    m->stats->meilleure_ns = horloge_ns() - m->debut_ns;
+  }
+  pthread_mutex_unlock(&(m->verrou));
+}
+
+/* ====================================================================== */
+/*! \fn static void CroiseTournees(int *propre, int *meilleure, int n, Alea *a, int *sortie, char *pris)
+    \param propre : la dernière tournée du thread
+    \param meilleure : la meilleure tournée partagée (copie)
+    \param n : nombre de villes
+    \param a : générateur du thread
+    \param sortie : (sortie) un segment de n/4 à n/2 villes de meilleure, puis les autres
+                    villes dans l'ordre de propre (croisement ordonné)
+    \param pris : tableau de travail de n cases
+*/
+static void CroiseTournees(int *propre, int *meilleure, int n, Alea *a, int *sortie, char *pris){
+  int l = n / 4 + AleaEntier(a, n / 4 + 1), d = AleaEntier(a, n), i, m;
+
+  memset(pris, 0, n * sizeof(char));
+  for (m = 0; m < l; m++){
+    sortie[m] = meilleure[(d + m) % n];
+    pris[sortie[m]] = 1;
+  }
+  for (i = 0; i < n; i++)
+    if (!pris[propre[i]]) sortie[m++] = propre[i];
+}
+
+/* ====================================================================== */
+/*! \fn void OptionsMultiDepartParDefaut(OptionsMultiDepart *options)
+    \param options : options à remplir (tous les coeurs, un croisement toutes les 4
+                     descentes, une descente par thread en l'absence d'échéance et de cible)
+*/
+void OptionsMultiDepartParDefaut(OptionsMultiDepart *options){
+  options->threads = 0;
+  options->graine = 1;
+  options->departs = 0;
+  options->echange = 4;
+  options->cible = 0;
+  options->echeance_ns = 0;
+  OptionsAmeliorationParDefaut(&(options->amelioration));
+}
+
+/* ====================================================================== */
+/*! \fn long MultiDepart(InstanceTournee *inst, int *meilleure, OptionsMultiDepart *options, StatsMultiDepart *stats)
+    \param inst : une instance
+    \param meilleure : (sortie) les n villes de la meilleure tournée trouvée
+    \param options : paramètres (NULL : OptionsMultiDepartParDefaut)
+    \param stats : (sortie, peut être NULL) compteurs des descentes
+    \return la longueur de la meilleure tournée
+    \brief chaque thread enchaîne des descentes (AmelioreTournee) depuis des tournées du
+           plus proche voisin tirées au hasard à partir de sa propre graine ; une descente
+           sur options->echange repart d'un segment de la meilleure tournée complété par
+           la dernière tournée du thread. Tous s'arrêtent à l'échéance, quand l'un d'eux
+           atteint la cible, ou après options->departs descentes chacun.
+*/
+long MultiDepart(InstanceTournee *inst, int *meilleure, OptionsMultiDepart *options, StatsMultiDepart *stats){
+  OptionsMultiDepart defaut;
+  StatsMultiDepart st;
+  MeilleureTournee m;
+  int n = inst->n, threads, departs;
+
+  if (options == NULL){
+    OptionsMultiDepartParDefaut(&defaut);
+    options = &defaut;
+  }
+  threads = (options->threads > 0) ? options->threads : omp_get_max_threads();
+  departs = options->departs;
+  if ((departs <= 0) && (options->echeance_ns == 0) && (options->cible <= 0)) departs = 1;
+  memset(&st, 0, sizeof(StatsMultiDepart));
+  st.threads = threads;
+  m.cout = AMELIORATION_ABSENTE * (n + 1);
+  m.tournee = meilleure;
+  m.fin = 0;
+  m.debut_ns = horloge_ns();
+  m.stats = &st;
+  pthread_mutex_init(&(m.verrou), NULL);
+
+#pragma omp parallel num_threads(threads)
+  {
+    OptionsAmelioration descente = options->amelioration;
+    int *tournee = (int *)malloc(n * sizeof(int));
+    int *propre = (int *)malloc(n * sizeof(int));
+    int *copie = (int *)malloc(n * sizeof(int));
+    char *marques = (char *)malloc(n * sizeof(char));
+    int d, croise;
+    long cout;
+    Alea a;
+
+    if ((tournee == NULL) || (propre == NULL) || (copie == NULL) || (marques == NULL))
+    {   fprintf(stderr, "MultiDepart : malloc failed\n");
+        exit(0);
+    }
+    InitAlea(&a, options->graine + omp_get_thread_num());
+    descente.echeance_ns = options->echeance_ns;
+    for (d = 0; (departs <= 0) || (d < departs); d++){
+      if (__atomic_load_n(&(m.fin), __ATOMIC_RELAXED)) break;
+      if ((d > 0) && (options->echeance_ns > 0) && (horloge_ns() > options->echeance_ns)) break;
+      croise = (options->echange > 0) && (d > 0) && (d % options->echange == 0);
+      if (croise){
+        pthread_mutex_lock(&(m.verrou));
+        memcpy(copie, m.tournee, n * sizeof(int));
+        pthread_mutex_unlock(&(m.verrou));
+        CroiseTournees(propre, copie, n, &a, tournee, marques);
+      }
+      else PlusProcheVoisin(inst, AleaEntier(&a, n), &a, tournee, marques);
+      cout = AmelioreTournee(inst, tournee, &descente, NULL);
+      memcpy(propre, tournee, n * sizeof(int));
+      ProposeTournee(&m, tournee, n, cout);
+      __atomic_fetch_add(&(st.descentes), 1, __ATOMIC_RELAXED);
+      if (croise) __atomic_fetch_add(&(st.croisements), 1, __ATOMIC_RELAXED);
+      if ((options->cible > 0) && (cout <= options->cible)) __atomic_store_n(&(m.fin), 1, __ATOMIC_RELAXED);
+    }
+    free(tournee);
+    free(propre);
+    free(copie);
+    free(marques);
+  }
+
+  pthread_mutex_destroy(&(m.verrou));
+  st.duree_ns = horloge_ns() - m.debut_ns;
+  if (stats != NULL) *stats = st;
+  return m.cout;
+}
+
+/* ====================================================================== */
+/*! \fn int ModeTournee(int argc, char **argv)
+    \param argc, argv : arguments qui suivent "tournee" (voir l'en-tête du fichier)
+    \return 0, ou 1 si les arguments sont invalides
+    \brief construit puis améliore une tournée (ou lance les descentes parallèles), et
+           affiche sa longueur, le débit de la recherche locale et, selon l'instance,
+           l'écart au solveur exact ou le rapport à l'estimation de Beardwood-Halton-Hammersley
+*/
+int ModeTournee(int argc, char **argv){
+  char *nomgraphe = NULL;
+  int metrique = 0, exact = 0, euclidien = 0, k = AMELIORATION_VOISINS, hilbert = -1, multi = -1, i, *tournee;
+  unsigned long long graine = 1;
+  long cout_initial, cout, reference = 0;
+  long long debut, duree_initiale, duree = 0;
+  double cote = 1e6, ecart = -1, *x, *y;
+  graphe *G = NULL;
+  ContexteSolveur *ctx = NULL;
+  InstanceTournee *inst;
+  OptionsMultiDepart options;
+  OptionsAmelioration *descente = &(options.amelioration);
+  StatsAmelioration stats;
+  StatsMultiDepart stats_multi;
+
+  OptionsMultiDepartParDefaut(&options);
+  for (i = 0; i < argc; i++){
+    if (!strcmp(argv[i], "--metrique")) metrique = 1;
+    else if (!strcmp(argv[i], "--floyd")) metrique = 2;
+    else if (!strcmp(argv[i], "--exact")) exact = 1;
+    else if (!strcmp(argv[i], "--euclidien") && (i + 1 < argc)) euclidien = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--graine") && (i + 1 < argc)) graine = strtoull(argv[++i], NULL, 10);
+    else if (!strcmp(argv[i], "--voisins") && (i + 1 < argc)) k = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--profondeur") && (i + 1 < argc)) descente->profondeur = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--sans-oropt")) descente->oropt = 0;
+    else if (!strcmp(argv[i], "--duree") && (i + 1 < argc)) duree = atoll(argv[++i]) * 1000000LL;
+    else if (!strcmp(argv[i], "--multi") && (i + 1 < argc)) multi = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--departs") && (i + 1 < argc)) options.departs = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--echange") && (i + 1 < argc)) options.echange = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--cible") && (i + 1 < argc)) options.cible = atol(argv[++i]);
+    else if (!strcmp(argv[i], "--ecart") && (i + 1 < argc)) ecart = atof(argv[++i]);
+    else if (!strcmp(argv[i], "--depart") && (i + 1 < argc)){
+      i++;
+      if (!strcmp(argv[i], "glouton")) hilbert = 0;
+      else if (!strcmp(argv[i], "hilbert")) hilbert = 1;
+      else {
+        fprintf(stderr, "tournee : tournée initiale inconnue %s\n", argv[i]);
+        return 1;
+      }
+    }
+    else if ((nomgraphe == NULL) && !euclidien) nomgraphe = argv[i];
+    else {
+      fprintf(stderr, "tournee : argument inconnu %s\n", argv[i]);
+      return 1;
+    }
+  }
+  if (((nomgraphe == NULL) && (euclidien < 2)) || (k < 1) || ((ecart >= 0) && !euclidien && !exact)){
+    fprintf(stderr, "Usage : ./AEtoile.exe tournee graphe [--metrique|--floyd] [--exact] [options]\n");
+    fprintf(stderr, "        ./AEtoile.exe tournee --euclidien n [--graine s] [options]\n");
+    fprintf(stderr, "options : [--voisins k] [--profondeur p] [--sans-oropt] [--depart glouton|hilbert] [--duree ms]\n");
+    fprintf(stderr, "          [--multi t [--departs d] [--echange e] [--cible c | --ecart p]]\n");
+    return 1;
+  }
+
+  debut = horloge_ns();
+  if (euclidien){
+    Alea a;
+    x = (double *)malloc(euclidien * sizeof(double));
+    y = (double *)malloc(euclidien * sizeof(double));
+    if ((x == NULL) || (y == NULL))
+    {   fprintf(stderr, "ModeTournee : malloc failed\n");
+        exit(0);
+    }
+    InitAlea(&a, graine);
+    for (i = 0; i < euclidien; i++){
+      x[i] = AleaReel(&a) * cote;
+      y[i] = AleaReel(&a) * cote;
+    }
+    inst = InstanceEuclidienne(x, y, euclidien, k);
+    free(x);
+    free(y);
+    reference = (long)(RAPPORT_BHH * sqrt(inst->n * cote * cote));
+  }
+  else {
+    if ((G = ReadGraphe(nomgraphe)) == NULL) return 1;
+    if (metrique == 2) ctx = ContexteFloyd(G, NULL);
+    else ctx = metrique ? ContexteMetrique(G, NULL) : CreeContexte(G, NULL);
+    inst = InstanceContexte(ctx, k);
+  }
+  printf("instance : %d villes, %d voisins en %.3f s\n", inst->n, inst->k, (horloge_ns() - debut) / 1e9);
+
+  if (exact && !euclidien){
+    EspaceTravail *ws = CreeEspaceTravail();
+    pnode res;
+    debut = horloge_ns();
+    res = Resoudre(ctx, NULL, ws, NULL);
+    if (res == NULL) printf("exact : pas de solution\n");
+    else {
+      reference = res->estim_g;
+      printf("exact : cout %ld en %.3f s\n", reference, (horloge_ns() - debut) / 1e9);
+      freeNode(res);
+    }
+    TermineEspaceTravail(ws);
+  }
+  if ((ecart >= 0) && (reference > 0)) options.cible = (long)(reference * (1 + ecart / 100));
+
+  if (multi >= 0){
+    options.threads = multi;
+    options.graine = graine;
+    if (duree > 0) options.echeance_ns = horloge_ns() + duree;
+    tournee = (int *)malloc(inst->n * sizeof(int));
+    if (tournee == NULL)
+    {   fprintf(stderr, "ModeTournee : malloc failed\n");
+        exit(0);
+    }
+    cout = MultiDepart(inst, tournee, &options, &stats_multi);
+    printf("multi-depart : %d threads, %ld descentes dont %ld croisements, %ld ameliorations\n",
+           stats_multi.threads, stats_multi.descentes, stats_multi.croisements, stats_multi.ameliorations);
+    printf("meilleure tournee : cout %ld, trouvee en %.3f s sur %.3f s\n", cout,
+           stats_multi.meilleure_ns / 1e9, stats_multi.duree_ns / 1e9);
+  }
+  else {
+    debut = horloge_ns();
+    tournee = ((hilbert != 0) && (inst->x != NULL)) ? TourneeHilbert(inst) : TourneePlusProcheVoisin(inst, 0);
+    duree_initiale = horloge_ns() - debut;
+    cout_initial = CoutTournee(inst, tournee);
+    printf("tournee initiale (%s) : cout %ld en %.3f s\n", ((hilbert != 0) && (inst->x != NULL)) ? "hilbert" : "glouton",
+           cout_initial, duree_initiale / 1e9);
+
+    if (duree > 0) descente->echeance_ns = horloge_ns() + duree;
+    cout = AmelioreTournee(inst, tournee, descente, &stats);
+    printf("tournee amelioree : cout %ld (%.2f %% de moins) en %.3f s\n", cout,
+           (cout_initial > 0) ? 100.0 * (cout_initial - cout) / cout_initial : 0.0, stats.duree_ns / 1e9);
+    printf("  %ld examens, %ld chaines, %ld deplacements or-opt, %.0f villes/s\n", stats.examens, stats.chaines,
+           stats.deplacements, (stats.duree_ns > 0) ? inst->n / (stats.duree_ns / 1e9) : 0.0);
+  }
+  if (cout >= AMELIORATION_ABSENTE) printf("  la tournee emprunte des routes absentes (essayer --metrique)\n");
+
+  if (euclidien)
+    printf("rapport a l'estimation BHH (%ld) : %.4f\n", reference, (double)cout / reference);
+  else if (reference > 0)
+    printf("ecart a l'optimum : %.2f %%\n", 100.0 * (cout - reference) / reference);
+
+  free(tournee);
+  TermineInstanceTournee(inst);
+  if (ctx != NULL) TermineContexte(ctx);
+  if (G != NULL) TermineGraphe(G);
+  return 0;
+}
@@ -0,0 +1,125 @@
+/*! \file amelioration.h
+    \brief tournées approchées pour les grandes instances : tournée initiale (plus proche
+           voisin ou courbe de Hilbert) puis recherche locale 2-opt, Or-opt et chaînes de
+           Lin-Kernighan sur listes de voisins
+*/
+#ifndef AMELIORATION_H
+#define AMELIORATION_H
+
+#include "solveur.h"
+
+/*! \def AMELIORATION_VOISINS
+    \brief nombre de voisins candidats par ville (défaut)
+*/
+#define AMELIORATION_VOISINS 10
+
+/*! \def AMELIORATION_PROFONDEUR
+    \brief nombre maximum d'échanges d'une chaîne de Lin-Kernighan (défaut ; 1 : 2-opt seul)
+*/
+#define AMELIORATION_PROFONDEUR 6
+
+/*! \def AMELIORATION_LARGEUR
+    \brief nombre de candidats essayés au premier échange d'une chaîne
+*/
+#define AMELIORATION_LARGEUR 5
+
+/*! \def AMELIORATION_ABSENTE
+    \brief longueur prêtée à une route absente de la table des distances
+*/
+#define AMELIORATION_ABSENTE (1L << 40)
+
+/*! \struct InstanceTournee
+    \brief villes d'une tournée approchée : distances lues dans un contexte, ou euclidiennes
+           arrondies à l'entier le plus proche ; les distances doivent être symétriques
+*/
+typedef struct InstanceTournee {
+//! nombre de villes
+  int n;
+//! contexte dont la table donne les distances (non possédé), NULL pour une instance euclidienne
+  ContexteSolveur *ctx;
+//! coordonnées (possédées), NULL si inconnues ; utilisées pour les distances si ctx est NULL
+  double *x, *y;
+//! nombre de voisins par ville
+  int k;
+//! voisins[a*k+i] : i-ème plus proche voisin de a, -1 au-delà des voisins connus
+  int *voisins;
+} InstanceTournee;
+
+/*! \struct OptionsAmelioration
+    \brief paramètres de la recherche locale
+*/
+typedef struct OptionsAmelioration {
+//! nombre maximum d'échanges d'une chaîne (1 : 2-opt seul)
+  int profondeur;
+//! si non nul, déplacements Or-opt (segments de 1 à 3 villes)
+  int oropt;
+//! instant (horloge_ns) au-delà duquel la recherche s'arrête, 0 : pas d'échéance
+  long long echeance_ns;
+} OptionsAmelioration;
+
+/*! \struct StatsAmelioration
+    \brief compteurs d'une recherche locale
+*/
+typedef struct StatsAmelioration {
+//! villes examinées (sorties de la file des villes actives)
+  long examens;
+//! chaînes de Lin-Kernighan appliquées (2-opt compris)
+  long chaines;
+//! déplacements Or-opt appliqués
+  long deplacements;
+//! durée de la recherche
+  long long duree_ns;
+} StatsAmelioration;
+
+/*! \struct OptionsMultiDepart
+    \brief paramètres des descentes parallèles (MultiDepart)
+*/
+typedef struct OptionsMultiDepart {
+//! nombre de threads, 0 : omp_get_max_threads()
+  int threads;
+//! graine des tirages (le thread i utilise graine + i)
+  unsigned long long graine;
+//! descentes par thread, 0 : jusqu'à l'échéance ou la cible
+  int departs;
+//! une descente sur echange repart d'un segment de la meilleure tournée, 0 : jamais
+  int echange;
+//! longueur qui arrête toutes les descentes dès qu'elle est atteinte, 0 : pas de cible
+  long cible;
+//! instant (horloge_ns) au-delà duquel les descentes s'arrêtent, 0 : pas d'échéance
+  long long echeance_ns;
+//! paramètres de chaque descente (leur échéance est remplacée par echeance_ns)
+  OptionsAmelioration amelioration;
+} OptionsMultiDepart;
+
+/*! \struct StatsMultiDepart
+    \brief compteurs des descentes parallèles
+*/
+typedef struct StatsMultiDepart {
+//! threads utilisés
+  int threads;
+//! descentes terminées (tous threads confondus)
+  long descentes;
+//! descentes parties d'un segment de la meilleure tournée
+  long croisements;
+//! améliorations de la meilleure tournée
+  long ameliorations;
+//! instant (depuis le début) de la dernière amélioration
+  long long meilleure_ns;
+//! durée totale
+  long long duree_ns;
+} StatsMultiDepart;
+
+InstanceTournee* InstanceContexte(ContexteSolveur *ctx, int k);
+InstanceTournee* InstanceEuclidienne(double *x, double *y, int n, int k);
+void TermineInstanceTournee(InstanceTournee *inst);
+long DistanceInstance(InstanceTournee *inst, int a, int b);
+long CoutTournee(InstanceTournee *inst, int *tournee);
+int* TourneePlusProcheVoisin(InstanceTournee *inst, int depart);
+int* TourneeHilbert(InstanceTournee *inst);
+void OptionsAmeliorationParDefaut(OptionsAmelioration *options);
+long AmelioreTournee(InstanceTournee *inst, int *tournee, OptionsAmelioration *options, StatsAmelioration *stats);
+void OptionsMultiDepartParDefaut(OptionsMultiDepart *options);
+long MultiDepart(InstanceTournee *inst, int *meilleure, OptionsMultiDepart *options, StatsMultiDepart *stats);
+int ModeTournee(int argc, char **argv);
+
+#endif /* AMELIORATION_H */
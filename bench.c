@@ -0,0 +1,542 @@
+/*! \file bench.c
+    \brief banc d'essai reproductible des moteurs de résolution du voyageur de commerce
+
+    Usage : AEtoile.exe bench [options]
+      --moteurs a,b        moteurs à mesurer (défaut : tous)
+      --heuristiques 1,2,3 heuristiques à mesurer (défaut : 1,2,3)
+      --tailles 4,5,6      nombres de villes des instances générées (défaut : 4 à 9)
+      --densite d          fraction des arêtes possibles présentes (défaut : 1)
+      --poids-aleatoires   poids tirés au hasard au lieu des distances euclidiennes
+      --graphe fichier     mesure sur un graphe lu dans un fichier au lieu d'instances générées
+      --instances k        nombre d'instances par taille (défaut : 3)
+      --graine s           graine des instances (défaut : 1)
+      --echauffement w     résolutions non mesurées avant les mesures (défaut : 1)
+      --repetitions r      résolutions mesurées par instance (défaut : 5)
+      --csv fichier        résultats en CSV ("-" pour la sortie standard)
+      --json fichier       résultats en JSON ("-" pour la sortie standard)
+      --reference fichier  CSV de référence : signale les ralentissements
+      --seuil p            ralentissement toléré en pourcents (défaut : 10)
+*/
+#include "bench.h"
+#include "faisceau.h"
+#include "compact.h"
+
+#define BENCH_MAX 64
+
+/* ====================================================================== */
+/* ====================================================================== */
+/* MOTEURS */
+/* ====================================================================== */
+/* ====================================================================== */
+
+/*! \struct EtatAStar
+    \brief contexte et espace de travail réutilisés par toutes les résolutions d'une instance
+*/
+typedef struct EtatAStar {
+    ContexteSolveur *ctx;
+    EspaceTravail *ws;
+} EtatAStar;
+
+/* ====================================================================== */
+/*! \fn static void * PrepareAStar(graphe *G, int heuristique)
+    \brief construit le contexte de résolution (distances, arbre de poids minimum)
+*/
+static void * PrepareAStar(graphe *G, int heuristique){
+    EtatAStar *etat = (EtatAStar *)malloc(sizeof(EtatAStar));
+    if(etat == NULL){
+        fprintf(stderr, "PrepareAStar : malloc failed\n");
+        exit(0);
+    }
+    OptionsSolveur options;
+    OptionsParDefaut(&options);
+    options.heuristique = heuristique;
+    etat->ctx = CreeContexte(G, &options);
+    etat->ws = CreeEspaceTravail();
+    return etat;
+}
+
+/* ====================================================================== */
+/*! \fn static void * PrepareAStarParesseux(graphe *G, int heuristique)
+    \brief comme PrepareAStar, avec l'évaluation paresseuse de l'heuristique
+*/
+static void * PrepareAStarParesseux(graphe *G, int heuristique){
+    EtatAStar *etat = (EtatAStar *)PrepareAStar(G, heuristique);
+    etat->ctx->options.paresseuse = 1;
+    return etat;
+}
+
+/* ====================================================================== */
+/*! \fn static long ResoutAStar(void *etat, graphe *G, int heuristique)
+    \brief résolution exacte par AStar
+*/
+static long ResoutAStar(void *etat, graphe *G, int heuristique){
+    EtatAStar *e = (EtatAStar *)etat;
+    pnode res = Resoudre(e->ctx, NULL, e->ws, NULL);
+    if(res == NULL) return -1;
+    long cout = res->estim_g;
+    freeNode(res);
+    return cout;
+}
+
+/* ====================================================================== */
+/*! \fn static long ResoutAStarGenerique(void *etat, graphe *G, int heuristique)
+    \brief résolution exacte par AStar sans spécialisation sur l'heuristique (ResoudreGenerique)
+*/
+static long ResoutAStarGenerique(void *etat, graphe *G, int heuristique){
+    EtatAStar *e = (EtatAStar *)etat;
+    pnode res = ResoudreGenerique(e->ctx, NULL, e->ws, NULL);
+    if(res == NULL) return -1;
+    long cout = res->estim_g;
+    freeNode(res);
+    return cout;
+}
+
+/* ====================================================================== */
+/*! \fn static void LibereAStar(void *etat)
+    \brief libère le contexte et l'espace de travail
+*/
+static void LibereAStar(void *etat){
+    EtatAStar *e = (EtatAStar *)etat;
+    TermineEspaceTravail(e->ws);
+    TermineContexte(e->ctx);
+    free(e);
+}
+
+/*! \struct EtatFaisceau
+    \brief contexte et tampons de la recherche en faisceau réutilisés par toutes les résolutions
+*/
+typedef struct EtatFaisceau {
+    ContexteSolveur *ctx;
+    Faisceau *f;
+} EtatFaisceau;
+
+/* ====================================================================== */
+/*! \fn static void * PrepareFaisceau(graphe *G, int heuristique)
+    \brief construit le contexte et les tampons d'un faisceau de largeur FAISCEAU_LARGEUR
+*/
+static void * PrepareFaisceau(graphe *G, int heuristique){
+    EtatFaisceau *etat = (EtatFaisceau *)malloc(sizeof(EtatFaisceau));
+    if(etat == NULL){
+        fprintf(stderr, "PrepareFaisceau : malloc failed\n");
+        exit(0);
+    }
+    OptionsSolveur options;
+    OptionsParDefaut(&options);
+    options.heuristique = heuristique;
+    etat->ctx = CreeContexte(G, &options);
+    etat->f = CreeFaisceau(FAISCEAU_LARGEUR, etat->ctx->nsom);
+    return etat;
+}
+
+/* ====================================================================== */
+/*! \fn static long ResoutFaisceau(void *etat, graphe *G, int heuristique)
+    \brief résolution approchée par recherche en faisceau
+*/
+static long ResoutFaisceau(void *etat, graphe *G, int heuristique){
+    EtatFaisceau *e = (EtatFaisceau *)etat;
+    pnode res = ResoudreFaisceau(e->f, e->ctx, NULL, NULL);
+    if(res == NULL) return -1;
+    long cout = res->estim_g;
+    freeNode(res);
+    return cout;
+}
+
+/* ====================================================================== */
+/*! \fn static void LibereFaisceau(void *etat)
+    \brief libère le contexte et les tampons
+*/
+static void LibereFaisceau(void *etat){
+    EtatFaisceau *e = (EtatFaisceau *)etat;
+    TermineFaisceau(e->f);
+    TermineContexte(e->ctx);
+    free(e);
+}
+
+/*! \struct EtatCompact
+    \brief contexte, espace de travail et tampons de l'A* compact réutilisés par toutes les résolutions
+*/
+typedef struct EtatCompact {
+    ContexteSolveur *ctx;
+    EspaceTravail *ws;
+    RechercheCompacte *rc;
+} EtatCompact;
+
+/* ====================================================================== */
+/*! \fn static void * PrepareCompact(graphe *G, int heuristique)
+    \brief construit le contexte de résolution et les tampons de l'A* compact
+*/
+static void * PrepareCompact(graphe *G, int heuristique){
+    EtatCompact *etat = (EtatCompact *)malloc(sizeof(EtatCompact));
+    if(etat == NULL){
+        fprintf(stderr, "PrepareCompact : malloc failed\n");
+        exit(0);
+    }
+    OptionsSolveur options;
+    OptionsParDefaut(&options);
+    options.heuristique = heuristique;
+    etat->ctx = CreeContexte(G, &options);
+    etat->ws = CreeEspaceTravail();
+    etat->rc = CreeRechercheCompacte();
+    return etat;
+}
+
+/* ====================================================================== */
+/*! \fn static void * PrepareCompactParesseux(graphe *G, int heuristique)
+    \brief comme PrepareCompact, avec l'évaluation paresseuse de l'heuristique
+*/
+static void * PrepareCompactParesseux(graphe *G, int heuristique){
+    EtatCompact *etat = (EtatCompact *)PrepareCompact(G, heuristique);
+    etat->ctx->options.paresseuse = 1;
+    return etat;
+}
+
+/* ====================================================================== */
+/*! \fn static long ResoutCompact(void *etat, graphe *G, int heuristique)
+    \brief résolution exacte par A* sur noeuds compacts
+*/
+static long ResoutCompact(void *etat, graphe *G, int heuristique){
+    EtatCompact *e = (EtatCompact *)etat;
+    pnode res = ResoudreCompact(e->ctx, NULL, e->ws, e->rc, NULL);
+    if(res == NULL) return -1;
+    long cout = res->estim_g;
+    freeNode(res);
+    return cout;
+}
+
+/* ====================================================================== */
+/*! \fn static void LibereCompact(void *etat)
+    \brief libère le contexte, l'espace de travail et les tampons
+*/
+static void LibereCompact(void *etat){
+    EtatCompact *e = (EtatCompact *)etat;
+    TermineRechercheCompacte(e->rc);
+    TermineEspaceTravail(e->ws);
+    TermineContexte(e->ctx);
+    free(e);
+}
+
+//! moteurs connus du banc d'essai
+static MoteurBench moteurs[] = {
+    { "astar", PrepareAStar, ResoutAStar, LibereAStar },
+    { "astar-generique", PrepareAStar, ResoutAStarGenerique, LibereAStar },
+    { "astar-paresseux", PrepareAStarParesseux, ResoutAStar, LibereAStar },
+    { "faisceau", PrepareFaisceau, ResoutFaisceau, LibereFaisceau },
+    { "compact", PrepareCompact, ResoutCompact, LibereCompact },
+    { "compact-paresseux", PrepareCompactParesseux, ResoutCompact, LibereCompact },
+};
+static const int nb_moteurs = sizeof(moteurs) / sizeof(moteurs[0]);
+
+/* ====================================================================== */
+/* ====================================================================== */
+/* STATISTIQUES */
+/* ====================================================================== */
+/* ====================================================================== */
+
+static int compareDouble(const void *a, const void *b){
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/* ====================================================================== */
+/*! \fn void StatistiquesBench(double *t, int n, MesureBench *m)
+    \param t : n mesures en microsecondes (le tableau est trié)
+    \param n : nombre de mesures
+    \param m : résultat (champs statistiques remplis)
+    \brief médiane, 95e centile (rang le plus proche), moyenne, écart type et minimum
+*/
+void StatistiquesBench(double *t, int n, MesureBench *m){
+    double somme = 0.0, somme2 = 0.0;
+    int i, r;
+
+    m->echantillons = n;
+    if(n == 0){
+        m->mediane = m->p95 = m->moyenne = m->ecart_type = m->minimum = 0.0;
+        return;
+    }
+    qsort(t, n, sizeof(double), compareDouble);
+    for(i = 0; i < n; i++) somme += t[i];
+    m->moyenne = somme / n;
+    for(i = 0; i < n; i++) somme2 += (t[i] - m->moyenne) * (t[i] - m->moyenne);
+    m->ecart_type = (n > 1) ? sqrt(somme2 / (n - 1)) : 0.0;
+    m->mediane = (n % 2) ? t[n/2] : (t[n/2 - 1] + t[n/2]) / 2;
+    r = (int)ceil(0.95 * n) - 1;
+    m->p95 = t[(r < 0) ? 0 : r];
+    m->minimum = t[0];
+}
+
+/* ====================================================================== */
+/* ====================================================================== */
+/* SORTIES */
+/* ====================================================================== */
+/* ====================================================================== */
+
+static FILE * ouvreSortie(const char *nom){
+    if(strcmp(nom, "-") == 0) return stdout;
+    FILE *f = fopen(nom, "w");
+    if(f == NULL){
+        fprintf(stderr, "bench : impossible d'ouvrir %s\n", nom);
+        exit(-1);
+    }
+    return f;
+}
+
+static void fermeSortie(FILE *f){
+    if(f != stdout) fclose(f);
+}
+
+static void EcritCSV(FILE *f, MesureBench *m, int n){
+    fprintf(f, "moteur,heuristique,nsom,narc,echantillons,mediane_us,p95_us,moyenne_us,ecart_type_us,min_us,cout\n");
+    for(int i = 0; i < n; i++)
+        fprintf(f, "%s,%d,%d,%d,%d,%.3f,%.3f,%.3f,%.3f,%.3f,%ld\n",
+                m[i].moteur, m[i].heuristique, m[i].nsom, m[i].narc, m[i].echantillons,
+                m[i].mediane, m[i].p95, m[i].moyenne, m[i].ecart_type, m[i].minimum, m[i].cout);
+}
+
+static void EcritJSON(FILE *f, MesureBench *m, int n){
+    fprintf(f, "[\n");
+    for(int i = 0; i < n; i++)
+        fprintf(f, "  {\"moteur\": \"%s\", \"heuristique\": %d, \"nsom\": %d, \"narc\": %d, "
+                   "\"echantillons\": %d, \"mediane_us\": %.3f, \"p95_us\": %.3f, \"moyenne_us\": %.3f, "
+                   "\"ecart_type_us\": %.3f, \"min_us\": %.3f, \"cout\": %ld}%s\n",
+                m[i].moteur, m[i].heuristique, m[i].nsom, m[i].narc, m[i].echantillons,
+                m[i].mediane, m[i].p95, m[i].moyenne, m[i].ecart_type, m[i].minimum, m[i].cout,
+                (i < n-1) ? "," : "");
+    fprintf(f, "]\n");
+}
+
+/* ====================================================================== */
+/*! \fn static void AfficheMatrice(MesureBench *m, int n)
+    \brief affiche les médianes sous forme de matrice : une ligne par (moteur, heuristique),
+           une colonne par taille d'instance
+*/
+static void AfficheMatrice(MesureBench *m, int n){
+    int i, j, k;
+    for(i = 0; i < n; i++){
+        /* nouvelle ligne de la matrice ? */
+        for(j = 0; j < i; j++)
+            if(!strcmp(m[j].moteur, m[i].moteur) && (m[j].heuristique == m[i].heuristique)) break;
+        if(j < i) continue;
+        printf("%-10s H%d |", m[i].moteur, m[i].heuristique);
+        for(k = i; k < n; k++)
+            if(!strcmp(m[k].moteur, m[i].moteur) && (m[k].heuristique == m[i].heuristique))
+                printf(" n=%d: %10.1f us (p95 %10.1f) |", m[k].nsom, m[k].mediane, m[k].p95);
+        printf("\n");
+    }
+}
+
+/* ====================================================================== */
+/*! \fn static int CompareReference(const char *nom, MesureBench *m, int n, double seuil)
+    \param nom : fichier CSV produit par une exécution précédente du banc d'essai
+    \param m : mesures courantes
+    \param n : nombre de mesures
+    \param seuil : ralentissement toléré, en pourcents de la médiane de référence
+    \return le nombre de régressions (ralentissements au-delà du seuil ou coûts différents)
+*/
+static int CompareReference(const char *nom, MesureBench *m, int n, double seuil){
+    FILE *f = fopen(nom, "r");
+    char ligne[512];
+    int regressions = 0;
+
+    if(f == NULL){
+        fprintf(stderr, "bench : référence %s introuvable\n", nom);
+        exit(-1);
+    }
+    printf("\nComparaison avec %s (seuil %.1f %%)\n", nom, seuil);
+    while(fgets(ligne, sizeof(ligne), f) != NULL){
+        MesureBench r;
+        if(sscanf(ligne, "%31[^,],%d,%d,%d,%d,%lf,%lf,%lf,%lf,%lf,%ld",
+                  r.moteur, &r.heuristique, &r.nsom, &r.narc, &r.echantillons,
+                  &r.mediane, &r.p95, &r.moyenne, &r.ecart_type, &r.minimum, &r.cout) != 11)
+            continue; /* entête ou ligne invalide */
+        for(int i = 0; i < n; i++){
+            if(strcmp(m[i].moteur, r.moteur) || (m[i].heuristique != r.heuristique)
+               || (m[i].nsom != r.nsom) || (m[i].narc != r.narc)) continue;
+            double ecart = (r.mediane > 0) ? 100.0 * (m[i].mediane - r.mediane) / r.mediane : 0.0;
+            const char *verdict = "ok";
+            if(ecart > seuil){ verdict = "REGRESSION"; regressions++; }
+            else if(ecart < -seuil) verdict = "amelioration";
+            if(m[i].cout != r.cout){ verdict = "COUT DIFFERENT"; regressions++; }
+            printf("%-10s H%d n=%-4d m=%-6d %10.1f -> %10.1f us (%+6.1f %%) %s\n",
+                   r.moteur, r.heuristique, r.nsom, r.narc, r.mediane, m[i].mediane, ecart, verdict);
+        }
+    }
+    fclose(f);
+    printf("%d regression(s)\n", regressions);
+    return regressions;
+}
+
+/* ====================================================================== */
+/* ====================================================================== */
+/* MESURES */
+/* ====================================================================== */
+/* ====================================================================== */
+
+static int ListeEntiers(const char *s, int *t, int max){
+    int n = 0;
+    while(*s && n < max){
+        t[n++] = atoi(s);
+        while(*s && *s != ',') s++;
+        if(*s == ',') s++;
+    }
+    return n;
+}
+
+/* ====================================================================== */
+/*! \fn static int ListeContientNom(const char *s, const char *nom)
+    \brief vrai si nom est l'un des éléments de la liste s séparés par des virgules
+           (comparaison exacte : "astar" ne choisit pas "astar-generique")
+*/
+static int ListeContientNom(const char *s, const char *nom){
+    size_t l = strlen(nom);
+    while(*s){
+        const char *fin = strchr(s, ',');
+        size_t n = (fin != NULL) ? (size_t)(fin - s) : strlen(s);
+        if((n == l) && !strncmp(s, nom, l)) return 1;
+        if(fin == NULL) break;
+        s = fin + 1;
+    }
+    return 0;
+}
+
+/* ====================================================================== */
+/*! \fn static void MesureConfiguration(...)
+    \brief mesure un moteur et une heuristique sur toutes les instances d'une taille.
+           Chaque instance est préparée hors chronométrage, résolue echauffement fois
+           sans mesure puis repetitions fois avec mesure sur l'horloge monotone.
+*/
+static void MesureConfiguration(MoteurBench *mt, int heuristique, graphe **instances, int nb_instances,
+                                int echauffement, int repetitions, MesureBench *m){
+    double *t = (double *)malloc(nb_instances * repetitions * sizeof(double));
+    int n = 0;
+
+    strncpy(m->moteur, mt->nom, sizeof(m->moteur) - 1);
+    m->moteur[sizeof(m->moteur) - 1] = 0;
+    m->heuristique = heuristique;
+    m->nsom = instances[0]->nsom;
+    m->narc = instances[0]->narc;
+    m->cout = 0;
+
+    for(int k = 0; k < nb_instances; k++){
+        graphe *G = instances[k];
+        void *etat = mt->prepare(G, heuristique);
+        long cout = 0;
+        for(int w = 0; w < echauffement; w++) cout = mt->resout(etat, G, heuristique);
+        for(int r = 0; r < repetitions; r++){
+            long long debut = horloge_ns();
+            cout = mt->resout(etat, G, heuristique);
+            t[n++] = (horloge_ns() - debut) / 1000.0;
+        }
+        m->cout += cout;
+        mt->libere(etat);
+    }
+    StatistiquesBench(t, n, m);
+    free(t);
+}
+
+/* ====================================================================== */
+/*! \fn int ModeBench(int argc, char **argv)
+    \param argc : nombre d'options
+    \param argv : options (voir l'entête du fichier)
+    \return 0, ou 1 si des régressions ont été détectées par rapport à la référence
+*/
+int ModeBench(int argc, char **argv){
+    int heuristiques[BENCH_MAX] = {1, 2, 3}, nb_heuristiques = 3;
+    int tailles[BENCH_MAX] = {4, 5, 6, 7, 8, 9}, nb_tailles = 6;
+    const char *noms_moteurs = NULL;
+    const char *fichier_graphe = NULL, *fichier_csv = NULL, *fichier_json = NULL, *reference = NULL;
+    double densite = 1.0, seuil = 10.0;
+    int euclidien = 1, nb_instances = 3, echauffement = 1, repetitions = 5;
+    unsigned long long graine = 1;
+    int i;
+
+    for(i = 0; i < argc; i++){
+        const char *o = argv[i];
+        const char *v = (i+1 < argc) ? argv[i+1] : NULL;
+        if(!strcmp(o, "--poids-aleatoires")){ euclidien = 0; continue; }
+        if(v == NULL){
+            fprintf(stderr, "bench : option inconnue ou sans valeur : %s\n", o);
+            return -1;
+        }
+        if(!strcmp(o, "--moteurs")) noms_moteurs = v;
+        else if(!strcmp(o, "--heuristiques")){
+            nb_heuristiques = ListeEntiers(v, heuristiques, BENCH_MAX);
+            for(int h = 0; h < nb_heuristiques; h++)
+                if((heuristiques[h] < 1) || (heuristiques[h] > 3)){
+                    fprintf(stderr, "bench : heuristique inconnue : %d (1, 2 ou 3)\n", heuristiques[h]);
+                    return -1;
+                }
+        }
+        else if(!strcmp(o, "--tailles")) nb_tailles = ListeEntiers(v, tailles, BENCH_MAX);
+        else if(!strcmp(o, "--densite")) densite = atof(v);
+        else if(!strcmp(o, "--graphe")) fichier_graphe = v;
+        else if(!strcmp(o, "--instances")) nb_instances = atoi(v);
+        else if(!strcmp(o, "--graine")) graine = strtoull(v, NULL, 10);
+        else if(!strcmp(o, "--echauffement")) echauffement = atoi(v);
+        else if(!strcmp(o, "--repetitions")) repetitions = atoi(v);
+        else if(!strcmp(o, "--csv")) fichier_csv = v;
+        else if(!strcmp(o, "--json")) fichier_json = v;
+        else if(!strcmp(o, "--reference")) reference = v;
+        else if(!strcmp(o, "--seuil")) seuil = atof(v);
+        else{
+            fprintf(stderr, "bench : option inconnue : %s\n", o);
+            return -1;
+        }
+        i++;
+    }
+    if(fichier_graphe != NULL){ nb_tailles = 1; nb_instances = 1; }
+    if((nb_instances < 1) || (repetitions < 1)){
+        fprintf(stderr, "bench : il faut au moins une instance et une repetition\n");
+        return -1;
+    }
+
+    srand((unsigned int)graine); /* pivots de SelectionRapideStochastique (moteur faisceau) */
+    MesureBench *mesures = (MesureBench *)malloc(nb_moteurs * nb_heuristiques * nb_tailles * sizeof(MesureBench));
+    int nb_mesures = 0;
+    graphe **instances = (graphe **)malloc(nb_instances * sizeof(graphe *));
+
+    for(int s = 0; s < nb_tailles; s++){
+        /* instances de cette taille, identiques d'une exécution à l'autre */
+        if(fichier_graphe != NULL){
+            instances[0] = ReadGraphe((char *)fichier_graphe);
+            if(instances[0] == NULL) return -1;
+        }else{
+            int n = tailles[s];
+            double mmax = ((double)n * (n - 1)) / 2;
+            int narc = (int)(densite * mmax + 0.5);
+            if(narc < n - 1) narc = n - 1;
+            if(narc > mmax) narc = (int)mmax;
+            for(int k = 0; k < nb_instances; k++)
+                instances[k] = GrapheAleatoireConnexe(n, narc, graine + 1000003ULL * n + k, euclidien);
+        }
+
+        for(int e = 0; e < nb_moteurs; e++){
+            if((noms_moteurs != NULL) && !ListeContientNom(noms_moteurs, moteurs[e].nom)) continue;
+            for(int h = 0; h < nb_heuristiques; h++){
+                MesureBench *m = &mesures[nb_mesures++];
+                MesureConfiguration(&moteurs[e], heuristiques[h], instances, nb_instances,
+                                    echauffement, repetitions, m);
+                fprintf(stderr, "%s H%d n=%d m=%d : mediane %.1f us\n",
+                        m->moteur, m->heuristique, m->nsom, m->narc, m->mediane);
+            }
+        }
+        for(int k = 0; k < nb_instances; k++) TermineGraphe(instances[k]);
+    }
+
+    AfficheMatrice(mesures, nb_mesures);
+    if(fichier_csv != NULL){
+        FILE *f = ouvreSortie(fichier_csv);
+        EcritCSV(f, mesures, nb_mesures);
+        fermeSortie(f);
+    }
+    if(fichier_json != NULL){
+        FILE *f = ouvreSortie(fichier_json);
+        EcritJSON(f, mesures, nb_mesures);
+        fermeSortie(f);
+    }
+    int regressions = 0;
+    if(reference != NULL) regressions = CompareReference(reference, mesures, nb_mesures, seuil);
+
+    free(instances);
+    free(mesures);
+    return (regressions > 0) ? 1 : 0;
+}
@@ -0,0 +1,48 @@
+/*! \file bench.h
+    \brief banc d'essai reproductible des moteurs de résolution du voyageur de commerce
+*/
+#ifndef BENCH_H
+#define BENCH_H
+
+#include "vdc.h"
+
+/*! \struct MoteurBench
+    \brief un moteur de résolution mesuré par le banc d'essai.
+           Seul l'appel à resout est chronométré ; prepare et libere encadrent
+           les précalculs propres à une instance et à une heuristique.
+*/
+typedef struct MoteurBench {
+//! nom du moteur (colonne "moteur" des résultats)
+  const char *nom;
+//! précalculs pour une instance (peut retourner NULL)
+  void * (*prepare)(graphe *G, int heuristique);
+//! résolution chronométrée : retourne le coût de la tournée, ou -1 si pas de solution
+  long (*resout)(void *etat, graphe *G, int heuristique);
+//! libère ce qu'a alloué prepare
+  void (*libere)(void *etat);
+} MoteurBench;
+
+/*! \struct MesureBench
+    \brief résultat agrégé pour un couple (moteur, heuristique) et une taille d'instance.
+           Les temps sont en microsecondes.
+*/
+typedef struct MesureBench {
+  char moteur[32];
+  int heuristique;
+  int nsom;
+  int narc;
+//! nombre de mesures (instances x répétitions)
+  int echantillons;
+  double mediane;
+  double p95;
+  double moyenne;
+  double ecart_type;
+  double minimum;
+//! somme des coûts des tournées trouvées (contrôle de non-régression du résultat)
+  long cout;
+} MesureBench;
+
+void StatistiquesBench(double *t, int n, MesureBench *m);
+int ModeBench(int argc, char **argv);
+
+#endif /* BENCH_H */
@@ -0,0 +1,865 @@
+/*! \file chemins.c
+    \brief plus courts chemins sur la carte routière : Dijkstra depuis une source, A* point à point
+           et recherche bidirectionnelle
+
+    Les deux recherches partagent un tas 4-aire avec diminution de clé (moins de niveaux
+    qu'un tas binaire, les quatre fils d'un nœud sont contigus en mémoire) et des tampons
+    marqués par génération, si bien qu'une requête ne coûte que les sommets qu'elle atteint.
+
+    L'estimation de A* est l'écart entre les coordonnées des sommets (champs x et y du
+    graphe, section "coord sommets"), euclidien ou du grand cercle, multiplié par le plus
+    grand facteur qui la laisse sous le poids de chaque arc : elle est alors minorante et
+    monotone quelles que soient les unités des poids. Si le réseau a des repères
+    (reperes.c), l'estimation est le plus grand de cet écart et du minorant ALT. Sans
+    coordonnées ni repères, l'estimation est nulle et A* se comporte comme Dijkstra.
+
+    La recherche bidirectionnelle avance depuis la source sur les successeurs et depuis
+    la cible sur les prédécesseurs (graphe Symetrique), guidée en A* par les potentiels
+    moyens (Potentiel), et s'arrête quand la somme des plus petites clés des deux tas
+    dépasse le meilleur chemin trouvé. Les deux côtés peuvent avancer sur deux threads.
+
+    Usage : AEtoile.exe chemin graphe source cible [options]
+            AEtoile.exe chemin graphe [options]
+            AEtoile.exe chemin --aleatoire n [options]
+      --dijkstra           recherche sans estimation (défaut : A*)
+      --bidirectionnel     recherche depuis la source et depuis la cible
+      --parallele          recherche bidirectionnelle, un thread par côté
+      --oriente            les arcs ne sont parcourus que dans leur sens (défaut : routes à double sens)
+      --geographique       les coordonnées sont des degrés (longitude, latitude)
+      --arcs m             nombre d'arêtes du graphe aléatoire (défaut : 3n)
+      --requetes q         nombre de couples (source, cible) tirés au hasard (défaut : 100)
+      --graine s           graine du graphe et des tirages (défaut : 1)
+      --routier n          comme --aleatoire, sur une carte synthétique (GrapheRoutierAleatoire)
+      --hierarchie f       requêtes par hiérarchie de contraction (voir hierarchie.c), relue
+                           dans le fichier f s'il existe, construite et écrite dans f sinon
+      --temoins k          limite des recherches de témoins de la construction
+      --reperes f          A* guidé aussi par des repères (voir reperes.c), relus dans le
+                           fichier f s'il existe, choisis et écrits dans f sinon
+      --nreperes k         nombre de repères (défaut : REPERES_DEFAUT)
+      --choix c            choix des repères : aleatoires, eloignes ou evitement (défaut)
+      --table k            table des distances entre k sommets tirés au hasard (voir table.c),
+                           par Dijkstra et, avec --hierarchie, par seaux
+      --tournee            avec --table, résout aussi le voyageur de commerce sur ces sommets
+    Sans source ni cible, des requêtes tirées au hasard comparent Dijkstra et A*, uni- et
+    bidirectionnels (temps moyen, sommets stabilisés) ; le mode --aleatoire les pose sur
+    un graphe euclidien connexe (GrapheAleatoireConnexe).
+*/
+#include "hierarchie.h"
+#include "reperes.h"
+#include "table.h"
+#include "graphaux.h"
+#include <math.h>
+#include <pthread.h>
+
+/*! \def RAYON_TERRE
+    \brief rayon moyen de la Terre en kilomètres
+*/
+#define RAYON_TERRE 6371.0
+
+/* ====================================================================== */
+/* ====================================================================== */
+/* RESEAU */
+/* ====================================================================== */
+/* ====================================================================== */
+
+/* ====================================================================== */
+/*! \fn static double Ecart(ReseauRoutier *r, int x, int y)
+    \return l'écart entre les coordonnées de x et de y (distance euclidienne, ou du grand cercle en km)
+*/
+static double Ecart(ReseauRoutier *r, int x, int y){
+  double dx = r->cx[x] - r->cx[y], dy = r->cy[x] - r->cy[y];
+  if (r->geographique){ /* formule de haversine */
+    double sx = sin(dx / 2), sy = sin(dy / 2);
+    double a = sy * sy + cos(r->cy[x]) * cos(r->cy[y]) * sx * sx;
+    return 2 * RAYON_TERRE * asin(sqrt(min(a, 1.0)));
+  }
+  return sqrt(dx * dx + dy * dy);
+}
+
+/* ====================================================================== */
+/*! \fn ReseauRoutier* CreeReseau(graphe *G, int symetrique, int geographique)
+    \param G : un graphe (poids positifs ou nuls)
+    \param symetrique : si non nul, chaque arc est aussi parcouru dans l'autre sens
+    \param geographique : si non nul, G->x et G->y sont des longitudes et latitudes en degrés
+    \return le réseau (G peut être libéré ensuite)
+    \brief construit les successeurs CSR et calibre l'estimation de A*
+*/
+ReseauRoutier* CreeReseau(graphe *G, int symetrique, int geographique){
+  ReseauRoutier *r;
+  int n = G->nsom, x, i;
+  double f = -1;
+
+  r = (ReseauRoutier *)calloc(1, sizeof(ReseauRoutier));
+  if (r == NULL)
+  {   fprintf(stderr, "CreeReseau : calloc failed\n");
+      exit(0);
+  }
+  r->g = CreeCSR(G, symetrique);
+  if (symetrique) r->inverse = r->g;
+  else {
+    graphe *S = Symetrique(G);
+    r->inverse = CreeCSR(S, 0);
+    TermineGraphe(S);
+  }
+  r->geographique = geographique;
+  r->cx = (double *)malloc(((n > 0) ? n : 1) * sizeof(double));
+  r->cy = (double *)malloc(((n > 0) ? n : 1) * sizeof(double));
+  if ((r->cx == NULL) || (r->cy == NULL))
+  {   fprintf(stderr, "CreeReseau : malloc failed\n");
+      exit(0);
+  }
+  for (x = 0; x < n; x++){
+    r->cx[x] = geographique ? G->x[x] * M_PI / 180 : G->x[x];
+    r->cy[x] = geographique ? G->y[x] * M_PI / 180 : G->y[x];
+  }
+
+  /* facteur = min poids / écart sur les arcs d'écart non nul */
+  for (x = 0; x < n; x++)
+    for (i = r->g->debut[x]; i < r->g->debut[x + 1]; i++){
+      double e = Ecart(r, x, r->g->voisin[i]);
+      if ((e > 0) && ((f < 0) || (r->g->poids[i] < f * e))) f = r->g->poids[i] / e;
+    }
+  r->facteur = (f > 0) ? f * (1 - 1e-9) : 0; /* marge pour les arrondis */
+  return r;
+}
+
+/* ====================================================================== */
+/*! \fn void TermineReseau(ReseauRoutier *r)
+    \param r : un réseau
+*/
+void TermineReseau(ReseauRoutier *r){
+  if (r->inverse != r->g) TermineCSR(r->inverse);
+  TermineCSR(r->g);
+  free(r->cx);
+  free(r->cy);
+  free(r);
+}
+
+/* ====================================================================== */
+/*! \fn long EstimationDistance(ReseauRoutier *r, int x, int t)
+    \param r : un réseau
+    \param x : un sommet
+    \param t : la cible
+    \return un minorant de la distance de x à t ; la partie entière conserve la monotonie
+            (h(x) - h(y) <= poids(x,y) pour tout arc) puisque les poids sont entiers, et le
+            maximum de deux estimations monotones (écart et repères) l'est aussi
+*/
+long EstimationDistance(ReseauRoutier *r, int x, int t){
+  long e = 0;
+  if (r->facteur > 0) e = (long)floor(r->facteur * Ecart(r, x, t));
+  if (r->reperes != NULL) e = max(e, BorneReperes(r->reperes, x, t));
+  return e;
+}
+
+/* ====================================================================== */
+/* ====================================================================== */
+/* TAS 4-AIRE */
+/* ====================================================================== */
+/* ====================================================================== */
+
+/* ====================================================================== */
+/*! \fn void MonteTasQuaternaire(TasQuaternaire *t, int i, long cle, int som)
+    \param t : un tas
+    \param i : t->n++ pour une insertion, t->position[som] pour une diminution de clé
+    \param cle : nouvelle clé
+    \param som : le sommet
+    \brief place (cle, som) à la position i puis le fait remonter
+*/
+void MonteTasQuaternaire(TasQuaternaire *t, int i, long cle, int som){
+  int j;
+  for (; i > 0; i = j){
+    j = (i - 1) / 4;
+    if (t->cle[j] <= cle) break;
+    t->cle[i] = t->cle[j];
+    t->som[i] = t->som[j];
+    t->position[t->som[i]] = i;
+  }
+  t->cle[i] = cle;
+  t->som[i] = som;
+  t->position[som] = i;
+}
+
+/* ====================================================================== */
+/*! \fn int ExtraitTasQuaternaire(TasQuaternaire *t)
+    \brief retire l'entrée de plus petite clé et retourne son sommet (sa position devient -1)
+*/
+int ExtraitTasQuaternaire(TasQuaternaire *t){
+  int som = t->som[0], i, j, k, fin;
+  long c;
+  int s;
+
+  t->position[som] = -1;
+  if (--t->n == 0) return som;
+  c = t->cle[t->n];
+  s = t->som[t->n];
+  for (i = 0; (j = 4 * i + 1) < t->n; i = k){
+    fin = min(j + 4, t->n);
+    for (k = j++; j < fin; j++) /* plus petit des quatre fils */
+      if (t->cle[j] < t->cle[k]) k = j;
+    if (c <= t->cle[k]) break;
+    t->cle[i] = t->cle[k];
+    t->som[i] = t->som[k];
+    t->position[t->som[i]] = i;
+  }
+  t->cle[i] = c;
+  t->som[i] = s;
+  t->position[s] = i;
+  return som;
+}
+
+/* ====================================================================== */
+/* ====================================================================== */
+/* RECHERCHES */
+/* ====================================================================== */
+/* ====================================================================== */
+
+/* ====================================================================== */
+/*! \fn void InitRechercheChemin(RechercheChemin *rc, int nsom)
+    \param rc : tampons à initialiser
+    \param nsom : nombre de sommets du réseau
+*/
+void InitRechercheChemin(RechercheChemin *rc, int nsom){
+  long n = (nsom > 0) ? nsom : 1;
+  rc->nsom = nsom;
+  rc->generation = 0;
+  rc->stabilises = 0;
+  rc->marque = (unsigned int *)calloc(n, sizeof(unsigned int));
+  rc->dist = (long *)malloc(n * sizeof(long));
+  rc->pred = (int *)malloc(n * sizeof(int));
+  rc->atteints = (int *)malloc(n * sizeof(int));
+  rc->natteints = 0;
+  rc->tas.n = 0;
+  rc->tas.cle = (long *)malloc(n * sizeof(long));
+  rc->tas.som = (int *)malloc(n * sizeof(int));
+  rc->tas.position = (int *)malloc(n * sizeof(int));
+  if ((rc->marque == NULL) || (rc->dist == NULL) || (rc->pred == NULL) || (rc->atteints == NULL) ||
+      (rc->tas.cle == NULL) || (rc->tas.som == NULL) || (rc->tas.position == NULL))
+  {   fprintf(stderr, "InitRechercheChemin : malloc failed\n");
+      exit(0);
+  }
+}
+
+/* ====================================================================== */
+/*! \fn void TermineRechercheChemin(RechercheChemin *rc)
+    \param rc : tampons d'une recherche
+*/
+void TermineRechercheChemin(RechercheChemin *rc){
+  free(rc->marque);
+  free(rc->dist);
+  free(rc->pred);
+  free(rc->atteints);
+  free(rc->tas.cle);
+  free(rc->tas.som);
+  free(rc->tas.position);
+  memset(rc, 0, sizeof(RechercheChemin));
+}
+
+/* ====================================================================== */
+/*! \fn void NouvelleRechercheChemin(RechercheChemin *rc, int s, long cle)
+    \brief oublie la recherche précédente en temps constant et place la source s dans le tas avec la clé cle
+*/
+void NouvelleRechercheChemin(RechercheChemin *rc, int s, long cle){
+  if (++rc->generation == 0){
+    memset(rc->marque, 0, rc->nsom * sizeof(unsigned int));
+    rc->generation = 1;
+  }
+  rc->stabilises = 0;
+  rc->natteints = 1;
+  rc->atteints[0] = s;
+  rc->tas.n = 1;
+  rc->marque[s] = rc->generation;
+  rc->dist[s] = 0;
+  rc->pred[s] = -1;
+  MonteTasQuaternaire(&(rc->tas), 0, cle, s);
+}
+
+/* ====================================================================== */
+/*! \fn static int Recherche(ReseauRoutier *r, RechercheChemin *rc, int s, int t, int astar)
+    \return t s'il est atteint, -1 sinon
+    \brief Dijkstra (astar nul) ou A* depuis s, arrêté à l'extraction de t (t = -1 : jamais).
+           L'estimation étant monotone, un sommet extrait n'est jamais rouvert.
+*/
+static int Recherche(ReseauRoutier *r, RechercheChemin *rc, int s, int t, int astar){
+  GrapheCSR *g = r->g;
+  TasQuaternaire *tas = &(rc->tas);
+  unsigned int gen;
+  int x, y, i;
+  long d, nd;
+
+  astar = astar && (t >= 0) && !EstimationNulle(r);
+  NouvelleRechercheChemin(rc, s, astar ? EstimationDistance(r, s, t) : 0);
+  gen = rc->generation;
+  while (tas->n > 0){
+    x = ExtraitTasQuaternaire(tas);
+    rc->stabilises++;
+    if (x == t) return t;
+    d = rc->dist[x];
+    for (i = g->debut[x]; i < g->debut[x + 1]; i++){
+      y = g->voisin[i];
+      nd = d + g->poids[i];
+      if (rc->marque[y] != gen){ /* premier passage */
+        rc->marque[y] = gen;
+        rc->dist[y] = nd;
+        rc->pred[y] = x;
+        rc->atteints[rc->natteints++] = y;
+        MonteTasQuaternaire(tas, tas->n++, astar ? nd + EstimationDistance(r, y, t) : nd, y);
+      }
+      else if ((nd < rc->dist[y]) && (tas->position[y] >= 0)){ /* diminution de clé */
+        rc->pred[y] = x;
+        MonteTasQuaternaire(tas, tas->position[y], tas->cle[tas->position[y]] - (rc->dist[y] - nd), y);
+        rc->dist[y] = nd;
+      }
+    }
+  }
+  return -1;
+}
+
+/* ====================================================================== */
+/*! \fn void DijkstraToutes(ReseauRoutier *r, RechercheChemin *rc, int s)
+    \param r : un réseau
+    \param rc : tampons de la recherche
+    \param s : sommet source
+    \brief distances de s à tous les sommets, lues ensuite par DistanceAtteinte
+*/
+void DijkstraToutes(ReseauRoutier *r, RechercheChemin *rc, int s){
+  Recherche(r, rc, s, -1, 0);
+}
+
+/* ====================================================================== */
+/*! \fn long PlusCourtChemin(ReseauRoutier *r, RechercheChemin *rc, int s, int t, int astar)
+    \param r : un réseau
+    \param rc : tampons de la recherche
+    \param s : sommet source
+    \param t : sommet cible
+    \param astar : si non nul, A* guidé par EstimationDistance, sinon Dijkstra
+    \return la longueur d'un plus court chemin de s à t, -1 s'il n'y en a pas
+*/
+long PlusCourtChemin(ReseauRoutier *r, RechercheChemin *rc, int s, int t, int astar){
+  if (Recherche(r, rc, s, t, astar) < 0) return -1;
+  return rc->dist[t];
+}
+
+/* ====================================================================== */
+/*! \fn int* CheminTrouve(RechercheChemin *rc, int s, int t, int *longueur)
+    \param rc : tampons de la dernière recherche depuis s
+    \param s : sommet source
+    \param t : sommet atteint
+    \param longueur : (sortie) nombre de sommets du chemin
+    \return les sommets du chemin de s à t (à libérer par l'appelant), NULL si t n'a pas été atteint
+*/
+int* CheminTrouve(RechercheChemin *rc, int s, int t, int *longueur){
+  int l = 0, x, *chemin;
+
+  if (DistanceAtteinte(rc, t) < 0) return NULL;
+  for (x = t; x != -1; x = rc->pred[x]) l++;
+  chemin = (int *)malloc(l * sizeof(int));
+  if (chemin == NULL)
+  {   fprintf(stderr, "CheminTrouve : malloc failed\n");
+      exit(0);
+  }
+  *longueur = l;
+  for (x = t; x != -1; x = rc->pred[x]) chemin[--l] = x;
+  if (chemin[0] != s){ /* tampons d'une autre source */
+    free(chemin);
+    return NULL;
+  }
+  return chemin;
+}
+
+/* ====================================================================== */
+/* ====================================================================== */
+/* RECHERCHE BIDIRECTIONNELLE */
+/* ====================================================================== */
+/* ====================================================================== */
+
+/*! \def CLE_INFINIE
+    \brief plus petite clé d'un tas vide, et longueur du meilleur chemin tant qu'il n'y en a pas
+*/
+#define CLE_INFINIE 0x3fffffffffffffffL
+
+/*! \struct Rencontre
+    \brief état partagé par les deux côtés d'une recherche bidirectionnelle ; avec deux threads,
+           meilleur, u et v ne sont modifiés que sous le verrou, les autres lectures sont atomiques
+*/
+typedef struct Rencontre {
+//! longueur du meilleur chemin trouvé (CLE_INFINIE si aucun)
+  long meilleur;
+//! arc de rencontre du meilleur chemin (voir RechercheBidirectionnelle)
+  int u, v;
+//! plus petite clé du tas de chaque côté (CLE_INFINIE si vide)
+  long cle_min[2];
+//! mis à 1 par le premier côté qui s'arrête
+  int fin;
+  pthread_mutex_t verrou;
+} Rencontre;
+
+/*! \struct CoteRecherche
+    \brief un des deux côtés d'une recherche bidirectionnelle
+*/
+typedef struct CoteRecherche {
+  ReseauRoutier *r;
+//! graphe parcouru : successeurs depuis la source, prédécesseurs depuis la cible
+  GrapheCSR *g;
+//! tampons de ce côté
+  RechercheChemin *rc;
+//! tampons de l'autre côté (lus seulement)
+  RechercheChemin *autre;
+//! 0 : depuis la source, 1 : depuis la cible
+  int cote;
+//! source et cible de la requête
+  int s, t;
+  int astar;
+  int parallele;
+  Rencontre *rencontre;
+} CoteRecherche;
+
+/* ====================================================================== */
+/*! \fn static long Potentiel(CoteRecherche *c, int x)
+    \return le potentiel de x pour ce côté : P(x) depuis la source, -P(x) depuis la cible,
+            avec P(x) = estimation(x,t) - estimation(s,x)
+    \brief les deux côtés utilisent le même coût réduit 2 poids(x,y) - P(x) + P(y), positif
+           puisque les estimations sont monotones ; les clés sont 2 dist(x) + potentiel(x)
+*/
+static long Potentiel(CoteRecherche *c, int x){
+  long p;
+  if (!c->astar) return 0;
+  p = EstimationDistance(c->r, x, c->t) - EstimationDistance(c->r, c->s, x);
+  return c->cote ? -p : p;
+}
+
+/* ====================================================================== */
+/*! \fn static void ProposeChemin(CoteRecherche *c, int x, int y, long longueur)
+    \brief retient le chemin de longueur donnée passant par l'arc (x,y) de ce côté s'il est meilleur
+*/
+static void ProposeChemin(CoteRecherche *c, int x, int y, long longueur){
+  Rencontre *m = c->rencontre;
+  if (c->parallele) pthread_mutex_lock(&(m->verrou));
+  if (longueur < m->meilleur){
+    m->u = c->cote ? y : x;
+    m->v = c->cote ? x : y;
+    __atomic_store_n(&(m->meilleur), longueur, __ATOMIC_RELAXED);
+  }
+  if (c->parallele) pthread_mutex_unlock(&(m->verrou));
+}
+
+/* ====================================================================== */
+/*! \fn static void EtapeCote(CoteRecherche *c)
+    \brief stabilise le sommet de plus petite clé de ce côté et relâche ses arcs ; un sommet
+           atteint par les deux côtés donne un chemin candidat. Les marques et distances
+           sont publiées atomiquement pour que l'autre côté puisse les lire depuis un autre thread.
+*/
+static void EtapeCote(CoteRecherche *c){
+  RechercheChemin *rc = c->rc, *autre = c->autre;
+  TasQuaternaire *tas = &(rc->tas);
+  GrapheCSR *g = c->g;
+  unsigned int gen = rc->generation, genautre = autre->generation;
+  int x, y, i;
+  long d, nd, da;
+
+  x = ExtraitTasQuaternaire(tas);
+  rc->stabilises++;
+  d = rc->dist[x];
+  for (i = g->debut[x]; i < g->debut[x + 1]; i++){
+    y = g->voisin[i];
+    nd = d + g->poids[i];
+    if (rc->marque[y] != gen){ /* premier passage */
+      rc->dist[y] = nd;
+      rc->pred[y] = x;
+      rc->atteints[rc->natteints++] = y;
+      __atomic_store_n(&(rc->marque[y]), gen, __ATOMIC_RELEASE);
+      MonteTasQuaternaire(tas, tas->n++, 2 * nd + Potentiel(c, y), y);
+    }
+    else if ((nd < rc->dist[y]) && (tas->position[y] >= 0)){ /* diminution de clé */
+      rc->pred[y] = x;
+      MonteTasQuaternaire(tas, tas->position[y], tas->cle[tas->position[y]] - 2 * (rc->dist[y] - nd), y);
+      __atomic_store_n(&(rc->dist[y]), nd, __ATOMIC_RELAXED);
+    }
+    else continue;
+    if (__atomic_load_n(&(autre->marque[y]), __ATOMIC_ACQUIRE) == genautre){
+      da = __atomic_load_n(&(autre->dist[y]), __ATOMIC_RELAXED);
+      if (nd + da < __atomic_load_n(&(c->rencontre->meilleur), __ATOMIC_RELAXED)) ProposeChemin(c, x, y, nd + da);
+    }
+  }
+  __atomic_store_n(&(c->rencontre->cle_min[c->cote]), (tas->n > 0) ? tas->cle[0] : CLE_INFINIE, __ATOMIC_RELAXED);
+}
+
+/* ====================================================================== */
+/*! \fn static int RechercheTerminee(Rencontre *m)
+    \return 1 si aucun chemin plus court que le meilleur ne reste à trouver : un côté est
+            épuisé, ou la somme des plus petites clés atteint 2 meilleur (les clés sont doublées)
+*/
+static int RechercheTerminee(Rencontre *m){
+  long a = __atomic_load_n(&(m->cle_min[0]), __ATOMIC_RELAXED);
+  long b = __atomic_load_n(&(m->cle_min[1]), __ATOMIC_RELAXED);
+  long meilleur = __atomic_load_n(&(m->meilleur), __ATOMIC_RELAXED);
+  if (__atomic_load_n(&(m->fin), __ATOMIC_RELAXED)) return 1;
+  if ((a >= CLE_INFINIE) || (b >= CLE_INFINIE)) return 1;
+  return (meilleur < CLE_INFINIE) && (a + b >= 2 * meilleur);
+}
+
+/* ====================================================================== */
+/*! \fn static void * CoteThread(void *arg)
+    \param arg : un côté de la recherche
+    \brief fait avancer ce côté jusqu'à l'arrêt, puis arrête l'autre
+*/
+static void * CoteThread(void *arg){
+  CoteRecherche *c = (CoteRecherche *)arg;
+  while (!RechercheTerminee(c->rencontre)) EtapeCote(c);
+  __atomic_store_n(&(c->rencontre->fin), 1, __ATOMIC_RELAXED);
+  return NULL;
+}
+
+/* ====================================================================== */
+/*! \fn void InitRechercheBidirectionnelle(RechercheBidirectionnelle *rb, int nsom)
+    \param rb : tampons à initialiser
+    \param nsom : nombre de sommets du réseau
+*/
+void InitRechercheBidirectionnelle(RechercheBidirectionnelle *rb, int nsom){
+  InitRechercheChemin(&(rb->avant), nsom);
+  InitRechercheChemin(&(rb->arriere), nsom);
+  rb->meilleur = -1;
+  rb->u = rb->v = -1;
+  rb->stabilises = 0;
+}
+
+/* ====================================================================== */
+/*! \fn void TermineRechercheBidirectionnelle(RechercheBidirectionnelle *rb)
+    \param rb : tampons d'une recherche bidirectionnelle
+*/
+void TermineRechercheBidirectionnelle(RechercheBidirectionnelle *rb){
+  TermineRechercheChemin(&(rb->avant));
+  TermineRechercheChemin(&(rb->arriere));
+}
+
+/* ====================================================================== */
+/*! \fn long PlusCourtCheminBidirectionnel(ReseauRoutier *r, RechercheBidirectionnelle *rb, int s, int t, int astar, int parallele)
+    \param r : un réseau
+    \param rb : tampons de la recherche
+    \param s : sommet source
+    \param t : sommet cible
+    \param astar : si non nul, les deux côtés sont guidés par les potentiels moyens (voir Potentiel)
+    \param parallele : si non nul, le côté de la cible avance dans un second thread
+    \return la longueur d'un plus court chemin de s à t, -1 s'il n'y en a pas
+    \brief Dijkstra (ou A*) depuis s et depuis t à la fois. En séquentiel, le côté de plus
+           petite clé avance. Avec deux threads, une rencontre peut échapper aux deux côtés
+           (chacun lit les distances de l'autre pendant qu'elles changent) : le meilleur
+           chemin retenu n'est alors qu'un majorant, ce qui retarde l'arrêt sans le rendre
+           faux, et il est corrigé après coup en parcourant les arcs qui sortent des
+           sommets atteints depuis s.
+*/
+long PlusCourtCheminBidirectionnel(ReseauRoutier *r, RechercheBidirectionnelle *rb, int s, int t, int astar, int parallele){
+  CoteRecherche cotes[2];
+  Rencontre m;
+  int c, k, i, x, y;
+
+  astar = astar && !EstimationNulle(r);
+  m.meilleur = CLE_INFINIE;
+  m.u = m.v = -1;
+  m.fin = 0;
+  pthread_mutex_init(&(m.verrou), NULL);
+  for (c = 0; c < 2; c++){
+    cotes[c].r = r;
+    cotes[c].g = c ? r->inverse : r->g;
+    cotes[c].rc = c ? &(rb->arriere) : &(rb->avant);
+    cotes[c].autre = c ? &(rb->avant) : &(rb->arriere);
+    cotes[c].cote = c;
+    cotes[c].s = s;
+    cotes[c].t = t;
+    cotes[c].astar = astar;
+    cotes[c].parallele = parallele;
+    cotes[c].rencontre = &m;
+    NouvelleRechercheChemin(cotes[c].rc, c ? t : s, Potentiel(&(cotes[c]), c ? t : s));
+    m.cle_min[c] = cotes[c].rc->tas.cle[0];
+  }
+  if (s == t){
+    m.meilleur = 0;
+    m.u = m.v = s;
+  }
+
+  if (parallele){
+    pthread_t thread;
+    pthread_create(&thread, NULL, CoteThread, &(cotes[1]));
+    CoteThread(&(cotes[0]));
+    pthread_join(thread, NULL);
+    for (k = 0; k < rb->avant.natteints; k++){ /* rencontres manquées */
+      x = rb->avant.atteints[k];
+      for (i = r->g->debut[x]; i < r->g->debut[x + 1]; i++){
+        y = r->g->voisin[i];
+        if ((DistanceAtteinte(&(rb->arriere), y) >= 0) &&
+            (rb->avant.dist[x] + r->g->poids[i] + rb->arriere.dist[y] < m.meilleur)){
+          m.meilleur = rb->avant.dist[x] + r->g->poids[i] + rb->arriere.dist[y];
+          m.u = x;
+          m.v = y;
+        }
+      }
+    }
+  }
+  else
+    while (!RechercheTerminee(&m))
+      EtapeCote(&(cotes[(m.cle_min[0] <= m.cle_min[1]) ? 0 : 1]));
+
+  pthread_mutex_destroy(&(m.verrou));
+  rb->meilleur = (m.meilleur < CLE_INFINIE) ? m.meilleur : -1;
+  rb->u = m.u;
+  rb->v = m.v;
+  rb->stabilises = rb->avant.stabilises + rb->arriere.stabilises;
+  return rb->meilleur;
+}
+
+/* ====================================================================== */
+/*! \fn int* CheminBidirectionnel(RechercheBidirectionnelle *rb, int *longueur)
+    \param rb : tampons de la dernière recherche bidirectionnelle
+    \param longueur : (sortie) nombre de sommets du chemin
+    \return les sommets du chemin (à libérer par l'appelant), NULL s'il n'y en a pas
+    \brief chemin de la source à u (à rebours dans avant.pred), puis de v à la cible (arriere.pred)
+*/
+int* CheminBidirectionnel(RechercheBidirectionnelle *rb, int *longueur){
+  int l = 0, k, x, *chemin;
+
+  if (rb->meilleur < 0) return NULL;
+  for (x = rb->u; x != -1; x = rb->avant.pred[x]) l++;
+  k = l;
+  if (rb->v != rb->u) for (x = rb->v; x != -1; x = rb->arriere.pred[x]) l++;
+  chemin = (int *)malloc(l * sizeof(int));
+  if (chemin == NULL)
+  {   fprintf(stderr, "CheminBidirectionnel : malloc failed\n");
+      exit(0);
+  }
+  *longueur = l;
+  for (x = rb->u, l = k; x != -1; x = rb->avant.pred[x]) chemin[--l] = x;
+  if (rb->v != rb->u) for (x = rb->v; x != -1; x = rb->arriere.pred[x]) chemin[k++] = x;
+  return chemin;
+}
+
+/* ====================================================================== */
+/* ====================================================================== */
+/* LIGNE DE COMMANDE */
+/* ====================================================================== */
+/* ====================================================================== */
+
+/*! \def NB_METHODES
+    \brief nombre de méthodes comparées par CompareRequetesAleatoires (la dernière demande une hiérarchie)
+*/
+#define NB_METHODES 6
+
+/* ====================================================================== */
+/*! \fn static long ResoutMethode(ReseauRoutier *r, Hierarchie *h, RechercheBidirectionnelle *rb, int methode, int s, int t, long *stabilises)
+    \brief résout la requête (s,t) par une des méthodes comparées : 0 Dijkstra, 1 A*,
+           2 Dijkstra bidirectionnel, 3 A* bidirectionnel, 4 A* bidirectionnel sur deux threads,
+           5 hiérarchie de contraction
+*/
+static long ResoutMethode(ReseauRoutier *r, Hierarchie *h, RechercheBidirectionnelle *rb, int methode, int s, int t, long *stabilises){
+  long d;
+  if (methode < 2){
+    d = PlusCourtChemin(r, &(rb->avant), s, t, methode);
+    *stabilises = rb->avant.stabilises;
+    return d;
+  }
+  if (methode == 5) d = RequeteHierarchie(h, rb, s, t);
+  else d = PlusCourtCheminBidirectionnel(r, rb, s, t, methode >= 3, methode == 4);
+  *stabilises = rb->stabilises;
+  return d;
+}
+
+/* ====================================================================== */
+/*! \fn static int CompareRequetesAleatoires(ReseauRoutier *r, Hierarchie *h, int requetes, unsigned long long graine)
+    \return 0 si toutes les méthodes trouvent les mêmes distances, 1 sinon
+    \brief tire des couples (source, cible) et compare les recherches unidirectionnelles,
+           bidirectionnelles et, si h n'est pas NULL, la hiérarchie (temps et sommets
+           stabilisés par requête)
+*/
+static int CompareRequetesAleatoires(ReseauRoutier *r, Hierarchie *h, int requetes, unsigned long long graine){
+  RechercheBidirectionnelle rb;
+  Alea a;
+  int q, s, t, ok = 1, methode, nmethodes = (h != NULL) ? NB_METHODES : NB_METHODES - 1;
+  long *distances, d, stab;
+  long long t0;
+  double temps[NB_METHODES] = {0}, stabilises[NB_METHODES] = {0};
+  const char *noms[NB_METHODES] = {"dijkstra", "astar", "bidir-dijkstra", "bidir-astar", "bidir-astar-2t", "hierarchie"};
+
+  distances = (long *)malloc(requetes * sizeof(long));
+  if (distances == NULL)
+  {   fprintf(stderr, "CompareRequetesAleatoires : malloc failed\n");
+      exit(0);
+  }
+  InitRechercheBidirectionnelle(&rb, r->g->nsom);
+  for (methode = 0; methode < nmethodes; methode++){
+    InitAlea(&a, graine);
+    for (q = 0; q < requetes; q++){
+      s = AleaEntier(&a, r->g->nsom);
+      t = AleaEntier(&a, r->g->nsom);
+      t0 = horloge_ns();
+      d = ResoutMethode(r, h, &rb, methode, s, t, &stab);
+      temps[methode] += horloge_ns() - t0;
+      stabilises[methode] += stab;
+      if (methode == 0) distances[q] = d;
+      else if (d != distances[q]){
+        fprintf(stderr, "chemin : requete %d (%d -> %d), dijkstra %ld et %s %ld diffèrent\n",
+                q, s, t, distances[q], noms[methode], d);
+        ok = 0;
+      }
+    }
+  }
+  for (methode = 0; methode < nmethodes; methode++)
+    printf("%-15s : %d requetes, %.3f ms et %.0f sommets stabilises par requete\n", noms[methode],
+           requetes, temps[methode] / 1e6 / requetes, stabilises[methode] / requetes);
+
+  t0 = horloge_ns();
+  DijkstraToutes(r, &(rb.avant), 0);
+  printf("dijkstra depuis 0 vers tous les sommets : %.3f ms\n", (horloge_ns() - t0) / 1e6);
+  TermineRechercheBidirectionnelle(&rb);
+  free(distances);
+  return ok ? 0 : 1;
+}
+
+/* ====================================================================== */
+/*! \fn int ModeChemin(int argc, char **argv)
+    \param argc : nombre d'arguments (après "chemin")
+    \param argv : arguments (après "chemin")
+    \return 0 si tout s'est bien passé
+    \brief point d'entrée de "AEtoile.exe chemin" (voir l'en-tête du fichier)
+*/
+int ModeChemin(int argc, char **argv){
+  char *nomgraphe = NULL;
+  int s = -1, t = -1, astar = 1, symetrique = 1, geographique = 0, bidirectionnel = 0, parallele = 0;
+  int aleatoire = 0, routier = 0, arcs = 0, requetes = 100, temoins = 0, i, ret = 0;
+  int nreperes = REPERES_DEFAUT, table = 0, tournee = 0;
+  ChoixReperes choix = REPERES_EVITEMENT;
+  char *nomhierarchie = NULL, *nomreperes = NULL;
+  Hierarchie *h = NULL;
+  Reperes *rp = NULL;
+  unsigned long long graine = 1;
+  long long debut;
+  graphe *G;
+  ReseauRoutier *r;
+
+  for (i = 0; i < argc; i++){
+    if (!strcmp(argv[i], "--dijkstra")) astar = 0;
+    else if (!strcmp(argv[i], "--oriente")) symetrique = 0;
+    else if (!strcmp(argv[i], "--geographique")) geographique = 1;
+    else if (!strcmp(argv[i], "--bidirectionnel")) bidirectionnel = 1;
+    else if (!strcmp(argv[i], "--parallele")) bidirectionnel = parallele = 1;
+    else if (!strcmp(argv[i], "--aleatoire") && (i + 1 < argc)) aleatoire = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--routier") && (i + 1 < argc)) aleatoire = routier = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--hierarchie") && (i + 1 < argc)) nomhierarchie = argv[++i];
+    else if (!strcmp(argv[i], "--temoins") && (i + 1 < argc)) temoins = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--reperes") && (i + 1 < argc)) nomreperes = argv[++i];
+    else if (!strcmp(argv[i], "--nreperes") && (i + 1 < argc)) nreperes = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--table") && (i + 1 < argc)) table = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--tournee")) tournee = 1;
+    else if (!strcmp(argv[i], "--choix") && (i + 1 < argc)){
+      i++;
+      if (!strcmp(argv[i], "aleatoires")) choix = REPERES_ALEATOIRES;
+      else if (!strcmp(argv[i], "eloignes")) choix = REPERES_ELOIGNES;
+      else if (!strcmp(argv[i], "evitement")) choix = REPERES_EVITEMENT;
+      else {
+        fprintf(stderr, "chemin : choix de repères inconnu %s\n", argv[i]);
+        return 1;
+      }
+    }
+    else if (!strcmp(argv[i], "--arcs") && (i + 1 < argc)) arcs = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--requetes") && (i + 1 < argc)) requetes = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--graine") && (i + 1 < argc)) graine = strtoull(argv[++i], NULL, 10);
+    else if ((nomgraphe == NULL) && !aleatoire) nomgraphe = argv[i];
+    else if ((s < 0) && !aleatoire) s = atoi(argv[i]);
+    else if ((t < 0) && !aleatoire) t = atoi(argv[i]);
+    else {
+      fprintf(stderr, "chemin : argument inconnu %s\n", argv[i]);
+      return 1;
+    }
+  }
+  if ((aleatoire <= 1) && ((nomgraphe == NULL) || ((s >= 0) && (t < 0)))){
+    fprintf(stderr, "Usage : ./AEtoile.exe chemin graphe source cible [--dijkstra] [--bidirectionnel|--parallele] [--hierarchie f] [--reperes f] [--oriente] [--geographique]\n");
+    fprintf(stderr, "        ./AEtoile.exe chemin graphe [--requetes q] [--graine s] [--hierarchie f] [--reperes f [--nreperes k] [--choix c]] [--oriente] [--geographique]\n");
+    fprintf(stderr, "        ./AEtoile.exe chemin (--aleatoire n [--arcs m] | --routier n) [--requetes q] [--graine s] [--hierarchie f] [--reperes f]\n");
+    fprintf(stderr, "        ./AEtoile.exe chemin (graphe | --routier n) --table k [--tournee] [--graine s] [--hierarchie f]\n");
+    return 1;
+  }
+
+  debut = horloge_ns();
+  if (routier > 1) G = GrapheRoutierAleatoire(routier, graine);
+  else if (aleatoire > 1){
+    double possibles = (double)aleatoire * (aleatoire - 1) / 2;
+    if (arcs <= 0) arcs = 3 * aleatoire;
+    if (arcs < aleatoire - 1) arcs = aleatoire - 1;
+    if (arcs > possibles) arcs = (int)possibles;
+    G = GrapheAleatoireConnexe(aleatoire, arcs, graine, 1);
+  }
+  else if ((G = ReadGraphe(nomgraphe)) == NULL) return 1;
+  r = CreeReseau(G, symetrique, geographique);
+  printf("reseau : %d sommets, %d arcs, facteur %g, construit en %.3f s\n",
+         r->g->nsom, r->g->narc, r->facteur, (horloge_ns() - debut) / 1e9);
+  TermineGraphe(G);
+
+  if (nomhierarchie != NULL){ /* relue si le fichier existe, construite et écrite sinon */
+    debut = horloge_ns();
+    h = LitHierarchie(nomhierarchie);
+    if ((h != NULL) && ((h->nsom != r->g->nsom) || (h->narc_graphe != r->g->narc))){
+      fprintf(stderr, "chemin : %s ne correspond pas au graphe, reconstruction\n", nomhierarchie);
+      TermineHierarchie(h);
+      h = NULL;
+    }
+    if (h != NULL) printf("hierarchie : lue en %.3f s\n", (horloge_ns() - debut) / 1e9);
+    else {
+      h = ConstruitHierarchie(r, temoins);
+      printf("hierarchie : %d raccourcis, construite en %.3f s\n", h->narc - h->narc_graphe,
+             (horloge_ns() - debut) / 1e9);
+      EcritHierarchie(h, nomhierarchie);
+    }
+  }
+
+  if (nomreperes != NULL){ /* relus si le fichier existe, choisis et écrits sinon */
+    debut = horloge_ns();
+    rp = LitReperes(nomreperes);
+    if ((rp != NULL) && ((rp->nsom != r->g->nsom) || (rp->narc_graphe != r->g->narc) ||
+                         (rp->oriente != (r->inverse != r->g)))){
+      fprintf(stderr, "chemin : %s ne correspond pas au graphe, nouveau choix\n", nomreperes);
+      TermineReperes(rp);
+      rp = NULL;
+    }
+    if (rp != NULL) printf("reperes : %d, lus en %.3f s\n", rp->nreperes, (horloge_ns() - debut) / 1e9);
+    else {
+      rp = ChoisitReperes(r, nreperes, choix, graine);
+      printf("reperes : %d, choisis en %.3f s\n", rp->nreperes, (horloge_ns() - debut) / 1e9);
+      EcritReperes(rp, nomreperes);
+    }
+    r->reperes = rp;
+  }
+
+  if (table > 0) ret = EssaiTable(r, h, table, graine, tournee);
+  else if ((aleatoire > 1) || (s < 0)){
+    if (requetes < 1) requetes = 1;
+    ret = CompareRequetesAleatoires(r, h, requetes, graine);
+  }
+  else if ((s >= r->g->nsom) || (t >= r->g->nsom)){
+    fprintf(stderr, "chemin : sommet hors du graphe\n");
+    ret = 1;
+  }
+  else {
+    RechercheBidirectionnelle rb;
+    int longueur, *chemin;
+    long d;
+    InitRechercheBidirectionnelle(&rb, r->g->nsom);
+    debut = horloge_ns();
+    if (h != NULL) d = RequeteHierarchie(h, &rb, s, t);
+    else if (bidirectionnel) d = PlusCourtCheminBidirectionnel(r, &rb, s, t, astar, parallele);
+    else d = PlusCourtChemin(r, &(rb.avant), s, t, astar);
+    if (h != NULL) printf("hierarchie : %.3f ms, %ld sommets stabilises\n", (horloge_ns() - debut) / 1e6, rb.stabilises);
+    else printf("%s%s%s : %.3f ms, %ld sommets stabilises\n", bidirectionnel ? "bidir-" : "",
+                astar ? "astar" : "dijkstra", parallele ? "-2t" : "",
+                (horloge_ns() - debut) / 1e6, bidirectionnel ? rb.stabilises : rb.avant.stabilises);
+    if (d < 0) printf("Pas de chemin de %d a %d\n", s, t);
+    else {
+      if (h != NULL) chemin = CheminHierarchie(h, &rb, &longueur);
+      else chemin = bidirectionnel ? CheminBidirectionnel(&rb, &longueur) : CheminTrouve(&(rb.avant), s, t, &longueur);
+      printf("Chemin (cout %ld) :\n", d);
+      for (i = 0; i < longueur; i++) printf((i + 1 < longueur) ? "%d -> " : "%d\n", chemin[i]);
+      free(chemin);
+    }
+    TermineRechercheBidirectionnelle(&rb);
+  }
+  if (h != NULL) TermineHierarchie(h);
+  if (rp != NULL) TermineReperes(rp);
+  TermineReseau(r);
+  return ret;
+}
@@ -0,0 +1,114 @@
+/*! \file chemins.h
+    \brief plus courts chemins sur la carte routière : Dijkstra depuis une source, A* point à point
+           et recherche bidirectionnelle
+*/
+#ifndef CHEMINS_H
+#define CHEMINS_H
+
+#include "csr.h"
+
+/*! \struct ReseauRoutier
+    \brief graphe prêt pour les recherches de chemins (lecture seule, partagé entre threads)
+*/
+typedef struct ReseauRoutier {
+//! successeurs au format CSR
+  GrapheCSR *g;
+//! prédécesseurs au format CSR (successeurs du graphe Symetrique), égal à g si le réseau est symétrique
+  GrapheCSR *inverse;
+//! abscisses (longitudes en radians si geographique)
+  double *cx;
+//! ordonnées (latitudes en radians si geographique)
+  double *cy;
+//! si non nul, les coordonnées sont des degrés (longitude, latitude) et l'écart est la distance du grand cercle
+  int geographique;
+//! plus grand facteur tel que facteur * écart(x,y) <= poids de l'arc (x,y) pour tous les arcs, 0 sans coordonnées
+  double facteur;
+//! repères de l'estimation ALT (voir reperes.c), NULL sans repères ; non libérés par TermineReseau
+  struct Reperes *reperes;
+} ReseauRoutier;
+
+/*! \def EstimationNulle(r)
+    \brief vrai si A* n'a aucune estimation sur le réseau r (ni coordonnées ni repères)
+*/
+#define EstimationNulle(r) (((r)->facteur == 0) && ((r)->reperes == NULL))
+
+/*! \struct TasQuaternaire
+    \brief tas 4-aire (clé, sommet) avec diminution de clé : position[x] est l'indice de x
+           dans le tas, -1 une fois x extrait
+*/
+typedef struct TasQuaternaire {
+//! nombre d'entrées
+  int n;
+//! clés
+  long *cle;
+//! sommets
+  int *som;
+//! position de chaque sommet (valide pour les sommets atteints par la recherche en cours)
+  int *position;
+} TasQuaternaire;
+
+/*! \struct RechercheChemin
+    \brief tampons d'une recherche (un par thread), réutilisés sans remise à zéro :
+           dist[x] et pred[x] ne sont valides que si marque[x] == generation
+*/
+typedef struct RechercheChemin {
+//! nombre de sommets
+  int nsom;
+//! marques des sommets atteints
+  unsigned int *marque;
+//! génération de la recherche en cours
+  unsigned int generation;
+//! distance (provisoire ou définitive) depuis la source
+  long *dist;
+//! prédécesseur sur le chemin depuis la source, -1 pour la source
+  int *pred;
+//! sommets atteints par la recherche en cours, dans l'ordre où ils ont été atteints
+  int *atteints;
+//! nombre de sommets atteints
+  int natteints;
+//! file de priorité
+  TasQuaternaire tas;
+//! nombre de sommets stabilisés (extraits du tas) par la dernière recherche
+  long stabilises;
+} RechercheChemin;
+
+/*! \struct RechercheBidirectionnelle
+    \brief tampons d'une recherche bidirectionnelle : une recherche depuis la source sur les
+           successeurs, une depuis la cible sur les prédécesseurs
+*/
+typedef struct RechercheBidirectionnelle {
+//! recherche depuis la source
+  RechercheChemin avant;
+//! recherche depuis la cible, sur le réseau inverse
+  RechercheChemin arriere;
+//! longueur du meilleur chemin trouvé, -1 si aucun
+  long meilleur;
+//! arc (u,v) où les deux recherches se rejoignent : u est atteint depuis la source, v depuis la cible
+  int u, v;
+//! sommets stabilisés par les deux recherches
+  long stabilises;
+} RechercheBidirectionnelle;
+
+/*! \def DistanceAtteinte(rc, x)
+    \brief distance de la source à x calculée par la dernière recherche, -1 si x n'a pas été atteint
+*/
+#define DistanceAtteinte(rc, x) (((rc)->marque[x] == (rc)->generation) ? (rc)->dist[x] : -1)
+
+ReseauRoutier* CreeReseau(graphe *G, int symetrique, int geographique);
+void TermineReseau(ReseauRoutier *r);
+long EstimationDistance(ReseauRoutier *r, int x, int t);
+void InitRechercheChemin(RechercheChemin *rc, int nsom);
+void TermineRechercheChemin(RechercheChemin *rc);
+void DijkstraToutes(ReseauRoutier *r, RechercheChemin *rc, int s);
+long PlusCourtChemin(ReseauRoutier *r, RechercheChemin *rc, int s, int t, int astar);
+int* CheminTrouve(RechercheChemin *rc, int s, int t, int *longueur);
+void MonteTasQuaternaire(TasQuaternaire *t, int i, long cle, int som);
+int ExtraitTasQuaternaire(TasQuaternaire *t);
+void NouvelleRechercheChemin(RechercheChemin *rc, int s, long cle);
+void InitRechercheBidirectionnelle(RechercheBidirectionnelle *rb, int nsom);
+void TermineRechercheBidirectionnelle(RechercheBidirectionnelle *rb);
+long PlusCourtCheminBidirectionnel(ReseauRoutier *r, RechercheBidirectionnelle *rb, int s, int t, int astar, int parallele);
+int* CheminBidirectionnel(RechercheBidirectionnelle *rb, int *longueur);
+int ModeChemin(int argc, char **argv);
+
+#endif /* CHEMINS_H */
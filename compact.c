@@ -0,0 +1,410 @@
+/*! \file compact.c
+    \brief A* sur des noeuds compacts pour les instances d'au plus 64 villes
+
+    Dans Resoudre (vdc.c), chaque noeud est un node alloué sur le tas avec la liste de ses
+    villes : plus de 300 octets par noeud à 64 villes, allocateur compris. Or l'évaluation
+    d'un noeud (ComputeH) et ses successeurs (DevelopNode) ne dépendent que de l'ensemble
+    des villes visitées, de la dernière ville et du coût g : un noeud tient ici en
+    24 octets (NoeudCompact), rangés dans une réserve contiguë ; le chemin se retrouve en
+    remontant les indices des parents.
+
+    Comme deux chemins qui visitent les mêmes villes et finissent à la même ville ont les
+    mêmes successeurs, seul le moins coûteux est gardé : une table des états (adressage
+    ouvert sur le masque et la dernière ville) donne le meilleur noeud de chaque état, un
+    successeur plus coûteux qu'un noeud connu du même état est élagué, et une entrée de la
+    liste ouverte dont le noeud a été battu depuis est ignorée à l'extraction. La liste
+    ouverte est un tas binaire (TasDijkstra, 12 octets par entrée) dont la clé est
+    f * 128 + (127 - profondeur) : à f égal, le noeud le plus profond sort d'abord.
+
+    Par noeud développé, il en coûte 24 octets de réserve, au plus 8 octets de table (taux
+    de remplissage maximum 1/2) et 12 octets par entrée de la liste ouverte.
+
+    La recherche est compilée pour des masques de 16, 32 et 64 villes (ResoudreLargeur) :
+    les distances sont recopiées en lignes de la largeur choisie, les villes au-delà de
+    nsom sont marquées visitées dès le départ, et les successeurs comme les heuristiques
+    H1 et H2 parcourent les bits du masque au lieu de boucler sur nsom.
+*/
+#include "compact.h"
+
+/*! \def CLE_COMPACTE(f, profondeur)
+    \brief clé de la liste ouverte : f, puis la plus grande profondeur
+*/
+#define CLE_COMPACTE(f, profondeur) ((f) * 128 + (127 - (profondeur)))
+
+/* ====================================================================== */
+/*! \fn RechercheCompacte* CreeRechercheCompacte()
+    \return des tampons de recherche vides
+*/
+RechercheCompacte* CreeRechercheCompacte(){
+  RechercheCompacte *rc = (RechercheCompacte *)calloc(1, sizeof(RechercheCompacte));
+  if (rc == NULL)
+  {   fprintf(stderr, "CreeRechercheCompacte : calloc failed\n");
+      exit(0);
+  }
+  InitTasDijkstra(&(rc->ouverte), 1024);
+  rc->lignes = (long *)malloc(COMPACT_MAX_VILLES * COMPACT_MAX_VILLES * sizeof(long));
+  if (rc->lignes == NULL)
+  {   fprintf(stderr, "CreeRechercheCompacte : malloc failed\n");
+      exit(0);
+  }
+  return rc;
+}
+
+/* ====================================================================== */
+/*! \fn void TermineRechercheCompacte(RechercheCompacte *rc)
+    \param rc : des tampons de recherche
+*/
+void TermineRechercheCompacte(RechercheCompacte *rc){
+  free(rc->noeuds);
+  free(rc->table);
+  free(rc->lignes);
+  TermineTasDijkstra(&(rc->ouverte));
+  free(rc);
+}
+
+/* ====================================================================== */
+/*! \fn static long CaseEtat(unsigned long long masque, int derniere, long taille)
+    \return la première case de la table à sonder pour l'état (masque, derniere)
+*/
+static long CaseEtat(unsigned long long masque, int derniere, long taille){
+  unsigned long long h = (masque ^ ((unsigned long long)derniere << 58)) * 0x9E3779B97F4A7C15ULL;
+  return (long)((h ^ (h >> 29)) & (unsigned long long)(taille - 1));
+}
+
+/* ====================================================================== */
+/*! \fn static long ChercheEtat(RechercheCompacte *rc, unsigned long long masque, int derniere)
+    \return la case de la table qui contient l'état, ou la case vide où le ranger
+*/
+static long ChercheEtat(RechercheCompacte *rc, unsigned long long masque, int derniere){
+  long c = CaseEtat(masque, derniere, rc->taille_table);
+  NoeudCompact *x;
+  while (rc->table[c] >= 0){
+    x = &(rc->noeuds[rc->table[c]]);
+    if ((x->masque == masque) && (x->derniere == derniere)) return c;
+    c = (c + 1) & (rc->taille_table - 1);
+  }
+  return c;
+}
+
+/* ====================================================================== */
+/*! \fn static void AgranditTable(RechercheCompacte *rc, long taille)
+    \brief réalloue la table avec taille cases et y range à nouveau les états
+*/
+static void AgranditTable(RechercheCompacte *rc, long taille){
+  int *ancienne = rc->table;
+  long ancienne_taille = rc->taille_table, c;
+
+  rc->table = (int *)malloc(taille * sizeof(int));
+  if (rc->table == NULL)
+  {   fprintf(stderr, "AgranditTable : malloc failed\n");
+      exit(0);
+  }
+  memset(rc->table, -1, taille * sizeof(int));
+  rc->taille_table = taille;
+  for (c = 0; c < ancienne_taille; c++)
+    if (ancienne[c] >= 0){
+      NoeudCompact *x = &(rc->noeuds[ancienne[c]]);
+      rc->table[ChercheEtat(rc, x->masque, x->derniere)] = ancienne[c];
+    }
+  free(ancienne);
+}
+
+/* ====================================================================== */
+/*! \fn static int AjouteNoeud(RechercheCompacte *rc, unsigned long long masque, int derniere, long g, int parent)
+    \return l'indice du nouveau noeud dans la réserve
+*/
+static int AjouteNoeud(RechercheCompacte *rc, unsigned long long masque, int derniere, long g, int parent){
+  NoeudCompact *x;
+  if (rc->nnoeuds == rc->maxnoeuds){
+    rc->maxnoeuds = (rc->maxnoeuds > 0) ? 2 * rc->maxnoeuds : 1024;
+    rc->noeuds = (NoeudCompact *)realloc(rc->noeuds, rc->maxnoeuds * sizeof(NoeudCompact));
+    if (rc->noeuds == NULL)
+    {   fprintf(stderr, "AjouteNoeud : realloc failed\n");
+        exit(0);
+    }
+  }
+  x = &(rc->noeuds[rc->nnoeuds]);
+  x->masque = masque;
+  x->derniere = (unsigned char)derniere;
+  x->g = g;
+  x->parent = parent;
+  x->provisoire = 0;
+  return rc->nnoeuds++;
+}
+
+/* ====================================================================== */
+/*! \fn static void PrepareLignes(RechercheCompacte *rc, ContexteSolveur *ctx, int largeur)
+    \brief recopie la table des distances en lignes de largeur cases (-1 au-delà de nsom)
+           et les arêtes minimum et de l'arbre des villes (0 au-delà de nsom)
+*/
+static void PrepareLignes(RechercheCompacte *rc, ContexteSolveur *ctx, int largeur){
+  int a, b;
+  for (a = 0; a < largeur; a++){
+    for (b = 0; b < largeur; b++)
+      rc->lignes[a * largeur + b] = ((a < ctx->nsom) && (b < ctx->nsom)) ? DISTANCE(ctx, a, b) : -1;
+    rc->arcmin[a] = (a < ctx->nsom) ? ctx->arcmin[a] : 0;
+    rc->arcarbre[a] = (a < ctx->nsom) ? ctx->arcArbre[a] : 0;
+  }
+}
+
+/* ====================================================================== */
+/*! \fn static inline long HeuristiqueMasque(RechercheCompacte *rc, ContexteSolveur *ctx, unsigned long long masque, int derniere, int depart, const int code, EspaceTravail *ws, const unsigned long long complet)
+    \return la valeur h de ComputeH pour un noeud dont les villes visitées sont masque et
+            la dernière ville derniere (0 pour une tournée complète)
+    \brief les villes absentes (au-delà de nsom) sont marquées visitées dans masque et ont
+           des arêtes nulles : seuls les bits du masque sont parcourus
+*/
+static inline __attribute__((always_inline)) long HeuristiqueMasque(RechercheCompacte *rc, ContexteSolveur *ctx,
+                                                                    unsigned long long masque, int derniere, int depart,
+                                                                    const int code, EspaceTravail *ws,
+                                                                    const unsigned long long complet){
+  unsigned long long reste;
+  long h = 0;
+  int k;
+
+  if ((masque == complet) && (derniere == depart)) return 0;
+  switch (code){
+    case 1: // arc minimum de chaque ville restante, départ compris quand il ne reste que lui
+      reste = (masque == complet) ? 1ULL << depart : complet & ~masque;
+      for (; reste != 0; reste &= reste - 1) h += rc->arcmin[__builtin_ctzll(reste)];
+      break;
+
+    case 2: // arbre de poids minimum, moins les arêtes des villes quittées
+      h = (long)ctx->poidsArbreMin;
+      for (reste = masque & ~(1ULL << derniere); reste != 0; reste &= reste - 1) h -= rc->arcarbre[__builtin_ctzll(reste)];
+      break;
+
+    case 3: // arbre de poids minimum recalculé sur les villes restantes, la dernière et le départ
+      ReserveEspaceSommets(ws, ctx->nsom);
+      reste = (complet & ~masque) | (1ULL << derniere) | (1ULL << depart);
+      for (k = 0; reste != 0; reste &= reste - 1) ws->correspondance[k++] = __builtin_ctzll(reste);
+      h = PoidsArbreMin(ctx, ws->correspondance, k, ws->cle);
+      if (h < 0) h = 0; // villes restantes non connexes : pas de minorant
+      break;
+
+    default:
+      printf("Heuristique inconnue\n");
+      exit(-1);
+  }
+  return h;
+}
+
+/* ====================================================================== */
+/*! \fn static pnode DeplieNoeud(RechercheCompacte *rc, int i, int n)
+    \return le node du chemin qui mène au noeud i (n villes, départ répété à la fin)
+*/
+static pnode DeplieNoeud(RechercheCompacte *rc, int i, int n){
+  pnode res = AllocNode(n);
+  int l;
+  res->len = n;
+  res->estim_g = res->estim_f = rc->noeuds[i].g;
+  for (l = n - 1; (l >= 0) && (i >= 0); l--, i = rc->noeuds[i].parent) res->listsom[l] = rc->noeuds[i].derniere;
+  return res;
+}
+
+/* ====================================================================== */
+/*! \fn static inline pnode ResoudreLargeur(ContexteSolveur *ctx, OptionsSolveur *options, EspaceTravail *ws, RechercheCompacte *rc, const int largeur, const int code, const int paresseuse)
+    \param largeur : 16, 32 ou 64, au moins ctx->nsom
+    \param code : l'heuristique ; les autres paramètres sont ceux de ResoudreCompact, non NULL
+    \param paresseuse : évaluation paresseuse (heuristique 3 seulement) : un successeur entre
+                        dans la liste ouverte avec pour h le plus grand de l'heuristique 1 et
+                        du h du père moins l'arc le plus court de sa dernière ville vers les
+                        villes restantes ; l'arbre de poids minimum n'est calculé qu'à
+                        l'extraction, et le noeud est remis dans la liste si f augmente
+    \brief corps de ResoudreCompact, toujours développé en ligne : appelé avec une largeur
+           et une heuristique constantes, il donne une recherche dont les lignes de
+           distances ont une longueur fixe et dont les ensembles de villes sont des masques
+           de largeur bits sans taille lue à l'exécution
+*/
+static inline __attribute__((always_inline)) pnode ResoudreLargeur(ContexteSolveur *ctx, OptionsSolveur *options,
+                                                                   EspaceTravail *ws, RechercheCompacte *rc,
+                                                                   const int largeur, const int code, const int paresseuse){
+  const unsigned long long complet = (largeur == 64) ? ~0ULL : (1ULL << largeur) - 1;
+  unsigned long long masque, libres, suivant, initial;
+  StatsRecherche *st = &(ws->stats);
+  int n = ctx->nsom + 1, depart = options->depart, i, j, k, derniere, profondeur;
+  long g, h, hpere = 0, arc, cle, c, distance, tours = 0;
+  const long *ligne;
+
+  PrepareLignes(rc, ctx, largeur);
+  rc->nnoeuds = 0;
+  rc->netats = 0;
+  rc->ouverte.n = 0;
+  if (rc->taille_table == 0) AgranditTable(rc, 1024);
+  else memset(rc->table, -1, rc->taille_table * sizeof(int));
+
+  // les villes absentes sont visitées dès le départ
+  initial = (complet & ~((ctx->nsom == 64) ? ~0ULL : (1ULL << ctx->nsom) - 1)) | (1ULL << depart);
+  i = AjouteNoeud(rc, initial, depart, 0, -1);
+  rc->table[ChercheEtat(rc, initial, depart)] = i;
+  rc->netats = 1;
+  InsereTasDijkstra(&(rc->ouverte), CLE_COMPACTE(HeuristiqueMasque(rc, ctx, initial, depart, depart, code, ws, complet), 1), i);
+
+  while (rc->ouverte.n > 0){
+    // échéance : l'horloge n'est lue qu'une itération sur 64
+    if ((options->echeance_ns != 0) && ((tours++ & 63) == 0) && (horloge_ns() > options->echeance_ns)){
+      st->interrompue = 1;
+      break;
+    }
+
+    STAT_DEBUT(t_ext);
+    i = ExtraitTasDijkstra(&(rc->ouverte), &cle);
+    STAT_FIN(st, ns_extraction, t_ext);
+    masque = rc->noeuds[i].masque;
+    derniere = rc->noeuds[i].derniere;
+    if (rc->table[ChercheEtat(rc, masque, derniere)] != i){ // battu depuis son insertion
+      STAT_AJOUTE(st, noeuds_elagues, 1);
+      continue;
+    }
+    if ((masque == complet) && (derniere == depart) && (rc->noeuds[i].parent >= 0)) // condition d'arrêt
+      return DeplieNoeud(rc, i, n);
+    if (paresseuse){
+      // la clé donne f ; pour un noeud provisoire, h exact, et retour dans la liste si f augmente
+      hpere = cle / 128 - rc->noeuds[i].g;
+      if (rc->noeuds[i].provisoire){
+        STAT_DEBUT(t_h);
+        h = HeuristiqueMasque(rc, ctx, masque, derniere, depart, code, ws, complet);
+        STAT_FIN(st, ns_heuristique, t_h);
+        STAT_AJOUTE(st, appels_heuristique, 1);
+        rc->noeuds[i].provisoire = 0;
+        if (h > hpere){
+          InsereTasDijkstra(&(rc->ouverte), CLE_COMPACTE(rc->noeuds[i].g + h, 127 - cle % 128), i);
+          STAT_AJOUTE(st, noeuds_reinseres, 1);
+          continue;
+        }
+        hpere = h; // le h exact, même plus petit : les successeurs en partent
+      }
+    }
+
+    STAT_AJOUTE(st, noeuds_developpes, 1);
+    STAT_DEBUT(t_dev);
+    profondeur = __builtin_popcountll(masque & ~initial) + 2;
+    ligne = rc->lignes + derniere * largeur;
+    // villes non visitées, ou retour au départ quand toutes le sont
+    libres = (masque == complet) ? 1ULL << depart : complet & ~masque;
+    if (paresseuse){
+      // arc le plus court de la dernière ville vers les villes restantes, départ compris
+      arc = (derniere != depart) ? ligne[depart] : -1;
+      for (suivant = libres; suivant != 0; suivant &= suivant - 1){
+        distance = ligne[__builtin_ctzll(suivant)];
+        if ((distance != -1) && ((arc == -1) || (distance < arc))) arc = distance;
+      }
+      hpere -= (arc > 0) ? arc : 0;
+    }
+    for (; libres != 0; libres &= libres - 1){
+      j = __builtin_ctzll(libres);
+      distance = ligne[j];
+      if (distance == -1) continue;
+      STAT_AJOUTE(st, noeuds_generes, 1);
+      suivant = masque | (1ULL << j);
+      g = rc->noeuds[i].g + distance;
+      c = ChercheEtat(rc, suivant, j);
+      if ((rc->table[c] >= 0) && (rc->noeuds[rc->table[c]].g <= g)){ // état déjà atteint à moindre coût
+        STAT_AJOUTE(st, noeuds_elagues, 1);
+        continue;
+      }
+      k = AjouteNoeud(rc, suivant, j, g, i);
+      if (rc->table[c] < 0) rc->netats++;
+      rc->table[c] = k;
+      if (2 * rc->netats > rc->taille_table) AgranditTable(rc, 2 * rc->taille_table);
+      STAT_DEBUT(t_h);
+      if (paresseuse && ((suivant != complet) || (j != depart))){
+        h = HeuristiqueMasque(rc, ctx, suivant, j, depart, 1, ws, complet);
+        g += max(h, hpere);
+        rc->noeuds[k].provisoire = 1;
+      }
+      else {
+        g += HeuristiqueMasque(rc, ctx, suivant, j, depart, code, ws, complet);
+        STAT_AJOUTE(st, appels_heuristique, 1);
+      }
+      STAT_FIN(st, ns_heuristique, t_h);
+      STAT_DEBUT(t_ins);
+      InsereTasDijkstra(&(rc->ouverte), CLE_COMPACTE(g, profondeur), k);
+      STAT_FIN(st, ns_insertion, t_ins);
+    }
+    STAT_FIN(st, ns_developpement, t_dev);
+    STAT_MAX(st, ouverte_max, rc->ouverte.n);
+    STAT_AJOUTE(st, octets, (long)rc->maxnoeuds * sizeof(NoeudCompact) + rc->taille_table * sizeof(int) +
+                (long)rc->ouverte.capacite * (sizeof(long) + sizeof(int)) - st->octets);
+    STAT_MAX(st, octets_max, st->octets);
+  }
+  return NULL;
+}
+
+/* ====================================================================== */
+/*! \fn static pnode ResoudreLargeurH1(ContexteSolveur *ctx, OptionsSolveur *options, EspaceTravail *ws, RechercheCompacte *rc)
+    \brief recherche de l'heuristique 1 pour la plus petite largeur qui contient les villes
+           (de même pour ResoudreLargeurH2 et ResoudreLargeurH3)
+*/
+static pnode ResoudreLargeurH1(ContexteSolveur *ctx, OptionsSolveur *options, EspaceTravail *ws, RechercheCompacte *rc){
+  if (ctx->nsom <= 16) return ResoudreLargeur(ctx, options, ws, rc, 16, 1, 0);
+  if (ctx->nsom <= 32) return ResoudreLargeur(ctx, options, ws, rc, 32, 1, 0);
+  return ResoudreLargeur(ctx, options, ws, rc, 64, 1, 0);
+}
+
+static pnode ResoudreLargeurH2(ContexteSolveur *ctx, OptionsSolveur *options, EspaceTravail *ws, RechercheCompacte *rc){
+  if (ctx->nsom <= 16) return ResoudreLargeur(ctx, options, ws, rc, 16, 2, 0);
+  if (ctx->nsom <= 32) return ResoudreLargeur(ctx, options, ws, rc, 32, 2, 0);
+  return ResoudreLargeur(ctx, options, ws, rc, 64, 2, 0);
+}
+
+static pnode ResoudreLargeurH3(ContexteSolveur *ctx, OptionsSolveur *options, EspaceTravail *ws, RechercheCompacte *rc){
+  if (ctx->nsom <= 16) return ResoudreLargeur(ctx, options, ws, rc, 16, 3, 0);
+  if (ctx->nsom <= 32) return ResoudreLargeur(ctx, options, ws, rc, 32, 3, 0);
+  return ResoudreLargeur(ctx, options, ws, rc, 64, 3, 0);
+}
+
+static pnode ResoudreLargeurH3Paresseuse(ContexteSolveur *ctx, OptionsSolveur *options, EspaceTravail *ws,
+                                         RechercheCompacte *rc){
+  if (ctx->nsom <= 16) return ResoudreLargeur(ctx, options, ws, rc, 16, 3, 1);
+  if (ctx->nsom <= 32) return ResoudreLargeur(ctx, options, ws, rc, 32, 3, 1);
+  return ResoudreLargeur(ctx, options, ws, rc, 64, 3, 1);
+}
+
+/* ====================================================================== */
+/*! \fn pnode ResoudreCompact(ContexteSolveur *ctx, OptionsSolveur *options, EspaceTravail *ws, RechercheCompacte *rc, StatsRecherche *stats)
+    \param ctx : contexte de résolution, qui n'est pas modifié
+    \param options : heuristique, ville de départ et échéance (NULL : options du contexte)
+    \param ws : espace de travail du thread appelant (NULL : un espace temporaire est créé)
+    \param rc : tampons de la recherche (NULL : des tampons temporaires sont créés)
+    \param stats : si non NULL, reçoit les mesures de la recherche (noeuds_elagues compte
+                   aussi les noeuds battus par un chemin moins coûteux vers le même état)
+    \return comme Resoudre : la tournée (listsom, coût estim_g), NULL si pas de solution ou
+            si l'échéance est dépassée
+    \brief A* sur noeuds compacts (voir l'en-tête du fichier). La recherche est compilée pour
+           chaque heuristique et pour des masques de 16, 32 et 64 villes : la plus petite
+           largeur qui contient les villes est choisie ici, une fois pour toute la recherche.
+           Au-delà de COMPACT_MAX_VILLES villes, ou pour une seule ville, la résolution est
+           confiée à Resoudre.
+*/
+pnode ResoudreCompact(ContexteSolveur *ctx, OptionsSolveur *options, EspaceTravail *ws, RechercheCompacte *rc,
+                      StatsRecherche *stats){
+  EspaceTravail *espace_temporaire = NULL;
+  RechercheCompacte *recherche_temporaire = NULL;
+  pnode res;
+
+  if ((ctx->nsom > COMPACT_MAX_VILLES) || (ctx->nsom < 2)) return Resoudre(ctx, options, ws, stats);
+  if (options == NULL) options = &(ctx->options);
+  if (ws == NULL) ws = espace_temporaire = CreeEspaceTravail();
+  if (rc == NULL) rc = recherche_temporaire = CreeRechercheCompacte();
+  InitStats(&(ws->stats));
+  STAT_DEBUT(t_total);
+
+  switch (options->heuristique){
+    case 1: res = ResoudreLargeurH1(ctx, options, ws, rc); break;
+    case 2: res = ResoudreLargeurH2(ctx, options, ws, rc); break;
+    case 3:
+      res = options->paresseuse ? ResoudreLargeurH3Paresseuse(ctx, options, ws, rc) : ResoudreLargeurH3(ctx, options, ws, rc);
+      break;
+    default: res = ResoudreLargeur(ctx, options, ws, rc, 64, options->heuristique, 0); // heuristique inconnue
+  }
+
+  STAT_FIN(&(ws->stats), ns_total, t_total);
+  if (stats != NULL){
+    *stats = ws->stats;
+    TermineStats(stats, (res != NULL) ? res->len - 1 : 0);
+  }
+  if (recherche_temporaire != NULL) TermineRechercheCompacte(recherche_temporaire);
+  if (espace_temporaire != NULL) TermineEspaceTravail(espace_temporaire);
+  return res;
+}
@@ -0,0 +1,57 @@
+/*! \file compact.h
+    \brief A* sur des noeuds compacts pour les instances d'au plus 64 villes : un état est
+           l'ensemble des villes visitées (masque de 64 bits), la dernière ville et le coût g
+*/
+#ifndef COMPACT_H
+#define COMPACT_H
+
+#include "vdc.h"
+#include "fermeture.h"
+
+/*! \def COMPACT_MAX_VILLES
+    \brief nombre maximum de villes d'une instance résolue sur noeuds compacts
+*/
+#define COMPACT_MAX_VILLES 64
+
+/*! \struct NoeudCompact
+    \brief noeud du graphe de résolution en 24 octets, au lieu d'un node et de sa liste de
+           villes ; le chemin se retrouve en remontant les parents
+*/
+typedef struct NoeudCompact {
+//! villes visitées (bit i : ville i), départ compris
+  unsigned long long masque;
+//! coût du chemin depuis le départ
+  long g;
+//! indice du noeud père dans la réserve, -1 pour la racine
+  int parent;
+//! dernière ville du chemin
+  unsigned char derniere;
+//! 1 si la clé du noeud dans la liste ouverte n'est qu'un minorant (évaluation paresseuse)
+  unsigned char provisoire;
+} NoeudCompact;
+
+/*! \struct RechercheCompacte
+    \brief réserve des noeuds, table des états connus et liste ouverte d'une recherche ;
+           les tableaux grossissent à la demande et sont réutilisés d'une recherche à l'autre
+*/
+typedef struct RechercheCompacte {
+//! noeuds créés (le parent d'un noeud est toujours avant lui)
+  NoeudCompact *noeuds;
+  int nnoeuds, maxnoeuds;
+//! table des états (adressage ouvert) : indice du meilleur noeud de chaque état, -1 si vide
+  int *table;
+//! nombre de cases de la table (puissance de 2) et d'états rangés
+  long taille_table, netats;
+//! liste ouverte : clé f (et profondeur pour départager), indice du noeud
+  TasDijkstra ouverte;
+//! distances recopiées en lignes de la largeur de la recherche (COMPACT_MAX_VILLES^2 cases)
+  long *lignes;
+//! arêtes minimum et arêtes de l'arbre de poids minimum des villes, nulles au-delà de nsom
+  long arcmin[COMPACT_MAX_VILLES], arcarbre[COMPACT_MAX_VILLES];
+} RechercheCompacte;
+
+RechercheCompacte* CreeRechercheCompacte();
+void TermineRechercheCompacte(RechercheCompacte *rc);
+pnode ResoudreCompact(ContexteSolveur *ctx, OptionsSolveur *options, EspaceTravail *ws, RechercheCompacte *rc, StatsRecherche *stats);
+
+#endif /* COMPACT_H */
@@ -0,0 +1,135 @@
+/*! \file connexite.c
+    \brief composantes connexes par union-find, sans construire la fermeture symétrique
+*/
+#include "connexite.h"
+
+/* ====================================================================== */
+/*! \fn void InitConnexite(Connexite *c)
+    \param c : une structure union-find
+    \brief initialise une structure vide (aucun tableau alloué)
+*/
+void InitConnexite(Connexite *c){
+  c->maxsom = 0;
+  c->nsom = 0;
+  c->ncomp = 0;
+  c->pere = NULL;
+  c->rang = NULL;
+}
+
+/* ====================================================================== */
+/*! \fn void TermineConnexite(Connexite *c)
+    \param c : une structure union-find
+    \brief libère les tableaux de la structure
+*/
+void TermineConnexite(Connexite *c){
+  free(c->pere);
+  free(c->rang);
+  InitConnexite(c);
+}
+
+/* ====================================================================== */
+/*! \fn void ReinitConnexite(Connexite *c, int nsom)
+    \param c : une structure union-find
+    \param nsom : nombre de sommets
+    \brief place chacun des nsom sommets dans sa propre composante.
+           Les tableaux ne sont réalloués que si nsom dépasse la taille allouée.
+*/
+void ReinitConnexite(Connexite *c, int nsom){
+  int i;
+  if (nsom > c->maxsom){
+    free(c->pere);
+    free(c->rang);
+    c->pere = (int *)malloc(nsom * sizeof(int));
+    c->rang = (int *)malloc(nsom * sizeof(int));
+    if ((c->pere == NULL) || (c->rang == NULL))
+    {   fprintf(stderr, "ReinitConnexite : malloc failed\n");
+        exit(0);
+    }
+    c->maxsom = nsom;
+  }
+  for (i = 0; i < nsom; i++){
+    c->pere[i] = i;
+    c->rang[i] = 0;
+  }
+  c->nsom = nsom;
+  c->ncomp = nsom;
+}
+
+/* ====================================================================== */
+/*! \fn int Racine(Connexite *c, int x)
+    \param c : une structure union-find
+    \param x : un sommet
+    \return le représentant de la composante de x
+    \brief recherche de la racine avec compression de chemin par division
+*/
+int Racine(Connexite *c, int x){
+  int *pere = c->pere;
+  while (pere[x] != x){
+    pere[x] = pere[pere[x]];
+    x = pere[x];
+  }
+  return x;
+}
+
+/* ====================================================================== */
+/*! \fn int Unir(Connexite *c, int x, int y)
+    \param c : une structure union-find
+    \param x : un sommet
+    \param y : un sommet
+    \return 1 si x et y étaient dans deux composantes distinctes, 0 sinon
+    \brief réunit les composantes de x et de y (union par rang)
+*/
+int Unir(Connexite *c, int x, int y){
+  x = Racine(c, x);
+  y = Racine(c, y);
+  if (x == y) return 0;
+  if (c->rang[x] < c->rang[y]) { int t = x; x = y; y = t; }
+  c->pere[y] = x;
+  if (c->rang[x] == c->rang[y]) c->rang[x]++;
+  c->ncomp--;
+  return 1;
+}
+
+/* ====================================================================== */
+/*! \fn int CalculeConnexite(Connexite *c, graphe *G)
+    \param c : une structure union-find
+    \param G : un graphe
+    \return le nombre de composantes connexes de G
+    \brief calcule les composantes connexes de G, vu comme non orienté,
+           en parcourant une seule fois les listes de successeurs
+*/
+int CalculeConnexite(Connexite *c, graphe *G){
+  int x;
+  pcell p;
+  ReinitConnexite(c, G->nsom);
+  for (x = 0; x < G->nsom; x++)
+    for (p = G->gamma[x]; p != NULL; p = p->next)
+      Unir(c, x, p->som);
+  return c->ncomp;
+}
+
+/* ====================================================================== */
+/*! \fn int EstConnexe(Connexite *c, graphe *G)
+    \param c : une structure union-find
+    \param G : un graphe
+    \return 1 si G (vu comme non orienté) est connexe, 0 sinon
+*/
+int EstConnexe(Connexite *c, graphe *G){
+  int x;
+  pcell p;
+  ReinitConnexite(c, G->nsom);
+  for (x = 0; x < G->nsom; x++)
+    for (p = G->gamma[x]; p != NULL; p = p->next)
+      if (Unir(c, x, p->som) && (c->ncomp == 1)) return 1;
+  return (c->ncomp <= 1);
+}
+
+/* ====================================================================== */
+/*! \fn int Composante(Connexite *c, int x)
+    \param c : une structure union-find
+    \param x : un sommet
+    \return l'identifiant de la composante de x (valable après CalculeConnexite)
+*/
+int Composante(Connexite *c, int x){
+  return Racine(c, x);
+}
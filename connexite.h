@@ -0,0 +1,35 @@
+/*! \file connexite.h
+    \brief composantes connexes par union-find, sans construire la fermeture symétrique
+*/
+#ifndef CONNEXITE_H
+#define CONNEXITE_H
+
+#include "graphes.h"
+
+/*! \struct Connexite
+    \brief forêt union-find sur les sommets d'un graphe (les arcs sont vus comme des arêtes).
+           Les tableaux sont alloués une fois pour maxsom sommets et réutilisés.
+*/
+typedef struct Connexite {
+//! nombre de sommets alloués
+  int maxsom;
+//! nombre de sommets courant
+  int nsom;
+//! nombre de composantes courant
+  int ncomp;
+//! père de chaque sommet dans la forêt
+  int *pere;
+//! rang (majorant de la hauteur) de chaque racine
+  int *rang;
+} Connexite;
+
+void InitConnexite(Connexite *c);
+void TermineConnexite(Connexite *c);
+void ReinitConnexite(Connexite *c, int nsom);
+int Racine(Connexite *c, int x);
+int Unir(Connexite *c, int x, int y);
+int CalculeConnexite(Connexite *c, graphe *G);
+int EstConnexe(Connexite *c, graphe *G);
+int Composante(Connexite *c, int x);
+
+#endif /* CONNEXITE_H */
@@ -0,0 +1,73 @@
+/*! \file csr.c
+    \brief représentation compacte (CSR) des successeurs d'un graphe pour les plus courts chemins
+*/
+#include "csr.h"
+
+/* ====================================================================== */
+/*! \fn GrapheCSR* CreeCSR(graphe *G, int symetrique)
+    \param G : un graphe (application gamma)
+    \param symetrique : si non nul, chaque arc (x,y) est aussi rangé comme arc (y,x),
+                        comme les routes de carte_france que get_distance lit dans les deux sens
+    \return le graphe au format CSR
+    \brief deux passes sur gamma : comptage des degrés puis rangement
+*/
+GrapheCSR* CreeCSR(graphe *G, int symetrique){
+  GrapheCSR *g;
+  int n = G->nsom, x, m = 0;
+  int *pos;
+  pcell p;
+
+  g = (GrapheCSR *)calloc(1, sizeof(GrapheCSR));
+  if (g == NULL)
+  {   fprintf(stderr, "CreeCSR : calloc failed\n");
+      exit(0);
+  }
+  g->nsom = n;
+  g->debut = (int *)calloc(n + 1, sizeof(int));
+  pos = (int *)malloc((n + 1) * sizeof(int));
+  if ((g->debut == NULL) || (pos == NULL))
+  {   fprintf(stderr, "CreeCSR : malloc failed\n");
+      exit(0);
+  }
+
+  for (x = 0; x < n; x++)
+    for (p = G->gamma[x]; p != NULL; p = p->next){
+      g->debut[x + 1]++;
+      if (symetrique) g->debut[p->som + 1]++;
+      m += symetrique ? 2 : 1;
+    }
+  for (x = 0; x < n; x++) g->debut[x + 1] += g->debut[x];
+  g->narc = m;
+
+  g->voisin = (int *)malloc(((m > 0) ? m : 1) * sizeof(int));
+  g->poids = (long *)malloc(((m > 0) ? m : 1) * sizeof(long));
+  if ((g->voisin == NULL) || (g->poids == NULL))
+  {   fprintf(stderr, "CreeCSR : malloc failed\n");
+      exit(0);
+  }
+  memcpy(pos, g->debut, (n + 1) * sizeof(int));
+  for (x = 0; x < n; x++)
+    for (p = G->gamma[x]; p != NULL; p = p->next){
+      g->voisin[pos[x]] = p->som;
+      g->poids[pos[x]++] = p->v_arc;
+      if (symetrique){
+        g->voisin[pos[p->som]] = x;
+        g->poids[pos[p->som]++] = p->v_arc;
+      }
+    }
+
+  free(pos);
+  return g;
+}
+
+/* ====================================================================== */
+/*! \fn void TermineCSR(GrapheCSR *g)
+    \param g : un graphe au format CSR
+    \brief libère le graphe
+*/
+void TermineCSR(GrapheCSR *g){
+  free(g->debut);
+  free(g->voisin);
+  free(g->poids);
+  free(g);
+}
@@ -0,0 +1,29 @@
+/*! \file csr.h
+    \brief représentation compacte (CSR) des successeurs d'un graphe pour les plus courts chemins
+*/
+#ifndef CSR_H
+#define CSR_H
+
+#include "graphes.h"
+
+/*! \struct GrapheCSR
+    \brief successeurs rangés de façon contiguë : les arcs sortant de x sont
+           voisin[debut[x] .. debut[x+1]-1], de poids poids[...]
+*/
+typedef struct GrapheCSR {
+//! nombre de sommets
+  int nsom;
+//! nombre d'arcs
+  int narc;
+//! début de la liste de chaque sommet (nsom+1 entrées)
+  int *debut;
+//! sommet final de chaque arc
+  int *voisin;
+//! poids de chaque arc
+  long *poids;
+} GrapheCSR;
+
+GrapheCSR* CreeCSR(graphe *G, int symetrique);
+void TermineCSR(GrapheCSR *g);
+
+#endif /* CSR_H */
@@ -0,0 +1,231 @@
+/*! \file espace.c
+    \brief espace de travail réutilisable pour les fonctions auxiliaires de la recherche
+*/
+#include "espace.h"
+
+/* ====================================================================== */
+/*! \fn EspaceTravail* CreeEspaceTravail()
+    \return un espace de travail vide
+    \brief alloue un espace de travail ; les tampons sont alloués au premier usage
+*/
+EspaceTravail* CreeEspaceTravail(){
+  EspaceTravail *ws = (EspaceTravail*)calloc(1, sizeof(EspaceTravail));
+  if (ws == NULL)
+  {   fprintf(stderr, "CreeEspaceTravail : calloc failed\n");
+      exit(0);
+  }
+  ws->generation = 1;
+  InitConnexite(&(ws->uf));
+  return ws;
+}
+
+/* ====================================================================== */
+/*! \fn void TermineEspaceTravail(EspaceTravail *ws)
+    \param ws : un espace de travail
+    \brief libère l'espace de travail et tous ses tampons
+*/
+void TermineEspaceTravail(EspaceTravail *ws){
+  free(ws->marque);
+  free(ws->correspondance);
+  free(ws->cle);
+  free(ws->visite);
+  free(ws->succ_villes);
+  free(ws->succ_couts);
+  free(ws->succ_estim);
+  free(ws->ordre);
+  if (ws->file) termineListeFIFO(ws->file);
+  TermineConnexite(&(ws->uf));
+  if (ws->arbre.g) TermineGraphe(ws->arbre.g);
+  free(ws);
+}
+
+/* ====================================================================== */
+/*! \fn void ReserveEspaceSommets(EspaceTravail *ws, int nsom)
+    \param ws : un espace de travail
+    \param nsom : nombre de sommets
+    \brief s'assure que les tableaux indexés par les sommets peuvent contenir nsom sommets
+*/
+void ReserveEspaceSommets(EspaceTravail *ws, int nsom){
+  if (nsom <= ws->maxsom) return;
+
+  free(ws->marque);
+  free(ws->correspondance);
+  free(ws->cle);
+  free(ws->visite);
+  free(ws->succ_villes);
+  free(ws->succ_couts);
+  free(ws->succ_estim);
+  if (ws->file) termineListeFIFO(ws->file);
+
+  ws->marque = (unsigned int*)calloc(nsom, sizeof(unsigned int));
+  ws->correspondance = (int*)malloc(nsom * sizeof(int));
+  ws->cle = (long*)malloc(nsom * sizeof(long));
+  ws->visite = (unsigned long long*)malloc(MOTS_MASQUE(nsom) * sizeof(unsigned long long));
+  ws->succ_villes = (int*)malloc((nsom + SUCCESSEURS_MARGE) * sizeof(int));
+  ws->succ_couts = (long*)malloc((nsom + SUCCESSEURS_MARGE) * sizeof(long));
+  ws->succ_estim = (long*)malloc((nsom + SUCCESSEURS_MARGE) * sizeof(long));
+  ws->file = initListeFIFO(nsom);
+  if ((ws->marque == NULL) || (ws->correspondance == NULL) || (ws->cle == NULL) || (ws->visite == NULL) ||
+      (ws->succ_villes == NULL) || (ws->succ_couts == NULL) || (ws->succ_estim == NULL))
+  {   fprintf(stderr, "ReserveEspaceSommets : malloc failed\n");
+      exit(0);
+  }
+  ws->generation = 1;
+  ws->maxsom = nsom;
+}
+
+/* ====================================================================== */
+/*! \fn unsigned int NouvelleGeneration(EspaceTravail *ws)
+    \param ws : un espace de travail
+    \return la nouvelle génération
+    \brief efface toutes les marques en temps constant (les marques ne sont
+           remises à zéro que lorsque le compteur fait le tour)
+*/
+unsigned int NouvelleGeneration(EspaceTravail *ws){
+  ws->generation++;
+  if (ws->generation == 0){
+    memset(ws->marque, 0, ws->maxsom * sizeof(unsigned int));
+    ws->generation = 1;
+  }
+  return ws->generation;
+}
+
+/* ====================================================================== */
+/*! \fn graphe* PrendTampon(TamponGraphe *t, int nsom, int nmaxarc)
+    \param t : un tampon de graphe
+    \param nsom : nombre de sommets voulu
+    \param nmaxarc : nombre maximum d'arcs voulu
+    \return un graphe vide à nsom sommets pouvant recevoir nmaxarc arcs
+    \brief vide le graphe du tampon, ou le réalloue s'il est trop petit
+*/
+graphe* PrendTampon(TamponGraphe *t, int nsom, int nmaxarc){
+  if (nmaxarc < 1) nmaxarc = 1;
+  if ((t->g == NULL) || (nsom > t->maxsom) || (nmaxarc > t->g->nmaxarc)){
+    if (t->g) TermineGraphe(t->g);
+    t->g = InitGraphe(nsom, nmaxarc);
+    t->maxsom = nsom;
+    return t->g;
+  }
+  ViderGraphe(t->g, nsom);
+  return t->g;
+}
+
+/* ====================================================================== */
+/*! \fn int explorationLargeurEspace(EspaceTravail *ws, graphe* G, int x)
+    \param ws : un espace de travail
+    \param G : graphe
+    \param x : un sommet du graphe
+    \return le nombre de sommets atteints depuis x
+    \brief exploration en largeur à partir du sommet x sur le graphe G.
+           Les sommets atteints sont ceux pour lesquels EstMarque(ws, i) est vrai,
+           jusqu'à la prochaine exploration.
+*/
+int explorationLargeurEspace(EspaceTravail *ws, graphe* G, int x){
+  ListeFIFO *E;
+  pcell p;
+  int y, z;
+  int nb = 1;
+  unsigned int gen;
+
+  ReserveEspaceSommets(ws, G->nsom);
+  gen = NouvelleGeneration(ws);
+  E = ws->file;
+  viderListeFIFO(E);
+
+  insertionListeFIFO(E, x);
+  ws->marque[x] = gen;
+  while(estNonVideListeFIFO(E)){
+    y = selectionSuppressionListeFIFO(E);
+    for(p = G->gamma[y]; p != NULL; p = p->next){
+      z = p->som;
+      if(ws->marque[z] != gen){
+        ws->marque[z] = gen;
+        insertionListeFIFO(E, z);
+        nb++;
+      }
+    }
+  }
+  return nb;
+}
+
+/* ====================================================================== */
+/*! \fn int CCEspace(EspaceTravail *ws, graphe* G, int x)
+    \param ws : un espace de travail
+    \param G : graphe
+    \param x : un sommet du graphe
+    \return le nombre de sommets de la composante connexe de x
+    \brief marque la composante connexe du graphe G contenant le sommet x.
+           Les arcs sont lus dans les deux sens par union-find : la fermeture
+           symétrique n'est pas construite.
+*/
+int CCEspace(EspaceTravail *ws, graphe* G, int x){
+  int i, r, nb = 0;
+  unsigned int gen;
+
+  ReserveEspaceSommets(ws, G->nsom);
+  CalculeConnexite(&(ws->uf), G);
+  gen = NouvelleGeneration(ws);
+  r = Composante(&(ws->uf), x);
+  for (i = 0; i < G->nsom; i++)
+    if (Composante(&(ws->uf), i) == r){
+      ws->marque[i] = gen;
+      nb++;
+    }
+  return nb;
+}
+
+/* ====================================================================== */
+/*! \fn static int compareAretes(const void *a, const void *b)
+    \brief ordre croissant des poids, puis des indices (le tri ne dépend pas de rand)
+*/
+static int compareAretes(const void *a, const void *b){
+  const AreteTriee *x = (const AreteTriee *)a, *y = (const AreteTriee *)b;
+  if (x->poids != y->poids) return (x->poids > y->poids) - (x->poids < y->poids);
+  return x->indice - y->indice;
+}
+
+/* ====================================================================== */
+/*! \fn graphe* initGraphMinEspace(EspaceTravail *ws, graphe* G, double* poidsArbreMin)
+    \param ws : un espace de travail
+    \param G : le graphe utilisé (liste d'arêtes I, T, poids)
+    \param poidsArbreMin : poids de l'arbre minimum (incrémenté)
+    \return l'arbre de poids minimum, qui appartient à l'espace de travail
+    \brief algorithme de Kruskal sans allocation : l'arbre et l'index de tri
+           utilisent les tampons de ws, les cycles sont détectés par union-find.
+           Aucun état global n'est utilisé : deux threads peuvent l'appeler en
+           même temps avec des espaces différents.
+*/
+graphe* initGraphMinEspace(EspaceTravail *ws, graphe* G, double* poidsArbreMin){
+    graphe *T;
+    int x, y;
+    int i=0, k=0;
+
+    T = PrendTampon(&(ws->arbre), G->nsom, G->nsom-1);
+
+    if (G->narc > ws->maxarc){
+        free(ws->ordre);
+        ws->ordre = (AreteTriee *)malloc(G->narc * sizeof(AreteTriee));
+        if (ws->ordre == NULL)
+        {   fprintf(stderr, "initGraphMinEspace : malloc failed\n");
+            exit(0);
+        }
+        ws->maxarc = G->narc;
+    }
+    for (i = 0; i < G->narc; i++){
+        ws->ordre[i].poids = G->poids[i];
+        ws->ordre[i].indice = i;
+    }
+    qsort(ws->ordre, G->narc, sizeof(AreteTriee), compareAretes);
+
+    ReinitConnexite(&(ws->uf), G->nsom);
+    for (i = 0; (k < (G->nsom)-1) && (i < G->narc); i++){
+        x = G->I[ws->ordre[i].indice];
+        y = G->T[ws->ordre[i].indice];
+        if(Unir(&(ws->uf), x, y)){
+            AjouteArcValue(T, x, y, ws->ordre[i].poids);
+            k++;
+            *poidsArbreMin+= ws->ordre[i].poids;
+        }
+    }
+    return T;
+}
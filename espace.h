@@ -0,0 +1,79 @@
+/*! \file espace.h
+    \brief espace de travail réutilisable pour les fonctions auxiliaires de la recherche
+*/
+#ifndef ESPACE_H
+#define ESPACE_H
+
+#include "kruskal.h"
+#include "connexite.h"
+#include "stats.h"
+#include "successeurs.h"
+
+/*! \struct TamponGraphe
+    \brief graphe réutilisé d'un appel à l'autre : il n'est réalloué que s'il est trop petit.
+*/
+typedef struct TamponGraphe {
+//! le graphe (NULL tant qu'il n'a pas servi)
+  graphe *g;
+//! nombre de sommets alloués par InitGraphe
+  int maxsom;
+} TamponGraphe;
+
+/*! \struct AreteTriee
+    \brief une arête et son poids, pour le tri de Kruskal
+*/
+typedef struct AreteTriee {
+  double poids;
+  int indice;
+} AreteTriee;
+
+/*! \struct EspaceTravail
+    \brief tampons de travail d'une recherche (un espace par thread).
+           Les tableaux grossissent à la demande puis sont réutilisés, si bien
+           qu'en régime établi les fonctions ci-dessous n'allouent plus rien.
+*/
+typedef struct EspaceTravail {
+//! nombre de sommets alloués pour les tableaux indexés par les sommets
+  int maxsom;
+//! marques de visite : le sommet i est marqué ssi marque[i] == generation
+  unsigned int *marque;
+//! génération courante des marques
+  unsigned int generation;
+//! file pour l'exploration en largeur
+  ListeFIFO *file;
+//! correspondance sommets du graphe -> sommets d'un sous-graphe, ou liste de sommets
+  int *correspondance;
+//! clés de l'algorithme de Prim (PoidsArbreMin)
+  long *cle;
+//! masque des villes visitées d'un noeud, successeurs produits par Successeurs et leur
+//! évaluation par MinorantsH1
+  unsigned long long *visite;
+  int *succ_villes;
+  long *succ_couts, *succ_estim;
+//! arêtes triées par poids (Kruskal)
+  AreteTriee *ordre;
+//! nombre d'entrées allouées pour ordre
+  int maxarc;
+//! union-find pour les composantes connexes et Kruskal
+  Connexite uf;
+//! arbre de poids minimum construit par initGraphMinEspace
+  TamponGraphe arbre;
+//! mesures de la recherche en cours
+  StatsRecherche stats;
+} EspaceTravail;
+
+/*! \def EstMarque(ws, i)
+    \brief vrai si le sommet i a été atteint par la dernière exploration de l'espace ws
+*/
+#define EstMarque(ws, i) ((ws)->marque[i] == (ws)->generation)
+
+EspaceTravail* CreeEspaceTravail();
+void TermineEspaceTravail(EspaceTravail *ws);
+void ReserveEspaceSommets(EspaceTravail *ws, int nsom);
+unsigned int NouvelleGeneration(EspaceTravail *ws);
+graphe* PrendTampon(TamponGraphe *t, int nsom, int nmaxarc);
+int explorationLargeurEspace(EspaceTravail *ws, graphe* G, int x);
+int CCEspace(EspaceTravail *ws, graphe* G, int x);
+graphe* initGraphMinEspace(EspaceTravail *ws, graphe* G, double* poidsArbreMin);
+
+#endif /* ESPACE_H */
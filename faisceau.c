@@ -0,0 +1,250 @@
+/*! \file faisceau.c
+    \brief recherche en faisceau sur le graphe de résolution : à chaque profondeur, seuls
+           les meilleurs noeuds sont développés
+
+    Resoudre (vdc.c) garde tous les noeuds ouverts : la tournée est optimale, mais le temps
+    et la mémoire explosent avec le nombre de villes. Ici la recherche descend profondeur
+    par profondeur ; les successeurs des noeuds de la couche courante sont construits et
+    évalués comme dans DevelopNode (mêmes villes permises, même ComputeH, mêmes élagages
+    que Resoudre), puis seuls les largeur successeurs de plus petit f forment la couche
+    suivante. Le travail est borné par profondeur (largeur x nsom évaluations) : la
+    recherche atteint toujours la profondeur nsom en un temps prévisible, au prix de
+    l'optimalité (une largeur infinie redonnerait une recherche exhaustive par niveaux).
+
+    Aucun noeud n'est alloué pendant la recherche : les deux couches et la table des
+    successeurs sont des tableaux de taille fixe alloués par CreeFaisceau. Les successeurs
+    du noeud b de la couche occupent les cases b * nsom .. b * nsom + nsom - 1, si bien
+    que les threads les écrivent sans se coordonner ; la sélection des meilleurs est un tri
+    partiel (SelectionRapideStochastique, temps moyen linéaire).
+
+    Le développement d'une couche et la construction de la suivante sont répartis entre
+    les threads OpenMP, chacun avec son noeud d'essai et son espace de travail.
+*/
+#include "faisceau.h"
+#include <omp.h>
+
+/* ====================================================================== */
+/*! \fn static void InitCouche(node *couche, int *villes, int largeur, int nsom)
+    \brief relie chaque noeud d'une couche à ses (nsom + 1) villes
+*/
+static void InitCouche(node *couche, int *villes, int largeur, int nsom){
+  int b;
+  for (b = 0; b < largeur; b++){
+    couche[b].listsom = villes + (long)b * (nsom + 1);
+    couche[b].next = NULL;
+  }
+}
+
+/* ====================================================================== */
+/*! \fn Faisceau* CreeFaisceau(int largeur, int nsom)
+    \param largeur : nombre maximum de noeuds gardés à chaque profondeur
+    \param nsom : nombre maximum de villes des contextes résolus
+    \return les tampons de la recherche (un noeud et un espace de travail par thread OpenMP)
+*/
+Faisceau* CreeFaisceau(int largeur, int nsom){
+  Faisceau *f = (Faisceau *)calloc(1, sizeof(Faisceau));
+  long ncand = (long)largeur * nsom;
+  int c, t;
+
+  if (f == NULL)
+  {   fprintf(stderr, "CreeFaisceau : calloc failed\n");
+      exit(0);
+  }
+  f->largeur = largeur;
+  f->nsom = nsom;
+  f->nthreads = omp_get_max_threads();
+  for (c = 0; c < 2; c++){
+    f->couche[c] = (node *)malloc(largeur * sizeof(node));
+    f->villes[c] = (int *)malloc((long)largeur * (nsom + 1) * sizeof(int));
+    if ((f->couche[c] == NULL) || (f->villes[c] == NULL))
+    {   fprintf(stderr, "CreeFaisceau : malloc failed\n");
+        exit(0);
+    }
+    InitCouche(f->couche[c], f->villes[c], largeur, nsom);
+  }
+  f->cand_parent = (int *)malloc(ncand * sizeof(int));
+  f->cand_ville = (int *)malloc(ncand * sizeof(int));
+  f->cand_g = (long *)malloc(ncand * sizeof(long));
+  f->cand_f = (long *)malloc(ncand * sizeof(long));
+  f->ordre = (int *)malloc(ncand * sizeof(int));
+  f->ncand = (int *)malloc(largeur * sizeof(int));
+  f->essai = (node *)malloc(f->nthreads * sizeof(node));
+  f->villes_essai = (int *)malloc((long)f->nthreads * (nsom + 1) * sizeof(int));
+  f->espaces = (EspaceTravail **)malloc(f->nthreads * sizeof(EspaceTravail *));
+  if ((f->cand_parent == NULL) || (f->cand_ville == NULL) || (f->cand_g == NULL) || (f->cand_f == NULL) ||
+      (f->ordre == NULL) || (f->ncand == NULL) || (f->essai == NULL) || (f->villes_essai == NULL) ||
+      (f->espaces == NULL))
+  {   fprintf(stderr, "CreeFaisceau : malloc failed\n");
+      exit(0);
+  }
+  InitCouche(f->essai, f->villes_essai, f->nthreads, nsom);
+  for (t = 0; t < f->nthreads; t++) f->espaces[t] = CreeEspaceTravail();
+  return f;
+}
+
+/* ====================================================================== */
+/*! \fn void TermineFaisceau(Faisceau *f)
+    \param f : des tampons de recherche en faisceau
+*/
+void TermineFaisceau(Faisceau *f){
+  int c, t;
+  for (c = 0; c < 2; c++){
+    free(f->couche[c]);
+    free(f->villes[c]);
+  }
+  free(f->cand_parent);
+  free(f->cand_ville);
+  free(f->cand_g);
+  free(f->cand_f);
+  free(f->ordre);
+  free(f->ncand);
+  free(f->essai);
+  free(f->villes_essai);
+  for (t = 0; t < f->nthreads; t++) TermineEspaceTravail(f->espaces[t]);
+  free(f->espaces);
+  free(f);
+}
+
+/* ====================================================================== */
+/*! \fn static void DevelopCouche(Faisceau *f, ContexteSolveur *ctx, int b, int choix, int depart)
+    \brief évalue les successeurs du noeud b de la couche courante (couche[0]) et les
+           range dans ses cases de la table des successeurs
+*/
+static void DevelopCouche(Faisceau *f, ContexteSolveur *ctx, int b, int choix, int depart){
+  int t = omp_get_thread_num(), n = ctx->nsom + 1, i, slot = b * f->nsom;
+  node *p = &(f->couche[0][b]), *essai = &(f->essai[t]);
+  EspaceTravail *ws = f->espaces[t];
+  StatsRecherche *st = &(ws->stats);
+  long distance;
+
+  f->ncand[b] = 0;
+  memcpy(essai->listsom, p->listsom, p->len * sizeof(int));
+  essai->n = n;
+  essai->len = p->len + 1;
+  for (i = 0; i < ctx->nsom; i++){
+    distance = DISTANCE(ctx, p->listsom[p->len - 1], i);
+    if (!NotInListSom(i, p) || (distance == -1)) continue;
+    STAT_AJOUTE(st, noeuds_generes, 1);
+    // retour au départ avant la fin, ou dernière ville qui n'est pas le départ (voir Resoudre)
+    if ((i == depart) != (essai->len == n)){
+      STAT_AJOUTE(st, noeuds_elagues, 1);
+      continue;
+    }
+    essai->listsom[essai->len - 1] = i;
+    essai->estim_g = p->estim_g + distance;
+    STAT_DEBUT(t_h);
+    ComputeH(essai, ctx, choix, ws);
+    STAT_FIN(st, ns_heuristique, t_h);
+    STAT_AJOUTE(st, appels_heuristique, 1);
+    f->cand_parent[slot + f->ncand[b]] = b;
+    f->cand_ville[slot + f->ncand[b]] = i;
+    f->cand_g[slot + f->ncand[b]] = essai->estim_g;
+    f->cand_f[slot + f->ncand[b]] = essai->estim_f;
+    f->ncand[b]++;
+  }
+}
+
+/* ====================================================================== */
+/*! \fn pnode ResoudreFaisceau(Faisceau *f, ContexteSolveur *ctx, OptionsSolveur *options, StatsRecherche *stats)
+    \param f : tampons de recherche (f->nsom >= ctx->nsom)
+    \param ctx : contexte de résolution, qui n'est pas modifié
+    \param options : heuristique, ville de départ et échéance (NULL : options du contexte)
+    \param stats : si non NULL, reçoit les mesures de la recherche (noeuds_developpes :
+                   noeuds des couches, ouverte_max : plus grand nombre de successeurs d'une couche)
+    \return le meilleur noeud complet de la dernière couche (à libérer par freeNode), NULL si
+            le faisceau n'a gardé aucune tournée complète ou si l'échéance est dépassée
+    \brief recherche en faisceau (voir l'en-tête du fichier) ; la tournée n'est pas forcément
+           optimale. Des threads distincts doivent utiliser des tampons distincts.
+*/
+pnode ResoudreFaisceau(Faisceau *f, ContexteSolveur *ctx, OptionsSolveur *options, StatsRecherche *stats){
+  int n = ctx->nsom + 1, taille = 1, nthreads = f->nthreads, prof, b, j, m, k, t;
+  node *echange;
+  StatsRecherche total;
+  pnode res = NULL;
+
+  if (options == NULL) options = &(ctx->options);
+  if (ctx->nsom > f->nsom){
+    fprintf(stderr, "ResoudreFaisceau : %d villes pour un faisceau de %d\n", ctx->nsom, f->nsom);
+    return NULL;
+  }
+  InitStats(&total);
+  for (t = 0; t < nthreads; t++) InitStats(&(f->espaces[t]->stats));
+  STAT_DEBUT(t_total);
+  STAT_AJOUTE(&total, octets, 2 * (long)f->largeur * TAILLE_NOEUD(f->nsom + 1) +
+              (long)f->largeur * f->nsom * (2 * sizeof(long) + 3 * sizeof(int)));
+  STAT_MAX(&total, octets_max, total.octets);
+
+  f->couche[0][0].listsom[0] = options->depart;
+  f->couche[0][0].len = 1;
+  f->couche[0][0].n = n;
+  f->couche[0][0].estim_g = 0;
+  f->couche[0][0].estim_f = 0;
+
+  for (prof = 1; (prof < n) && (taille > 0); prof++){
+    if ((options->echeance_ns != 0) && (horloge_ns() > options->echeance_ns)){
+      total.interrompue = 1;
+      taille = 0;
+      break;
+    }
+
+    STAT_DEBUT(t_dev);
+#pragma omp parallel for num_threads(nthreads) schedule(dynamic, 1)
+    for (b = 0; b < taille; b++) DevelopCouche(f, ctx, b, options->heuristique, options->depart);
+    STAT_FIN(&total, ns_developpement, t_dev);
+    STAT_AJOUTE(&total, noeuds_developpes, taille);
+
+    // les largeur meilleurs successeurs (tri partiel sur f)
+    STAT_DEBUT(t_sel);
+    for (m = 0, b = 0; b < taille; b++)
+      for (j = 0; j < f->ncand[b]; j++) f->ordre[m++] = b * f->nsom + j;
+    k = min(f->largeur, m);
+    if (m > k) SelectionRapideStochastique(f->ordre, f->cand_f, 0, m - 1, k - 1);
+    STAT_FIN(&total, ns_extraction, t_sel);
+    STAT_AJOUTE(&total, noeuds_elagues, m - k);
+    STAT_MAX(&total, ouverte_max, m);
+
+    STAT_DEBUT(t_alloc);
+#pragma omp parallel for num_threads(nthreads) schedule(static)
+    for (j = 0; j < k; j++){
+      int slot = f->ordre[j];
+      node *p = &(f->couche[0][f->cand_parent[slot]]), *q = &(f->couche[1][j]);
+      memcpy(q->listsom, p->listsom, p->len * sizeof(int));
+      q->n = n;
+      q->len = p->len + 1;
+      q->listsom[q->len - 1] = f->cand_ville[slot];
+      q->estim_g = f->cand_g[slot];
+      q->estim_f = f->cand_f[slot];
+    }
+    STAT_FIN(&total, ns_allocation, t_alloc);
+
+    echange = f->couche[0];
+    f->couche[0] = f->couche[1];
+    f->couche[1] = echange;
+    taille = k;
+  }
+
+  // chaque noeud de la dernière couche est une tournée complète
+  if (taille > 0){
+    for (j = 0, b = 1; b < taille; b++)
+      if (f->couche[0][b].estim_g < f->couche[0][j].estim_g) j = b;
+    res = AllocNode(n);
+    memcpy(res->listsom, f->couche[0][j].listsom, n * sizeof(int));
+    res->len = n;
+    res->estim_g = f->couche[0][j].estim_g;
+    res->estim_f = f->couche[0][j].estim_f;
+  }
+
+  STAT_FIN(&total, ns_total, t_total);
+  if (stats != NULL){
+    for (t = 0; t < nthreads; t++){
+      StatsRecherche *st = &(f->espaces[t]->stats);
+      total.noeuds_generes += st->noeuds_generes;
+      total.noeuds_elagues += st->noeuds_elagues;
+      total.appels_heuristique += st->appels_heuristique;
+      total.ns_heuristique += st->ns_heuristique;
+    }
+    *stats = total;
+    TermineStats(stats, (res != NULL) ? res->len - 1 : 0);
+  }
+  return res;
+}
@@ -0,0 +1,47 @@
+/*! \file faisceau.h
+    \brief recherche en faisceau sur le graphe de résolution : à chaque profondeur, seuls
+           les meilleurs noeuds sont développés
+*/
+#ifndef FAISCEAU_H
+#define FAISCEAU_H
+
+#include "vdc.h"
+
+/*! \def FAISCEAU_LARGEUR
+    \brief largeur du faisceau par défaut
+*/
+#define FAISCEAU_LARGEUR 64
+
+/*! \struct Faisceau
+    \brief tampons d'une recherche en faisceau, alloués une fois pour une largeur et un
+           nombre de villes donnés puis réutilisés d'une recherche à l'autre
+*/
+typedef struct Faisceau {
+//! nombre maximum de noeuds gardés à chaque profondeur
+  int largeur;
+//! nombre de villes des contextes acceptés
+  int nsom;
+//! noeuds de la profondeur courante et de la suivante (largeur noeuds chacune)
+  node *couche[2];
+//! villes des noeuds des deux couches, (nsom + 1) par noeud
+  int *villes[2];
+//! successeurs de la couche courante : le j-ième successeur du noeud b est à l'indice
+//! b * nsom + j ; parent, ville ajoutée, coût g et évaluation f
+  int *cand_parent, *cand_ville;
+  long *cand_g, *cand_f;
+//! nombre de successeurs de chaque noeud de la couche courante
+  int *ncand;
+//! indices des successeurs retenus, à trier partiellement sur cand_f
+  int *ordre;
+//! un noeud de travail et un espace de travail par thread
+  int nthreads;
+  node *essai;
+  int *villes_essai;
+  EspaceTravail **espaces;
+} Faisceau;
+
+Faisceau* CreeFaisceau(int largeur, int nsom);
+void TermineFaisceau(Faisceau *f);
+pnode ResoudreFaisceau(Faisceau *f, ContexteSolveur *ctx, OptionsSolveur *options, StatsRecherche *stats);
+
+#endif /* FAISCEAU_H */
@@ -0,0 +1,272 @@
+/*! \file fermeture.c
+    \brief fermeture métrique : distances de plus court chemin entre toutes les villes
+           d'une carte routière, et dépliage des tournées en chemins routiers
+
+    Sur une carte routière creuse, deux villes sans route directe ne peuvent pas se
+    suivre dans une tournée. ContexteMetrique remplace la table des distances par
+    celle des plus courts chemins (un Dijkstra par ville source, les sources étant
+    réparties entre les threads OpenMP) et garde les prédécesseurs, ce qui permet
+    de déplier chaque étape de la tournée en la suite des villes traversées.
+*/
+#include "fermeture.h"
+#include <omp.h>
+
+/* ====================================================================== */
+/* ====================================================================== */
+/* TAS BINAIRE */
+/* ====================================================================== */
+/* ====================================================================== */
+
+/* ====================================================================== */
+/*! \fn void InitTasDijkstra(TasDijkstra *t, int capacite)
+    \param t : un tas
+    \param capacite : nombre d'entrées initialement alloué (le tas grossit à la demande)
+*/
+void InitTasDijkstra(TasDijkstra *t, int capacite){
+  if (capacite < 16) capacite = 16;
+  t->n = 0;
+  t->capacite = capacite;
+  t->cle = (long *)malloc(capacite * sizeof(long));
+  t->som = (int *)malloc(capacite * sizeof(int));
+  if ((t->cle == NULL) || (t->som == NULL))
+  {   fprintf(stderr, "InitTasDijkstra : malloc failed\n");
+      exit(0);
+  }
+}
+
+/* ====================================================================== */
+/*! \fn void TermineTasDijkstra(TasDijkstra *t)
+    \param t : un tas
+*/
+void TermineTasDijkstra(TasDijkstra *t){
+  free(t->cle);
+  free(t->som);
+  t->cle = NULL;
+  t->som = NULL;
+  t->n = t->capacite = 0;
+}
+
+/* ====================================================================== */
+/*! \fn void InsereTasDijkstra(TasDijkstra *t, long cle, int som)
+    \brief ajoute l'entrée (cle, som) et la fait remonter
+*/
+void InsereTasDijkstra(TasDijkstra *t, long cle, int som){
+  int i, j;
+
+  if (t->n == t->capacite){
+    t->capacite *= 2;
+    t->cle = (long *)realloc(t->cle, t->capacite * sizeof(long));
+    t->som = (int *)realloc(t->som, t->capacite * sizeof(int));
+    if ((t->cle == NULL) || (t->som == NULL))
+    {   fprintf(stderr, "InsereTasDijkstra : realloc failed\n");
+        exit(0);
+    }
+  }
+  for (i = t->n++; i > 0; i = j){
+    j = (i - 1) / 2;
+    if (t->cle[j] <= cle) break;
+    t->cle[i] = t->cle[j];
+    t->som[i] = t->som[j];
+  }
+  t->cle[i] = cle;
+  t->som[i] = som;
+}
+
+/* ====================================================================== */
+/*! \fn int ExtraitTasDijkstra(TasDijkstra *t, long *cle)
+    \brief retire l'entrée de plus petite clé et retourne son sommet
+*/
+int ExtraitTasDijkstra(TasDijkstra *t, long *cle){
+  int som = t->som[0], i, j;
+  long c = t->cle[--t->n];
+  int s = t->som[t->n];
+
+  *cle = t->cle[0];
+  for (i = 0; (j = 2 * i + 1) < t->n; i = j){
+    if ((j + 1 < t->n) && (t->cle[j + 1] < t->cle[j])) j++;
+    if (c <= t->cle[j]) break;
+    t->cle[i] = t->cle[j];
+    t->som[i] = t->som[j];
+  }
+  t->cle[i] = c;
+  t->som[i] = s;
+  return som;
+}
+
+/* ====================================================================== */
+/* ====================================================================== */
+/* PLUS COURTS CHEMINS */
+/* ====================================================================== */
+/* ====================================================================== */
+
+/* ====================================================================== */
+/*! \fn void DijkstraSource(GrapheCSR *g, int s, long *dist, int *pred, TasDijkstra *t)
+    \param g : le graphe (poids positifs ou nuls)
+    \param s : sommet source
+    \param dist : (sortie) dist[x] = longueur d'un plus court chemin de s à x, -1 si x est inaccessible
+    \param pred : (sortie, peut être NULL) pred[x] = sommet qui précède x sur ce chemin, -1 pour s
+                  et pour les sommets inaccessibles
+    \param t : tas de travail (vidé ici)
+    \brief algorithme de Dijkstra depuis s
+*/
+void DijkstraSource(GrapheCSR *g, int s, long *dist, int *pred, TasDijkstra *t){
+  int x, y, i;
+  long d, nd;
+
+  for (x = 0; x < g->nsom; x++) dist[x] = -1;
+  if (pred != NULL) for (x = 0; x < g->nsom; x++) pred[x] = -1;
+  t->n = 0;
+  dist[s] = 0;
+  InsereTasDijkstra(t, 0, s);
+  while (t->n > 0){
+    x = ExtraitTasDijkstra(t, &d);
+    if (d != dist[x]) continue; /* entrée périmée */
+    for (i = g->debut[x]; i < g->debut[x + 1]; i++){
+      y = g->voisin[i];
+      nd = d + g->poids[i];
+      if ((dist[y] < 0) || (nd < dist[y])){
+        dist[y] = nd;
+        if (pred != NULL) pred[y] = x;
+        InsereTasDijkstra(t, nd, y);
+      }
+    }
+  }
+}
+
+/* ====================================================================== */
+/*! \fn void DistancesDijkstra(GrapheCSR *g, long *dist, int *pred)
+    \param g : le graphe
+    \param dist : (sortie) matrice nsom x nsom des distances, -1 entre sommets non reliés
+    \param pred : (sortie, peut être NULL) matrice nsom x nsom des prédécesseurs (voir DijkstraSource)
+    \brief un Dijkstra par sommet source, les sources étant réparties entre les threads OpenMP
+*/
+void DistancesDijkstra(GrapheCSR *g, long *dist, int *pred){
+  long n = g->nsom;
+#pragma omp parallel
+  {
+    TasDijkstra t;
+    int s;
+    InitTasDijkstra(&t, g->narc + 1);
+#pragma omp for schedule(dynamic, 16)
+    for (s = 0; s < n; s++)
+      DijkstraSource(g, s, dist + s * n, (pred != NULL) ? pred + s * n : NULL, &t);
+    TermineTasDijkstra(&t);
+  }
+}
+
+/* ====================================================================== */
+/*! \fn ContexteSolveur* ContexteMetrique(graphe *G, OptionsSolveur *options)
+    \param G : la carte routière (les arcs sont des routes à double sens)
+    \param options : options par défaut des résolutions (NULL : OptionsParDefaut)
+    \return un contexte dont la table des distances est la fermeture métrique de G
+    \brief un Dijkstra par ville, en parallèle ; les prédécesseurs sont conservés
+           dans ctx->pred pour DeplieTournee
+*/
+ContexteSolveur* ContexteMetrique(graphe *G, OptionsSolveur *options){
+  ContexteSolveur *ctx = AlloueContexte(G->nsom, options);
+  GrapheCSR *g = CreeCSR(G, 1);
+  long n = G->nsom;
+
+  ctx->G = G;
+  ctx->metrique = 1;
+  ctx->pred = (int *)malloc(n * n * sizeof(int));
+  if (ctx->pred == NULL)
+  {   fprintf(stderr, "ContexteMetrique : malloc failed\n");
+      exit(0);
+  }
+  DistancesDijkstra(g, ctx->dist, ctx->pred);
+
+  TermineCSR(g);
+  PrecalculeContexte(ctx);
+  return ctx;
+}
+
+/* ====================================================================== */
+/*! \fn static int EtapeSuivante(ContexteSolveur *ctx, int x, int b)
+    \param ctx : un contexte métrique sans prédécesseurs
+    \param x : ville courante
+    \param b : ville visée
+    \return une ville voisine de x par une route, sur un plus court chemin de x à b, -1 si aucune
+    \brief le voisin y de x tel que route(x,y) + dist(y,b) = dist(x,b)
+*/
+static int EtapeSuivante(ContexteSolveur *ctx, int x, int b){
+  graphe *G = ctx->G;
+  long d = DISTANCE(ctx, x, b);
+  pcell p;
+  int y;
+
+  for (p = G->gamma[x]; p != NULL; p = p->next)
+    if ((p->som != x) && (DISTANCE(ctx, p->som, b) >= 0) && (p->v_arc + DISTANCE(ctx, p->som, b) == d)) return p->som;
+  for (y = 0; y < G->nsom; y++) /* routes entrantes, lues dans l'autre sens */
+    if ((y != x) && (DISTANCE(ctx, y, b) >= 0))
+      for (p = G->gamma[y]; p != NULL; p = p->next)
+        if ((p->som == x) && (p->v_arc + DISTANCE(ctx, y, b) == d)) return y;
+  return -1;
+}
+
+/* ====================================================================== */
+/*! \fn int* DeplieTournee(ContexteSolveur *ctx, int *tournee, int len, int *longueur)
+    \param ctx : un contexte métrique (ContexteMetrique ou ContexteFloyd)
+    \param tournee : len villes de ctx (chaque étape suit un plus court chemin)
+    \param len : nombre de villes de la tournée
+    \param longueur : (sortie) nombre de villes du chemin déplié
+    \return le chemin routier : la suite de toutes les villes traversées (à libérer par l'appelant),
+            NULL si une étape n'a pas de chemin
+    \brief remplace chaque étape (a,b) par le plus court chemin de a à b, lu à rebours
+           dans la ligne a de ctx->pred ; sans prédécesseurs, le chemin est retrouvé
+           de proche en proche à partir des distances (EtapeSuivante)
+*/
+int* DeplieTournee(ContexteSolveur *ctx, int *tournee, int len, int *longueur){
+  long n = ctx->nsom;
+  int i, j, l, x, a, b, pas, total = (len > 0) ? 1 : 0;
+  int *chemin;
+
+  if (ctx->pred == NULL){ /* de proche en proche, au plus n étapes par tronçon */
+    chemin = (int *)malloc(((len > 0) ? (long)len * n : 1) * sizeof(int));
+    if (chemin == NULL)
+    {   fprintf(stderr, "DeplieTournee : malloc failed\n");
+        exit(0);
+    }
+    l = 0;
+    if (len > 0) chemin[l++] = tournee[0];
+    for (i = 0; i + 1 < len; i++)
+      for (x = tournee[i], b = tournee[i + 1], pas = 0; x != b; pas++){
+        if ((pas == n) || ((x = EtapeSuivante(ctx, x, b)) < 0)){
+          free(chemin);
+          return NULL;
+        }
+        chemin[l++] = x;
+      }
+    *longueur = l;
+    return chemin;
+  }
+
+  /* première passe : longueur du chemin déplié */
+  for (i = 0; i + 1 < len; i++){
+    a = tournee[i];
+    b = tournee[i + 1];
+    if ((a != b) && (ctx->pred[a * n + b] < 0)) return NULL;
+    for (x = b; x != a; x = ctx->pred[a * n + x]) total++;
+  }
+
+  chemin = (int *)malloc(((total > 0) ? total : 1) * sizeof(int));
+  if (chemin == NULL)
+  {   fprintf(stderr, "DeplieTournee : malloc failed\n");
+      exit(0);
+  }
+  l = 0;
+  if (len > 0) chemin[l++] = tournee[0];
+  for (i = 0; i + 1 < len; i++){
+    a = tournee[i];
+    b = tournee[i + 1];
+    j = l; /* le chemin de b à a est écrit à rebours puis retourné */
+    for (x = b; x != a; x = ctx->pred[a * n + x]) chemin[l++] = x;
+    for (x = l - 1; j < x; j++, x--){
+      int t = chemin[j];
+      chemin[j] = chemin[x];
+      chemin[x] = t;
+    }
+  }
+  *longueur = l;
+  return chemin;
+}
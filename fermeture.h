@@ -0,0 +1,35 @@
+/*! \file fermeture.h
+    \brief fermeture métrique : distances de plus court chemin entre toutes les villes
+           d'une carte routière, et dépliage des tournées en chemins routiers
+*/
+#ifndef FERMETURE_H
+#define FERMETURE_H
+
+#include "solveur.h"
+#include "csr.h"
+
+/*! \struct TasDijkstra
+    \brief tas binaire (clé, sommet) de l'algorithme de Dijkstra ; les entrées périmées
+           ne sont pas retirées mais ignorées à l'extraction
+*/
+typedef struct TasDijkstra {
+//! nombre d'entrées
+  int n;
+//! nombre d'entrées allouées
+  int capacite;
+//! clés (distances provisoires)
+  long *cle;
+//! sommets
+  int *som;
+} TasDijkstra;
+
+void InitTasDijkstra(TasDijkstra *t, int capacite);
+void TermineTasDijkstra(TasDijkstra *t);
+void InsereTasDijkstra(TasDijkstra *t, long cle, int som);
+int ExtraitTasDijkstra(TasDijkstra *t, long *cle);
+void DijkstraSource(GrapheCSR *g, int s, long *dist, int *pred, TasDijkstra *t);
+void DistancesDijkstra(GrapheCSR *g, long *dist, int *pred);
+ContexteSolveur* ContexteMetrique(graphe *G, OptionsSolveur *options);
+int* DeplieTournee(ContexteSolveur *ctx, int *tournee, int len, int *longueur);
+
+#endif /* FERMETURE_H */
@@ -0,0 +1,338 @@
+/*! \file floyd.c
+    \brief fermeture métrique par l'algorithme de Floyd-Warshall en blocs, noyau AVX2
+
+    La matrice est découpée en blocs de FLOYD_BLOC x FLOYD_BLOC. Pour chaque bloc
+    pivot kb, trois phases :
+      1. le bloc diagonal (kb,kb) est fermé sur lui-même ;
+      2. les blocs de la ligne kb et de la colonne kb sont mis à jour à partir du bloc diagonal ;
+      3. tous les autres blocs (ib,jb) sont mis à jour à partir de (ib,kb) et (kb,jb).
+    Les blocs d'une même phase sont indépendants et répartis entre les threads OpenMP.
+    Le noyau C = min(C, A + B) est écrit en AVX2 (8 entiers par instruction) et choisi
+    à l'exécution si le processeur le permet, sinon la version scalaire est utilisée.
+
+    Usage du banc d'essai : AEtoile.exe bench-fermeture [options]
+      --tailles 256,512    nombres de sommets (défaut : 256,512,1024)
+      --densites 0.01,0.5  fractions des arêtes possibles présentes (défaut : 0.005,0.05,0.5)
+      --graine s           graine des graphes (défaut : 1)
+      --repetitions r      mesures par graphe (défaut : 3)
+      --csv fichier        résultats en CSV ("-" pour la sortie standard)
+*/
+#include "floyd.h"
+#include "bench.h"
+#include <omp.h>
+#include <immintrin.h>
+
+/* ====================================================================== */
+/*! \fn int DistancesTiennentFloyd(graphe *G)
+    \param G : un graphe
+    \return 1 si tout plus court chemin de G est sûrement inférieur à FLOYD_INFINI
+    \brief majore le plus long plus court chemin par la somme des arcs et par
+           l'arc maximum fois (nsom - 1), le plus petit des deux
+*/
+int DistancesTiennentFloyd(graphe *G){
+  long long somme = 0, maximum = 0, borne;
+  int x;
+  pcell p;
+
+  for (x = 0; x < G->nsom; x++)
+    for (p = G->gamma[x]; p != NULL; p = p->next){
+      if (p->v_arc >= FLOYD_INFINI) return 0;
+      somme += (long long)p->v_arc;
+      if (p->v_arc > maximum) maximum = (long long)p->v_arc;
+    }
+  borne = maximum * (G->nsom > 1 ? G->nsom - 1 : 1);
+  if (somme < borne) borne = somme;
+  return borne < FLOYD_INFINI;
+}
+
+/* ====================================================================== */
+/*! \fn MatriceDistances* MatriceDepuisGraphe(graphe *G)
+    \param G : un graphe (les arcs sont lus dans les deux sens)
+    \return la matrice des routes directes : 0 sur la diagonale, le plus petit arc
+            entre deux sommets reliés, FLOYD_INFINI ailleurs ; arrête le programme si
+            les distances peuvent ne pas tenir dans la matrice (voir DistancesTiennentFloyd)
+*/
+MatriceDistances* MatriceDepuisGraphe(graphe *G){
+  MatriceDistances *m;
+  long i, np;
+  int x;
+  pcell p;
+
+  if (!DistancesTiennentFloyd(G))
+  {   fprintf(stderr, "MatriceDepuisGraphe : distances trop grandes pour la matrice 32 bits\n");
+      exit(0);
+  }
+  m = (MatriceDistances *)malloc(sizeof(MatriceDistances));
+  if (m == NULL)
+  {   fprintf(stderr, "MatriceDepuisGraphe : malloc failed\n");
+      exit(0);
+  }
+  m->n = G->nsom;
+  m->np = np = ((G->nsom + FLOYD_BLOC - 1) / FLOYD_BLOC) * FLOYD_BLOC;
+  if (np == 0) np = m->np = FLOYD_BLOC;
+  if (posix_memalign((void **)&(m->d), 64, np * np * sizeof(int)) != 0)
+  {   fprintf(stderr, "MatriceDepuisGraphe : malloc failed\n");
+      exit(0);
+  }
+  for (i = 0; i < np * np; i++) m->d[i] = FLOYD_INFINI;
+  for (i = 0; i < np; i++) m->d[i * np + i] = 0;
+  for (x = 0; x < G->nsom; x++)
+    for (p = G->gamma[x]; p != NULL; p = p->next){
+      int v = (int)p->v_arc;
+      if (v < m->d[x * np + p->som]) m->d[x * np + p->som] = v;
+      if (v < m->d[p->som * np + x]) m->d[p->som * np + x] = v;
+    }
+  return m;
+}
+
+/* ====================================================================== */
+/*! \fn void TermineMatriceDistances(MatriceDistances *m)
+    \param m : une matrice
+*/
+void TermineMatriceDistances(MatriceDistances *m){
+  free(m->d);
+  free(m);
+}
+
+/* ====================================================================== */
+/*! \fn static void NoyauScalaire(int *C, const int *A, const int *B, int np)
+    \param C : bloc mis à jour (peut être A ou B)
+    \param A : bloc (i,k)
+    \param B : bloc (k,j)
+    \param np : longueur des lignes de la matrice
+    \brief C[i][j] = min(C[i][j], A[i][k] + B[k][j]) pour k croissant
+*/
+static void NoyauScalaire(int *C, const int *A, const int *B, int np){
+  int i, j, k;
+  for (k = 0; k < FLOYD_BLOC; k++)
+    for (i = 0; i < FLOYD_BLOC; i++){
+      int a = A[i * np + k];
+      int *c = C + i * np;
+      const int *b = B + k * np;
+      for (j = 0; j < FLOYD_BLOC; j++)
+        if (a + b[j] < c[j]) c[j] = a + b[j];
+    }
+}
+
+/* ====================================================================== */
+/*! \fn static void NoyauAVX2(int *C, const int *A, const int *B, int np)
+    \brief même calcul que NoyauScalaire, huit colonnes à la fois
+*/
+__attribute__((target("avx2")))
+static void NoyauAVX2(int *C, const int *A, const int *B, int np){
+  int i, j, k;
+  for (k = 0; k < FLOYD_BLOC; k++)
+    for (i = 0; i < FLOYD_BLOC; i++){
+      __m256i a = _mm256_set1_epi32(A[i * np + k]);
+      int *c = C + i * np;
+      const int *b = B + k * np;
+      for (j = 0; j < FLOYD_BLOC; j += 8){
+        __m256i v = _mm256_load_si256((const __m256i *)(c + j));
+        __m256i w = _mm256_add_epi32(a, _mm256_load_si256((const __m256i *)(b + j)));
+        _mm256_store_si256((__m256i *)(c + j), _mm256_min_epi32(v, w));
+      }
+    }
+}
+
+/* ====================================================================== */
+/*! \fn int FloydAVX2Disponible()
+    \return 1 si le processeur exécute les instructions AVX2
+*/
+int FloydAVX2Disponible(){
+  return __builtin_cpu_supports("avx2") ? 1 : 0;
+}
+
+/* ====================================================================== */
+/*! \fn void FloydWarshallBloc(MatriceDistances *m, int simd)
+    \param m : matrice des routes directes (voir MatriceDepuisGraphe), remplacée par les distances
+    \param simd : si non nul, le noyau AVX2 est utilisé quand le processeur le permet
+    \brief Floyd-Warshall en blocs, phases parallélisées par OpenMP (voir l'en-tête du fichier)
+*/
+void FloydWarshallBloc(MatriceDistances *m, int simd){
+  void (*noyau)(int *, const int *, const int *, int) =
+    (simd && FloydAVX2Disponible()) ? NoyauAVX2 : NoyauScalaire;
+  int np = m->np, nb = np / FLOYD_BLOC, kb;
+  int *d = m->d;
+
+#define BLOC(ib, jb) (d + (long)(ib) * FLOYD_BLOC * np + (long)(jb) * FLOYD_BLOC)
+  for (kb = 0; kb < nb; kb++){
+    int ib, jb;
+    noyau(BLOC(kb, kb), BLOC(kb, kb), BLOC(kb, kb), np);
+
+#pragma omp parallel for schedule(static)
+    for (ib = 0; ib < nb; ib++)
+      if (ib != kb){
+        noyau(BLOC(ib, kb), BLOC(ib, kb), BLOC(kb, kb), np);
+        noyau(BLOC(kb, ib), BLOC(kb, kb), BLOC(kb, ib), np);
+      }
+
+#pragma omp parallel for collapse(2) schedule(static)
+    for (ib = 0; ib < nb; ib++)
+      for (jb = 0; jb < nb; jb++)
+        if ((ib != kb) && (jb != kb))
+          noyau(BLOC(ib, jb), BLOC(ib, kb), BLOC(kb, jb), np);
+  }
+#undef BLOC
+}
+
+/* ====================================================================== */
+/*! \fn ContexteSolveur* ContexteFloyd(graphe *G, OptionsSolveur *options)
+    \param G : la carte routière (les arcs sont des routes à double sens)
+    \param options : options par défaut des résolutions (NULL : OptionsParDefaut)
+    \return un contexte dont la table des distances est la fermeture métrique de G
+    \brief variante de ContexteMetrique pour les graphes denses ; les prédécesseurs
+           ne sont pas conservés, DeplieTournee retrouve les chemins à partir des distances.
+           Si les distances peuvent dépasser la matrice 32 bits, ContexteMetrique les calcule.
+*/
+ContexteSolveur* ContexteFloyd(graphe *G, OptionsSolveur *options){
+  ContexteSolveur *ctx;
+  MatriceDistances *m;
+  int a, b;
+
+  if (!DistancesTiennentFloyd(G)){
+    fprintf(stderr, "ContexteFloyd : distances trop grandes pour Floyd-Warshall 32 bits, fermeture par Dijkstra\n");
+    return ContexteMetrique(G, options);
+  }
+  ctx = AlloueContexte(G->nsom, options);
+  m = MatriceDepuisGraphe(G);
+
+  FloydWarshallBloc(m, 1);
+  ctx->G = G;
+  ctx->metrique = 1;
+  for (a = 0; a < m->n; a++)
+    for (b = 0; b < m->n; b++){
+      int v = m->d[(long)a * m->np + b];
+      DISTANCE(ctx, a, b) = (v >= FLOYD_INFINI) ? -1 : v;
+    }
+  TermineMatriceDistances(m);
+  PrecalculeContexte(ctx);
+  return ctx;
+}
+
+/* ====================================================================== */
+/* ====================================================================== */
+/* BANC D'ESSAI */
+/* ====================================================================== */
+/* ====================================================================== */
+
+/* ====================================================================== */
+/*! \fn static int LitListeDoubles(char *s, double *t, int max)
+    \brief lit une liste "a,b,c" de réels ; retourne le nombre de valeurs lues
+*/
+static int LitListeDoubles(char *s, double *t, int max){
+  int n = 0;
+  char *fin;
+  while ((n < max) && (*s != '\0')){
+    t[n++] = strtod(s, &fin);
+    if (*fin != ',') break;
+    s = fin + 1;
+  }
+  return n;
+}
+
+/* ====================================================================== */
+/*! \fn static int CompareDistances(MatriceDistances *m, long *dist)
+    \return 1 si la matrice m et la table dist (-1 = pas de chemin) ont les mêmes distances
+*/
+static int CompareDistances(MatriceDistances *m, long *dist){
+  long a, b, n = m->n;
+  for (a = 0; a < n; a++)
+    for (b = 0; b < n; b++){
+      int v = m->d[a * m->np + b];
+      if (((v >= FLOYD_INFINI) ? -1 : v) != dist[a * n + b]) return 0;
+    }
+  return 1;
+}
+
+/* ====================================================================== */
+/*! \fn int ModeBenchFermeture(int argc, char **argv)
+    \param argc : nombre d'arguments (après "bench-fermeture")
+    \param argv : arguments (après "bench-fermeture")
+    \return 0 si les trois méthodes donnent les mêmes distances, 1 sinon
+    \brief compare Dijkstra répété, Floyd-Warshall en blocs scalaire et AVX2 sur des
+           graphes aléatoires connexes de plusieurs tailles et densités
+*/
+int ModeBenchFermeture(int argc, char **argv){
+  double tailles[16] = {256, 512, 1024}, densites[16] = {0.005, 0.05, 0.5};
+  int ntailles = 3, ndensites = 3, repetitions = 3, i, it, id, r, ok = 1;
+  unsigned long long graine = 1;
+  char *nomcsv = NULL;
+  FILE *csv = NULL;
+
+  for (i = 0; i < argc; i++){
+    if (!strcmp(argv[i], "--tailles") && (i + 1 < argc)) ntailles = LitListeDoubles(argv[++i], tailles, 16);
+    else if (!strcmp(argv[i], "--densites") && (i + 1 < argc)) ndensites = LitListeDoubles(argv[++i], densites, 16);
+    else if (!strcmp(argv[i], "--graine") && (i + 1 < argc)) graine = strtoull(argv[++i], NULL, 10);
+    else if (!strcmp(argv[i], "--repetitions") && (i + 1 < argc)) repetitions = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--csv") && (i + 1 < argc)) nomcsv = argv[++i];
+    else {
+      fprintf(stderr, "bench-fermeture : argument inconnu %s\n", argv[i]);
+      return 1;
+    }
+  }
+  if (repetitions < 1) repetitions = 1;
+  if (nomcsv != NULL){
+    csv = strcmp(nomcsv, "-") ? fopen(nomcsv, "w") : stdout;
+    if (csv == NULL){
+      fprintf(stderr, "bench-fermeture : impossible d'ouvrir %s\n", nomcsv);
+      return 1;
+    }
+    fprintf(csv, "methode,nsom,narc,densite,threads,mediane_ms,min_ms\n");
+  }
+
+  fprintf(stderr, "bench-fermeture : %d threads, AVX2 %s\n", omp_get_max_threads(),
+          FloydAVX2Disponible() ? "disponible" : "absent");
+  for (it = 0; it < ntailles; it++)
+    for (id = 0; id < ndensites; id++){
+      int n = (int)tailles[it];
+      long possibles = (long)n * (n - 1) / 2;
+      long narc = (long)(densites[id] * possibles);
+      if (narc < n - 1) narc = n - 1;
+      if (narc > possibles) narc = possibles;
+      graphe *G = GrapheAleatoireConnexe(n, (int)narc, graine + it * 1000003ULL + id, 1);
+      long *dist = (long *)malloc((long)n * n * sizeof(long));
+      double t[3][64];
+      const char *noms[3] = {"dijkstra", "floyd-scalaire", "floyd-avx2"};
+      int methodes = FloydAVX2Disponible() ? 3 : 2, meth;
+      if (dist == NULL)
+      {   fprintf(stderr, "ModeBenchFermeture : malloc failed\n");
+          exit(0);
+      }
+      if (repetitions > 64) repetitions = 64;
+
+      for (r = 0; r < repetitions; r++){
+        long long t0 = horloge_ns();
+        GrapheCSR *g = CreeCSR(G, 1);
+        DistancesDijkstra(g, dist, NULL);
+        TermineCSR(g);
+        t[0][r] = (horloge_ns() - t0) / 1e6;
+
+        for (meth = 1; meth < methodes; meth++){
+          t0 = horloge_ns();
+          MatriceDistances *m = MatriceDepuisGraphe(G);
+          FloydWarshallBloc(m, meth == 2);
+          t[meth][r] = (horloge_ns() - t0) / 1e6;
+          if (!CompareDistances(m, dist)){
+            fprintf(stderr, "bench-fermeture : %s diffère de dijkstra (n=%d, m=%ld)\n", noms[meth], n, narc);
+            ok = 0;
+          }
+          TermineMatriceDistances(m);
+        }
+      }
+
+      for (meth = 0; meth < methodes; meth++){
+        MesureBench mb;
+        StatistiquesBench(t[meth], repetitions, &mb);
+        printf("%-15s n=%5d m=%8ld (densite %.3f) : mediane %10.2f ms  min %10.2f ms\n",
+               noms[meth], n, narc, densites[id], mb.mediane, mb.minimum);
+        if (csv != NULL)
+          fprintf(csv, "%s,%d,%ld,%g,%d,%.3f,%.3f\n", noms[meth], n, narc, densites[id],
+                  omp_get_max_threads(), mb.mediane, mb.minimum);
+      }
+      free(dist);
+      TermineGraphe(G);
+    }
+
+  if ((csv != NULL) && (csv != stdout)) fclose(csv);
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,39 @@
+/*! \file floyd.h
+    \brief fermeture métrique par l'algorithme de Floyd-Warshall en blocs, noyau AVX2
+*/
+#ifndef FLOYD_H
+#define FLOYD_H
+
+#include "fermeture.h"
+
+/*! \def FLOYD_BLOC
+    \brief côté des blocs (en sommets) : trois blocs de FLOYD_BLOC^2 entiers tiennent dans le cache L2
+*/
+#define FLOYD_BLOC 64
+
+/*! \def FLOYD_INFINI
+    \brief distance entre sommets non reliés ; la somme de deux infinis tient dans un entier 32 bits
+*/
+#define FLOYD_INFINI 0x3fffffff
+
+/*! \struct MatriceDistances
+    \brief matrice des distances contiguë, lignes de np entiers (np multiple de FLOYD_BLOC)
+*/
+typedef struct MatriceDistances {
+//! nombre de sommets
+  int n;
+//! nombre de sommets arrondi au multiple de FLOYD_BLOC supérieur
+  int np;
+//! d[i*np+j] : distance de i à j, FLOYD_INFINI si inconnue
+  int *d;
+} MatriceDistances;
+
+int DistancesTiennentFloyd(graphe *G);
+MatriceDistances* MatriceDepuisGraphe(graphe *G);
+void TermineMatriceDistances(MatriceDistances *m);
+int FloydAVX2Disponible();
+void FloydWarshallBloc(MatriceDistances *m, int simd);
+ContexteSolveur* ContexteFloyd(graphe *G, OptionsSolveur *options);
+int ModeBenchFermeture(int argc, char **argv);
+
+#endif /* FLOYD_H */
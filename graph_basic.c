@@ -156,8 +156,8 @@ graphe * InitGraphe(int nsom, int nmaxarc)
       exit(0);
   }
 
-  g->x = (double *)malloc(nsom * sizeof(double));
-  g->y = (double *)malloc(nsom * sizeof(double));
+  g->x = (double *)calloc(nsom, sizeof(double)); /* sommets sans "coord sommets" : origine */
+  g->y = (double *)calloc(nsom, sizeof(double));
   if ((g->x == NULL) || (g->y == NULL))
   {   fprintf(stderr, "InitGraphe : malloc failed\n");
       exit(0);
@@ -213,6 +213,24 @@ void TermineGraphe(graphe * g)
   free(g);
 } /* TermineGraphe() */
 
+/* ====================================================================== */
+/*! \fn void ViderGraphe(graphe * g, int nsom)
+    \param g (entrée/sortie) : un graphe.
+    \param nsom (entrée) : nouveau nombre de sommets.
+    \brief retire tous les arcs du graphe g (les cellules retournent dans la liste libre)
+           et fixe son nombre de sommets a 'nsom', sans liberer ni allouer de memoire.
+    \warning 'nsom' ne doit pas depasser le nombre de sommets alloues par InitGraphe.
+*/
+void ViderGraphe(graphe * g, int nsom)
+/* ====================================================================== */
+{
+  int i;
+  for (i = 0; i < g->nsom; i++)
+    while (g->gamma[i] != NULL) RetireTete(&(g->libre), &(g->gamma[i]));
+  g->nsom = nsom;
+  g->narc = 0;
+} /* ViderGraphe() */
+
 
 /* ====================================================================== */
 /* ====================================================================== */
@@ -566,3 +584,266 @@ graphe * GrapheAleatoire(int nsom, int narc, int code)
 
   return g;
 } /* GrapheAleatoire() */
+
+/* ====================================================================== */
+/*! \fn static int InsereArete(unsigned long long *table, unsigned long long masque, int i, int j)
+    \param table (entrée/sortie) : table de hachage à adressage ouvert (0 = case vide).
+    \param masque (entrée) : taille de la table moins un (puissance de 2 moins un).
+    \param i (entrée) : un sommet.
+    \param j (entrée) : un sommet.
+    \return 1 si l'arête {i,j} a été ajoutée, 0 si elle était déjà présente.
+*/
+static int InsereArete(unsigned long long *table, unsigned long long masque, int i, int j)
+/* ====================================================================== */
+{
+  unsigned long long cle, h;
+  if (i > j) { int t = i; i = j; j = t; }
+  cle = (((unsigned long long)i << 32) | (unsigned long long)j) + 1;
+  h = (cle * 0x9E3779B97F4A7C15ULL) >> 20;
+  for (;;)
+  {
+    h &= masque;
+    if (table[h] == cle) return 0;
+    if (table[h] == 0) { table[h] = cle; return 1; }
+    h++;
+  }
+} /* InsereArete() */
+
+/* ====================================================================== */
+/*! \fn static void AjouteAreteGeneree(graphe * g, int i, int j, Alea *a, int euclidien)
+    \param g (entrée/sortie) : un graphe.
+    \param i (entrée) : extrémité initiale.
+    \param j (entrée) : extrémité finale.
+    \param a (entrée/sortie) : générateur pseudo-aléatoire.
+    \param euclidien (entrée) : si non nul, le poids est la distance euclidienne arrondie au supérieur.
+    \brief ajoute l'arc (i,j) au graphe g, dans gamma et dans les listes d'arêtes.
+*/
+static void AjouteAreteGeneree(graphe * g, int i, int j, Alea *a, int euclidien)
+/* ====================================================================== */
+{
+  TYP_VARC v;
+  int m = g->narc;
+  if (euclidien)
+  {
+    double dx = g->x[i] - g->x[j], dy = g->y[i] - g->y[j];
+    v = (TYP_VARC)ceil(sqrt(dx * dx + dy * dy));
+    if (v < 1) v = 1;
+  }
+  else
+    v = 1 + AleaEntier(a, 1000);
+  g->I[m] = g->tete[m] = i;
+  g->T[m] = g->queue[m] = j;
+  g->v_arcs[m] = v;
+  g->poids[m] = (double)v;
+  AjouteArcValue(g, i, j, v);
+} /* AjouteAreteGeneree() */
+
+/* ====================================================================== */
+/*! \fn graphe * GrapheAleatoireConnexe(int nsom, int narc, unsigned long long graine, int euclidien)
+    \param nsom (entrée) : nombre de sommets.
+    \param narc (entrée) : nombre d'arcs, entre nsom-1 et nsom (nsom - 1) / 2.
+    \param graine (entrée) : graine du générateur pseudo-aléatoire.
+    \param euclidien (entrée) : si non nul, les sommets sont placés au hasard dans un
+              carré (champs x, y) et les arcs sont pondérés par la distance euclidienne
+              arrondie au supérieur ; sinon les poids sont tirés dans [1, 1000].
+    \return un graphe.
+    \brief retourne un graphe aléatoire connexe, antisymétrique et sans boucle.
+              La connexité est garantie par construction : un arbre couvrant aléatoire
+              (chaque sommet, pris dans un ordre aléatoire, est relié à un sommet déjà placé),
+              complété par des arêtes tirées sans remise grâce à une table de hachage.
+              Le coût est linéaire en narc ; une même graine donne toujours le même graphe.
+*/
+graphe * GrapheAleatoireConnexe(int nsom, int narc, unsigned long long graine, int euclidien)
+/* ====================================================================== */
+{
+  graphe * g;
+  Alea a;
+  int i, j, k, *perm;
+  double mmax = ((double)nsom * ((double)nsom - 1)) / 2;
+  double cote = 100.0 * sqrt((double)nsom);
+
+  if ((narc < nsom - 1) || (narc > mmax))
+  {
+    fprintf(stderr, "GrapheAleatoireConnexe : il faut entre %d et %g arcs pour %d sommets\n",
+                     nsom - 1, mmax, nsom);
+    exit(0);
+  }
+
+  InitAlea(&a, graine);
+  g = InitGraphe(nsom, (narc > 0) ? narc : 1);
+  for (i = 0; i < nsom; i++)
+  {
+    g->x[i] = euclidien ? cote * AleaReel(&a) : 0.0;
+    g->y[i] = euclidien ? cote * AleaReel(&a) : 0.0;
+    g->v_sommets[i] = 0;
+  }
+
+  perm = (int *)malloc(nsom * sizeof(int));
+  if (perm == NULL)
+  {   fprintf(stderr, "GrapheAleatoireConnexe : malloc failed\n");
+      exit(0);
+  }
+  for (i = 0; i < nsom; i++) perm[i] = i;
+  for (i = nsom - 1; i > 0; i--)
+  {
+    j = AleaEntier(&a, i + 1);
+    k = perm[i]; perm[i] = perm[j]; perm[j] = k;
+  }
+
+  if (narc > mmax / 2)
+  { /* graphe dense : tirage sans remise parmi toutes les paires hors de l'arbre */
+    int npaires = (int)mmax;
+    int *paires = (int *)malloc(npaires * sizeof(int));
+    char *arbre = (char *)calloc(npaires, sizeof(char));
+    if ((paires == NULL) || (arbre == NULL))
+    {   fprintf(stderr, "GrapheAleatoireConnexe : malloc failed\n");
+        exit(0);
+    }
+#define INDICE_PAIRE(u,v) ((long long)(v) * ((v) - 1) / 2 + (u)) /* u < v */
+    for (k = 1; k < nsom; k++)
+    {
+      i = perm[k]; j = perm[AleaEntier(&a, k)];
+      AjouteAreteGeneree(g, i, j, &a, euclidien);
+      arbre[INDICE_PAIRE(min(i,j), max(i,j))] = 1;
+    }
+    {
+      int np = 0, u, v;
+      for (v = 1; v < nsom; v++)
+        for (u = 0; u < v; u++)
+          if (!arbre[INDICE_PAIRE(u,v)]) paires[np++] = (int)INDICE_PAIRE(u,v);
+      for (k = 0; g->narc < narc; k++)
+      { /* melange de Fisher-Yates partiel, puis decodage de l'indice de paire */
+        int r = k + AleaEntier(&a, np - k);
+        long long p = paires[r]; paires[r] = paires[k]; paires[k] = (int)p;
+        v = (int)((1 + sqrt(1.0 + 8.0 * (double)p)) / 2);
+        while ((long long)v * (v - 1) / 2 > p) v--;
+        while ((long long)(v + 1) * v / 2 <= p) v++;
+        u = (int)(p - (long long)v * (v - 1) / 2);
+        if (AleaSuivant(&a) & 1) AjouteAreteGeneree(g, u, v, &a, euclidien);
+        else AjouteAreteGeneree(g, v, u, &a, euclidien);
+      }
+    }
+#undef INDICE_PAIRE
+    free(paires);
+    free(arbre);
+  }
+  else
+  { /* graphe peu dense : rejet des doublons par table de hachage */
+    unsigned long long taille = 16, *table;
+    while (taille < 2 * (unsigned long long)narc) taille <<= 1;
+    table = (unsigned long long *)calloc(taille, sizeof(unsigned long long));
+    if (table == NULL)
+    {   fprintf(stderr, "GrapheAleatoireConnexe : calloc failed\n");
+        exit(0);
+    }
+    for (k = 1; k < nsom; k++)
+    {
+      i = perm[k]; j = perm[AleaEntier(&a, k)];
+      InsereArete(table, taille - 1, i, j);
+      AjouteAreteGeneree(g, i, j, &a, euclidien);
+    }
+    while (g->narc < narc)
+    {
+      i = AleaEntier(&a, nsom);
+      j = AleaEntier(&a, nsom);
+      if ((i != j) && InsereArete(table, taille - 1, i, j))
+        AjouteAreteGeneree(g, i, j, &a, euclidien);
+    }
+    free(table);
+  }
+
+  free(perm);
+  return g;
+} /* GrapheAleatoireConnexe() */
+
+/* ====================================================================== */
+/*! \fn static void AjouteRoute(graphe * g, int i, int j, Alea *a)
+    \param g (entrée/sortie) : un graphe.
+    \param i (entrée) : extrémité initiale.
+    \param j (entrée) : extrémité finale.
+    \param a (entrée/sortie) : générateur pseudo-aléatoire.
+    \brief ajoute l'arc (i,j), de poids la distance euclidienne majorée de 0 à 60 %
+              (routes plus ou moins rapides), arrondie au supérieur.
+*/
+static void AjouteRoute(graphe * g, int i, int j, Alea *a)
+/* ====================================================================== */
+{
+  double dx = g->x[i] - g->x[j], dy = g->y[i] - g->y[j];
+  TYP_VARC v = (TYP_VARC)ceil(sqrt(dx * dx + dy * dy) * (1.0 + 0.6 * AleaReel(a)));
+  int m = g->narc;
+  if (v < 1) v = 1;
+  g->I[m] = g->tete[m] = i;
+  g->T[m] = g->queue[m] = j;
+  g->v_arcs[m] = v;
+  g->poids[m] = (double)v;
+  AjouteArcValue(g, i, j, v);
+} /* AjouteRoute() */
+
+/* ====================================================================== */
+/*! \fn graphe * GrapheRoutierAleatoire(int nsom, unsigned long long graine)
+    \param nsom (entrée) : nombre de sommets.
+    \param graine (entrée) : graine du générateur pseudo-aléatoire.
+    \return un graphe.
+    \brief retourne une carte routière synthétique connexe : les sommets sont placés
+              sur une grille de côté ceil(sqrt(nsom)) avec un décalage aléatoire (champs x, y),
+              chaque sommet est relié à son voisin de droite, à son voisin du dessous
+              avec une probabilité 0.6 (toujours dans la première colonne, ce qui assure
+              la connexité) et en diagonale avec une probabilité 0.15. Contrairement à
+              GrapheAleatoireConnexe, les arcs sont courts, comme sur une vraie carte.
+*/
+graphe * GrapheRoutierAleatoire(int nsom, unsigned long long graine)
+/* ====================================================================== */
+{
+  graphe * g;
+  Alea a;
+  int c = (int)ceil(sqrt((double)nsom)), i;
+
+  InitAlea(&a, graine);
+  g = InitGraphe(nsom, 3 * nsom + 1);
+  for (i = 0; i < nsom; i++)
+  {
+    g->x[i] = 100.0 * ((i % c) + 0.1 + 0.8 * AleaReel(&a));
+    g->y[i] = 100.0 * ((i / c) + 0.1 + 0.8 * AleaReel(&a));
+    g->v_sommets[i] = 0;
+  }
+  for (i = 0; i < nsom; i++)
+  {
+    if ((i % c != c - 1) && (i + 1 < nsom)) AjouteRoute(g, i, i + 1, &a);
+    if ((i + c < nsom) && ((i % c == 0) || (AleaReel(&a) < 0.6))) AjouteRoute(g, i, i + c, &a);
+    if ((i % c != c - 1) && (i + c + 1 < nsom) && (AleaReel(&a) < 0.15)) AjouteRoute(g, i, i + c + 1, &a);
+  }
+  return g;
+} /* GrapheRoutierAleatoire() */
+
+/* ====================================================================== */
+/* ====================================================================== */
+/* OPERATEURS DE BASE SUR LES GRAPHES */
+/* ====================================================================== */
+/* ====================================================================== */
+
+/* ====================================================================== */
+/*! \fn graphe * Symetrique(graphe * g)
+    \param g (entrée) : un graphe.
+    \return un graphe.
+    \brief construit et retourne le graphe g_1 symétrique de g (chaque arc (i,j) de valeur v
+              devient l'arc (j,i) de même valeur), en temps linéaire. Les coordonnées
+              des sommets sont recopiées.
+    \warning seule la représentation 'gamma' est utilisée.
+*/
+graphe * Symetrique(graphe * g)
+/* ====================================================================== */
+{
+  graphe * g_1;
+  int nsom = g->nsom, i;
+  pcell p;
+
+  g_1 = InitGraphe(nsom, (g->narc > 0) ? g->narc : 1);
+  for (i = 0; i < nsom; i++)
+  {
+    g_1->x[i] = g->x[i];
+    g_1->y[i] = g->y[i];
+    for (p = g->gamma[i]; p != NULL; p = p->next)
+      AjouteArcValue(g_1, p->som, i, p->v_arc);
+  }
+  return g_1;
+} /* Symetrique() */
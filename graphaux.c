@@ -217,6 +217,28 @@ void TriRapideStochastique (int * A, TypeCle *T, int p, int r)
   }
 } /* TriRapideStochastique() */
 
+/* =============================================================== */
+/*! \fn void SelectionRapideStochastique (int * A, TypeCle *T, int p, int r, int k)
+    \param A (entrée/sortie) : un tableau d'entiers
+    \param T (entrée) : un tableau de valeurs de type TypeCle.
+    \param p (entrée) : indice du début de la zone.
+    \param r (entrée) : indice de fin de la zone.
+    \param k (entrée) : un indice de la zone.
+    \brief sélection (tri partiel) : range dans \b A[p..k] des index dont les valeurs ne
+           dépassent aucune de celles des index de \b A[k+1..r], sans trier ces deux
+           parties ; temps moyen linéaire.
+*/
+void SelectionRapideStochastique (int * A, TypeCle *T, int p, int r, int k)
+/* =============================================================== */
+{
+  int q;
+  while (p < r)
+  {
+    q = PartitionStochastique(A, T, p, r);
+    if (k <= q) r = q; else p = q + 1;
+  }
+} /* SelectionRapideStochastique() */
+
 
 /*************************************************
 	Fonctions de mesure de temps 
@@ -259,6 +281,21 @@ int read_chrono(chrono *tp)
    return( (tp2.tv_sec - tp->tv_sec)*1000000 + (tp2.tv_usec - tp->tv_usec));
 } // read_chrono()
 
+/* ==================================== */
+/*! \fn long long horloge_ns()
+    \return la date en nanosecondes sur l'horloge monotone
+    \brief contrairement à gettimeofday, l'horloge monotone n'est pas affectée
+           par les réglages de l'heure système : à utiliser pour les mesures de performance
+*/
+long long horloge_ns()
+/* ==================================== */
+{
+   struct timespec ts;
+   if ( clock_gettime(CLOCK_MONOTONIC, &ts) != 0 )
+     fprintf(stderr, "horloge_ns() : clock_gettime failed\n");
+   return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+} // horloge_ns()
+
 /*----------- Exemple d'utilisation : 
 void main()
 {
@@ -271,6 +308,66 @@ void main()
 }
 */
 
+/*************************************************
+    Generateur pseudo-aleatoire reproductible (xorshift64*)
+**************************************************/
+
+/* ==================================== */
+/*! \fn void InitAlea(Alea *a, unsigned long long graine)
+    \param a (sortie) : un générateur.
+    \param graine (entrée) : la graine.
+    \brief initialise le générateur ; la graine est d'abord mélangée (splitmix64)
+           pour que des graines voisines donnent des suites indépendantes.
+*/
+void InitAlea(Alea *a, unsigned long long graine)
+/* ==================================== */
+{
+  unsigned long long z = graine + 0x9E3779B97F4A7C15ULL;
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  z = z ^ (z >> 31);
+  a->etat = (z == 0) ? 0x9E3779B97F4A7C15ULL : z;
+} // InitAlea()
+
+/* ==================================== */
+/*! \fn unsigned long long AleaSuivant(Alea *a)
+    \param a (entrée/sortie) : un générateur.
+    \return un entier pseudo-aléatoire sur 64 bits.
+*/
+unsigned long long AleaSuivant(Alea *a)
+/* ==================================== */
+{
+  unsigned long long x = a->etat;
+  x ^= x >> 12;
+  x ^= x << 25;
+  x ^= x >> 27;
+  a->etat = x;
+  return x * 0x2545F4914F6CDD1DULL;
+} // AleaSuivant()
+
+/* ==================================== */
+/*! \fn int AleaEntier(Alea *a, int n)
+    \param a (entrée/sortie) : un générateur.
+    \param n (entrée) : borne (n > 0).
+    \return un entier uniforme dans [0, n[.
+*/
+int AleaEntier(Alea *a, int n)
+/* ==================================== */
+{
+  return (int)(((AleaSuivant(a) >> 32) * (unsigned long long)n) >> 32);
+} // AleaEntier()
+
+/* ==================================== */
+/*! \fn double AleaReel(Alea *a)
+    \param a (entrée/sortie) : un générateur.
+    \return un réel uniforme dans [0, 1[.
+*/
+double AleaReel(Alea *a)
+/* ==================================== */
+{
+  return (double)(AleaSuivant(a) >> 11) * (1.0 / 9007199254740992.0);
+} // AleaReel()
+
 /*************************************************
     Fonctions pour la generation de postscript
     Michel Couprie
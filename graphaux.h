@@ -1,6 +1,8 @@
 /*! \file graphaux.h
     \brief structures auxiliaires
 */
+#ifndef GRAPHAUX_H
+#define GRAPHAUX_H
 #include <stdio.h>
 #include <string.h>
 /* 
@@ -10,6 +12,7 @@
 */
 #include <stdlib.h>
 #include <sys/time.h>
+#include <time.h>
 
 typedef char boolean;
 
@@ -50,6 +53,7 @@ void LifoTermine( Lifo * L );
 
 /* prototypes     */
 void TriRapideStochastique (int * A, TypeCle *T, int p, int r);
+void SelectionRapideStochastique (int * A, TypeCle *T, int p, int r, int k);
 
 /* ===================================== */
 /* MESURE DE TEMPS */
@@ -75,6 +79,26 @@ typedef struct timeval chrono;
 /* prototypes     */
 void start_chrono( chrono *tp );
 int read_chrono( chrono *tp );
+long long horloge_ns( void );
+
+/* ===================================== */
+/* GENERATEUR PSEUDO-ALEATOIRE */
+/* ===================================== */
+
+/*! \struct Alea
+    \brief état d'un générateur pseudo-aléatoire (xorshift64*) reproductible :
+           une même graine donne toujours la même suite, quel que soit le thread.
+*/
+typedef struct Alea {
+//! état interne (jamais nul)
+  unsigned long long etat;
+} Alea;
+
+/* prototypes     */
+void InitAlea( Alea *a, unsigned long long graine );
+unsigned long long AleaSuivant( Alea *a );
+int AleaEntier( Alea *a, int n );
+double AleaReel( Alea *a );
 
 /* ===================================== */
 /* GENERATION DE POSTSCRIPT */
@@ -97,3 +121,5 @@ void PSFooter(FILE *fd);
 /* ===================================== */
 
 boolean * EnsembleVide(int n);
+
+#endif /* GRAPHAUX_H */
@@ -1,6 +1,8 @@
 /*! \file graphes.h
     \brief structures de base pour la manipulation de graphes
 */
+#ifndef GRAPHES_H
+#define GRAPHES_H
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
@@ -146,6 +148,7 @@ extern int EstDansListe(pcell p, int a);
 
 extern graphe * InitGraphe(int nsom, int nmaxarc);
 extern void TermineGraphe(graphe * g);
+extern void ViderGraphe(graphe * g, int nsom);
 extern graphe * ReadGraphe(char * filename);
 
 /* ====================================================================== */
@@ -167,6 +170,8 @@ extern int EstSuccesseur(graphe *g, int i, int s);
 /* ====================================================================== */
 
 extern graphe * GrapheAleatoire(int nsom, int narc, int code);
+extern graphe * GrapheAleatoireConnexe(int nsom, int narc, unsigned long long graine, int euclidien);
+extern graphe * GrapheRoutierAleatoire(int nsom, unsigned long long graine);
 
 /* ====================================================================== */
 /* ====================================================================== */
@@ -189,3 +194,5 @@ extern graphe * FermetureSymetrique(graphe * g);
 
 extern graphe * Kruskal1(graphe * g, graphe *g_1);
 extern graphe * Kruskal2(graphe * g, graphe *g_1);
+
+#endif /* GRAPHES_H */
@@ -0,0 +1,711 @@
+/*! \file hierarchie.c
+    \brief hiérarchies de contraction : prétraitement de la carte routière pour des
+           requêtes point à point rapides
+
+    Les sommets sont contractés un à un, du moins important au plus important. Contracter v
+    le retire du graphe ; pour chaque paire u -> v -> w de voisins restants, un raccourci
+    u -> w de même longueur est ajouté, sauf si une recherche de témoins (Dijkstra local
+    depuis u, sans passer par v, limité à HIERARCHIE_TEMOINS sommets) trouve un chemin
+    aussi court. L'ordre est choisi par une file de priorité paresseuse : la priorité d'un
+    sommet est le double de sa différence d'arcs (raccourcis ajoutés - arcs retirés), plus
+    le nombre de ses voisins déjà contractés et son niveau dans la hiérarchie (ces deux
+    termes répartissent les contractions sur toute la carte) ; elle est recalculée quand
+    le sommet sort de la file et quand un de ses voisins est contracté.
+
+    Une requête est un Dijkstra bidirectionnel qui ne monte jamais vers un rang plus faible ;
+    le chemin trouvé est déplié en remplaçant chaque raccourci par les deux arcs qu'il
+    représente. La hiérarchie s'écrit dans un fichier binaire relu en un seul passage.
+*/
+#include "hierarchie.h"
+
+/*! \def HIERARCHIE_MAGIQUE
+    \brief en-tête des fichiers de hiérarchie (8 octets)
+*/
+#define HIERARCHIE_MAGIQUE "AEHIER01"
+
+/*! \def HIERARCHIE_INFINI
+    \brief distance tant qu'aucun chemin n'est connu
+*/
+#define HIERARCHIE_INFINI 0x3fffffffffffffffL
+
+/* ====================================================================== */
+/* ====================================================================== */
+/* CONTRACTION */
+/* ====================================================================== */
+/* ====================================================================== */
+
+/*! \struct ListeArcs
+    \brief liste extensible d'indices d'arcs
+*/
+typedef struct ListeArcs {
+  int n;
+  int capacite;
+  int *arc;
+} ListeArcs;
+
+/*! \struct Contraction
+    \brief état de la construction d'une hiérarchie
+*/
+typedef struct Contraction {
+  int nsom;
+//! arcs créés (graphe puis raccourcis)
+  ArcHierarchie *arcs;
+  int narc;
+  int capacite;
+//! remplace[a] non nul si un arc plus court de mêmes extrémités a été ajouté
+  char *remplace;
+//! arcs sortants et entrants de chaque sommet (contenant éventuellement des arcs morts)
+  ListeArcs *sortants, *entrants;
+//! rang de contraction, -1 tant que le sommet est dans le graphe
+  int *rang;
+//! nombre de voisins déjà contractés
+  int *voisins_contractes;
+//! niveau : 1 + plus grand niveau des voisins contractés (0 au départ)
+  int *niveau;
+//! limite de la recherche de témoins
+  int temoins;
+//! marques, distances et tas de la recherche de témoins
+  unsigned int *marque;
+  unsigned int generation;
+  long *dist;
+  TasDijkstra tas;
+} Contraction;
+
+/* ====================================================================== */
+/*! \fn static void AjouteListe(ListeArcs *l, int a)
+    \brief ajoute l'arc a à la liste
+*/
+static void AjouteListe(ListeArcs *l, int a){
+  if (l->n == l->capacite){
+    l->capacite = (l->capacite > 0) ? 2 * l->capacite : 4;
+    l->arc = (int *)realloc(l->arc, l->capacite * sizeof(int));
+    if (l->arc == NULL)
+    {   fprintf(stderr, "AjouteListe : realloc failed\n");
+        exit(0);
+    }
+  }
+  l->arc[l->n++] = a;
+}
+
+/* ====================================================================== */
+/*! \fn static int AjouteArcContraction(Contraction *c, int de, int vers, long poids, int f0, int f1)
+    \return l'indice du nouvel arc
+*/
+static int AjouteArcContraction(Contraction *c, int de, int vers, long poids, int f0, int f1){
+  ArcHierarchie *a;
+  if (c->narc == c->capacite){
+    c->capacite *= 2;
+    c->arcs = (ArcHierarchie *)realloc(c->arcs, c->capacite * sizeof(ArcHierarchie));
+    c->remplace = (char *)realloc(c->remplace, c->capacite * sizeof(char));
+    if ((c->arcs == NULL) || (c->remplace == NULL))
+    {   fprintf(stderr, "AjouteArcContraction : realloc failed\n");
+        exit(0);
+    }
+  }
+  a = c->arcs + c->narc;
+  a->de = de;
+  a->vers = vers;
+  a->fils[0] = f0;
+  a->fils[1] = f1;
+  a->poids = poids;
+  c->remplace[c->narc] = 0;
+  AjouteListe(&(c->sortants[de]), c->narc);
+  AjouteListe(&(c->entrants[vers]), c->narc);
+  return c->narc++;
+}
+
+/*! \def ArcVivant(c, a)
+    \brief vrai si l'arc a n'est pas remplacé et relie deux sommets encore dans le graphe
+*/
+#define ArcVivant(c, a) (!(c)->remplace[a] && ((c)->rang[(c)->arcs[a].de] < 0) && ((c)->rang[(c)->arcs[a].vers] < 0))
+
+/* ====================================================================== */
+/*! \fn static void NettoieListe(Contraction *c, ListeArcs *l)
+    \brief retire de la liste les arcs qui ne sont plus vivants
+*/
+static void NettoieListe(Contraction *c, ListeArcs *l){
+  int i, k = 0;
+  for (i = 0; i < l->n; i++)
+    if (ArcVivant(c, l->arc[i])) l->arc[k++] = l->arc[i];
+  l->n = k;
+}
+
+/* ====================================================================== */
+/*! \fn static void RechercheTemoins(Contraction *c, int u, int v, long limite)
+    \brief Dijkstra depuis u dans le graphe restant privé de v, arrêté au-delà de la distance
+           limite ou après c->temoins sommets stabilisés ; dist[w] est valide si marque[w] == generation
+*/
+static void RechercheTemoins(Contraction *c, int u, int v, long limite){
+  int x, y, i, a, stabilises = 0;
+  long d, nd;
+
+  if (++c->generation == 0){
+    memset(c->marque, 0, c->nsom * sizeof(unsigned int));
+    c->generation = 1;
+  }
+  c->tas.n = 0;
+  c->marque[u] = c->generation;
+  c->dist[u] = 0;
+  InsereTasDijkstra(&(c->tas), 0, u);
+  while (c->tas.n > 0){
+    x = ExtraitTasDijkstra(&(c->tas), &d);
+    if (d != c->dist[x]) continue; /* entrée périmée */
+    if ((d > limite) || (++stabilises > c->temoins)) break;
+    for (i = 0; i < c->sortants[x].n; i++){
+      a = c->sortants[x].arc[i];
+      y = c->arcs[a].vers;
+      if ((y == v) || !ArcVivant(c, a)) continue;
+      nd = d + c->arcs[a].poids;
+      if ((c->marque[y] != c->generation) || (nd < c->dist[y])){
+        c->marque[y] = c->generation;
+        c->dist[y] = nd;
+        InsereTasDijkstra(&(c->tas), nd, y);
+      }
+    }
+  }
+}
+
+/* ====================================================================== */
+/*! \fn static void AjouteRaccourci(Contraction *c, int u, int w, long poids, int f0, int f1)
+    \brief ajoute le raccourci u -> w, sauf si un arc u -> w au moins aussi court existe déjà ;
+           les arcs u -> w plus longs sont marqués remplacés
+*/
+static void AjouteRaccourci(Contraction *c, int u, int w, long poids, int f0, int f1){
+  int i, a;
+  for (i = 0; i < c->sortants[u].n; i++){
+    a = c->sortants[u].arc[i];
+    if ((c->arcs[a].vers != w) || c->remplace[a]) continue;
+    if (c->arcs[a].poids <= poids) return;
+    c->remplace[a] = 1;
+  }
+  AjouteArcContraction(c, u, w, poids, f0, f1);
+}
+
+/* ====================================================================== */
+/*! \fn static int ContracteSommet(Contraction *c, int v, int simuler)
+    \param c : la construction en cours
+    \param v : un sommet encore dans le graphe
+    \param simuler : si non nul, les raccourcis sont seulement comptés
+    \return le nombre de raccourcis nécessaires pour retirer v
+*/
+static int ContracteSommet(Contraction *c, int v, int simuler){
+  ListeArcs *in = &(c->entrants[v]), *out = &(c->sortants[v]);
+  int i, j, ain, aout, u, w, k = 0;
+  long maxout, p;
+
+  for (i = 0; i < in->n; i++){
+    ain = in->arc[i];
+    u = c->arcs[ain].de;
+    if ((u == v) || !ArcVivant(c, ain)) continue;
+    maxout = -1;
+    for (j = 0; j < out->n; j++){
+      aout = out->arc[j];
+      if ((c->arcs[aout].vers != u) && (c->arcs[aout].vers != v) && ArcVivant(c, aout))
+        maxout = max(maxout, c->arcs[aout].poids);
+    }
+    if (maxout < 0) continue;
+    RechercheTemoins(c, u, v, c->arcs[ain].poids + maxout);
+    for (j = 0; j < out->n; j++){
+      aout = out->arc[j];
+      w = c->arcs[aout].vers;
+      if ((w == u) || (w == v) || !ArcVivant(c, aout)) continue;
+      p = c->arcs[ain].poids + c->arcs[aout].poids;
+      if ((c->marque[w] == c->generation) && (c->dist[w] <= p)) continue; /* témoin */
+      k++;
+      if (!simuler) AjouteRaccourci(c, u, w, p, ain, aout);
+    }
+  }
+  return k;
+}
+
+/* ====================================================================== */
+/*! \fn static long Priorite(Contraction *c, int v)
+    \return deux fois la différence d'arcs de v, plus le nombre de ses voisins déjà
+            contractés et son niveau
+*/
+static long Priorite(Contraction *c, int v){
+  int i, degre = 0;
+  for (i = 0; i < c->entrants[v].n; i++) if (ArcVivant(c, c->entrants[v].arc[i])) degre++;
+  for (i = 0; i < c->sortants[v].n; i++) if (ArcVivant(c, c->sortants[v].arc[i])) degre++;
+  return 2 * (ContracteSommet(c, v, 1) - degre) + c->voisins_contractes[v] + c->niveau[v];
+}
+
+/* ====================================================================== */
+/*! \fn static void RangeArcs(Hierarchie *h, char *remplace)
+    \brief range les arcs non remplacés en arcs montants (haut) et descendants (bas)
+*/
+static void RangeArcs(Hierarchie *h, char *remplace){
+  int n = h->nsom, a, x, y;
+  int *pos_haut, *pos_bas;
+
+  h->debut_haut = (int *)calloc(n + 1, sizeof(int));
+  h->debut_bas = (int *)calloc(n + 1, sizeof(int));
+  pos_haut = (int *)malloc((n + 1) * sizeof(int));
+  pos_bas = (int *)malloc((n + 1) * sizeof(int));
+  if ((h->debut_haut == NULL) || (h->debut_bas == NULL) || (pos_haut == NULL) || (pos_bas == NULL))
+  {   fprintf(stderr, "RangeArcs : malloc failed\n");
+      exit(0);
+  }
+  for (a = 0; a < h->narc; a++){
+    x = h->arcs[a].de;
+    y = h->arcs[a].vers;
+    if (remplace[a] || (x == y)) continue;
+    if (h->rang[x] < h->rang[y]) h->debut_haut[x + 1]++;
+    else h->debut_bas[y + 1]++;
+  }
+  for (x = 0; x < n; x++){
+    h->debut_haut[x + 1] += h->debut_haut[x];
+    h->debut_bas[x + 1] += h->debut_bas[x];
+  }
+  h->haut = (int *)malloc((h->debut_haut[n] + 1) * sizeof(int));
+  h->bas = (int *)malloc((h->debut_bas[n] + 1) * sizeof(int));
+  if ((h->haut == NULL) || (h->bas == NULL))
+  {   fprintf(stderr, "RangeArcs : malloc failed\n");
+      exit(0);
+  }
+  memcpy(pos_haut, h->debut_haut, (n + 1) * sizeof(int));
+  memcpy(pos_bas, h->debut_bas, (n + 1) * sizeof(int));
+  for (a = 0; a < h->narc; a++){
+    x = h->arcs[a].de;
+    y = h->arcs[a].vers;
+    if (remplace[a] || (x == y)) continue;
+    if (h->rang[x] < h->rang[y]) h->haut[pos_haut[x]++] = a;
+    else h->bas[pos_bas[y]++] = a;
+  }
+  free(pos_haut);
+  free(pos_bas);
+}
+
+/* ====================================================================== */
+/*! \fn Hierarchie* ConstruitHierarchie(ReseauRoutier *r, int temoins)
+    \param r : un réseau (ses arcs, dans le sens de r->g)
+    \param temoins : nombre maximum de sommets stabilisés par recherche de témoins
+                     (HIERARCHIE_TEMOINS si <= 0) ; plus il est grand, moins il y a de raccourcis
+    \return la hiérarchie
+    \brief contracte tous les sommets (voir l'en-tête du fichier)
+*/
+Hierarchie* ConstruitHierarchie(ReseauRoutier *r, int temoins){
+  Contraction c;
+  Hierarchie *h;
+  TasDijkstra file;
+  long *priorite, p;
+  int *dernier, n = r->g->nsom, x, v, i, k, suivant = 0;
+
+  memset(&c, 0, sizeof(Contraction));
+  c.nsom = n;
+  c.temoins = (temoins > 0) ? temoins : HIERARCHIE_TEMOINS;
+  c.capacite = 2 * r->g->narc + 16;
+  c.arcs = (ArcHierarchie *)malloc(c.capacite * sizeof(ArcHierarchie));
+  c.remplace = (char *)malloc(c.capacite * sizeof(char));
+  c.sortants = (ListeArcs *)calloc(n + 1, sizeof(ListeArcs));
+  c.entrants = (ListeArcs *)calloc(n + 1, sizeof(ListeArcs));
+  c.rang = (int *)malloc((n + 1) * sizeof(int));
+  c.voisins_contractes = (int *)calloc(n + 1, sizeof(int));
+  c.niveau = (int *)calloc(n + 1, sizeof(int));
+  c.marque = (unsigned int *)calloc(n + 1, sizeof(unsigned int));
+  c.dist = (long *)malloc((n + 1) * sizeof(long));
+  priorite = (long *)malloc((n + 1) * sizeof(long));
+  dernier = (int *)malloc((n + 1) * sizeof(int));
+  if ((c.arcs == NULL) || (c.remplace == NULL) || (c.sortants == NULL) || (c.entrants == NULL) ||
+      (c.rang == NULL) || (c.voisins_contractes == NULL) || (c.niveau == NULL) || (c.marque == NULL) || (c.dist == NULL) ||
+      (priorite == NULL) || (dernier == NULL))
+  {   fprintf(stderr, "ConstruitHierarchie : malloc failed\n");
+      exit(0);
+  }
+  InitTasDijkstra(&(c.tas), 64);
+  InitTasDijkstra(&file, n);
+  for (x = 0; x < n; x++){
+    c.rang[x] = -1;
+    dernier[x] = -1;
+    for (i = r->g->debut[x]; i < r->g->debut[x + 1]; i++)
+      if (r->g->voisin[i] != x) AjouteArcContraction(&c, x, r->g->voisin[i], r->g->poids[i], -1, -1);
+  }
+
+  for (x = 0; x < n; x++){
+    priorite[x] = Priorite(&c, x);
+    InsereTasDijkstra(&file, priorite[x], x);
+  }
+  while (file.n > 0){
+    v = ExtraitTasDijkstra(&file, &p);
+    if ((c.rang[v] >= 0) || (p != priorite[v])) continue; /* entrée périmée */
+    p = Priorite(&c, v);
+    if ((file.n > 0) && (p > file.cle[0])){ /* mise à jour paresseuse */
+      priorite[v] = p;
+      InsereTasDijkstra(&file, p, v);
+      continue;
+    }
+    ContracteSommet(&c, v, 0);
+    c.rang[v] = suivant++;
+    for (k = 0; k < 2; k++){ /* voisins : priorités à revoir */
+      ListeArcs *l = k ? &(c.sortants[v]) : &(c.entrants[v]);
+      for (i = 0; i < l->n; i++){
+        x = k ? c.arcs[l->arc[i]].vers : c.arcs[l->arc[i]].de;
+        if ((c.rang[x] >= 0) || (dernier[x] == v) || c.remplace[l->arc[i]]) continue;
+        dernier[x] = v;
+        c.voisins_contractes[x]++;
+        c.niveau[x] = max(c.niveau[x], c.niveau[v] + 1);
+        NettoieListe(&c, &(c.sortants[x]));
+        NettoieListe(&c, &(c.entrants[x]));
+        priorite[x] = Priorite(&c, x);
+        InsereTasDijkstra(&file, priorite[x], x);
+      }
+    }
+  }
+
+  h = (Hierarchie *)calloc(1, sizeof(Hierarchie));
+  if (h == NULL)
+  {   fprintf(stderr, "ConstruitHierarchie : calloc failed\n");
+      exit(0);
+  }
+  h->nsom = n;
+  h->narc = c.narc;
+  h->narc_graphe = r->g->narc;
+  h->rang = c.rang;
+  h->arcs = c.arcs;
+  RangeArcs(h, c.remplace);
+
+  for (x = 0; x < n; x++){
+    free(c.sortants[x].arc);
+    free(c.entrants[x].arc);
+  }
+  free(c.sortants);
+  free(c.entrants);
+  free(c.remplace);
+  free(c.voisins_contractes);
+  free(c.niveau);
+  free(c.marque);
+  free(c.dist);
+  free(priorite);
+  free(dernier);
+  TermineTasDijkstra(&(c.tas));
+  TermineTasDijkstra(&file);
+  return h;
+}
+
+/* ====================================================================== */
+/*! \fn void TermineHierarchie(Hierarchie *h)
+    \param h : une hiérarchie
+*/
+void TermineHierarchie(Hierarchie *h){
+  free(h->rang);
+  free(h->arcs);
+  free(h->debut_haut);
+  free(h->haut);
+  free(h->debut_bas);
+  free(h->bas);
+  free(h);
+}
+
+/* ====================================================================== */
+/* ====================================================================== */
+/* FICHIERS */
+/* ====================================================================== */
+/* ====================================================================== */
+
+/* ====================================================================== */
+/*! \fn int EcritHierarchie(Hierarchie *h, char *nomfichier)
+    \param h : une hiérarchie
+    \param nomfichier : fichier à écrire
+    \return 1 si le fichier est écrit, 0 sinon
+    \brief format binaire (ordre des octets de la machine) : HIERARCHIE_MAGIQUE, nsom, narc,
+           narc_graphe, rang, arcs, debut_haut, haut, debut_bas, bas
+*/
+int EcritHierarchie(Hierarchie *h, char *nomfichier){
+  FILE *fd = fopen(nomfichier, "wb");
+  int n = h->nsom, ok;
+
+  if (fd == NULL){
+    fprintf(stderr, "EcritHierarchie : impossible d'ouvrir %s\n", nomfichier);
+    return 0;
+  }
+  ok = (fwrite(HIERARCHIE_MAGIQUE, 1, 8, fd) == 8) &&
+       (fwrite(&(h->nsom), sizeof(int), 1, fd) == 1) &&
+       (fwrite(&(h->narc), sizeof(int), 1, fd) == 1) &&
+       (fwrite(&(h->narc_graphe), sizeof(int), 1, fd) == 1) &&
+       (fwrite(h->rang, sizeof(int), n, fd) == (size_t)n) &&
+       (fwrite(h->arcs, sizeof(ArcHierarchie), h->narc, fd) == (size_t)h->narc) &&
+       (fwrite(h->debut_haut, sizeof(int), n + 1, fd) == (size_t)n + 1) &&
+       (fwrite(h->haut, sizeof(int), h->debut_haut[n], fd) == (size_t)h->debut_haut[n]) &&
+       (fwrite(h->debut_bas, sizeof(int), n + 1, fd) == (size_t)n + 1) &&
+       (fwrite(h->bas, sizeof(int), h->debut_bas[n], fd) == (size_t)h->debut_bas[n]);
+  if (fclose(fd) != 0) ok = 0;
+  if (!ok) fprintf(stderr, "EcritHierarchie : erreur d'écriture dans %s\n", nomfichier);
+  return ok;
+}
+
+/* ====================================================================== */
+/*! \fn static int LitTableau(FILE *fd, void **t, size_t taille, long n)
+    \brief alloue et lit n éléments de taille octets ; retourne 1 si la lecture est complète
+*/
+static int LitTableau(FILE *fd, void **t, size_t taille, long n){
+  if (n < 0) return 0;
+  *t = malloc((n > 0) ? n * taille : 1);
+  if (*t == NULL)
+  {   fprintf(stderr, "LitHierarchie : malloc failed\n");
+      exit(0);
+  }
+  return fread(*t, taille, n, fd) == (size_t)n;
+}
+
+/* ====================================================================== */
+/*! \fn static int DebutsValides(int *debut, int n, int *liste, int narc)
+    \brief vrai si debut[0..n] part de 0 sans décroître et si les debut[n] arcs de liste
+           sont des indices d'arcs valides
+*/
+static int DebutsValides(int *debut, int n, int *liste, int narc){
+  int x, a;
+  if (debut[0] != 0) return 0;
+  for (x = 0; x < n; x++)
+    if (debut[x + 1] < debut[x]) return 0;
+  for (a = 0; a < debut[n]; a++)
+    if ((liste[a] < 0) || (liste[a] >= narc)) return 0;
+  return 1;
+}
+
+/* ====================================================================== */
+/*! \fn static int HierarchieValide(Hierarchie *h)
+    \brief vrai si les tables lues ne sortent pas de leurs bornes : extrémités des arcs,
+           tables d'adjacence, et fils des raccourcis (rangés avant eux, ce qui garantit
+           aussi que DeplieArc termine)
+*/
+static int HierarchieValide(Hierarchie *h){
+  ArcHierarchie *x;
+  int a;
+  if (!DebutsValides(h->debut_haut, h->nsom, h->haut, h->narc) ||
+      !DebutsValides(h->debut_bas, h->nsom, h->bas, h->narc)) return 0;
+  for (a = 0; a < h->narc; a++){
+    x = h->arcs + a;
+    if ((x->de < 0) || (x->de >= h->nsom) || (x->vers < 0) || (x->vers >= h->nsom)) return 0;
+    if ((x->fils[0] < 0) != (x->fils[1] < 0)) return 0;
+    if ((x->fils[0] >= a) || (x->fils[1] >= a)) return 0;
+  }
+  return 1;
+}
+
+/* ====================================================================== */
+/*! \fn Hierarchie* LitHierarchie(char *nomfichier)
+    \param nomfichier : fichier écrit par EcritHierarchie
+    \return la hiérarchie, NULL si le fichier est absent ou invalide
+*/
+Hierarchie* LitHierarchie(char *nomfichier){
+  FILE *fd = fopen(nomfichier, "rb");
+  Hierarchie *h;
+  char magique[8];
+  int ok;
+
+  if (fd == NULL) return NULL;
+  h = (Hierarchie *)calloc(1, sizeof(Hierarchie));
+  if (h == NULL)
+  {   fprintf(stderr, "LitHierarchie : calloc failed\n");
+      exit(0);
+  }
+  ok = (fread(magique, 1, 8, fd) == 8) && !memcmp(magique, HIERARCHIE_MAGIQUE, 8) &&
+       (fread(&(h->nsom), sizeof(int), 1, fd) == 1) &&
+       (fread(&(h->narc), sizeof(int), 1, fd) == 1) &&
+       (fread(&(h->narc_graphe), sizeof(int), 1, fd) == 1) &&
+       LitTableau(fd, (void **)&(h->rang), sizeof(int), h->nsom) &&
+       LitTableau(fd, (void **)&(h->arcs), sizeof(ArcHierarchie), h->narc) &&
+       LitTableau(fd, (void **)&(h->debut_haut), sizeof(int), (long)h->nsom + 1) &&
+       LitTableau(fd, (void **)&(h->haut), sizeof(int), h->debut_haut[h->nsom]) &&
+       LitTableau(fd, (void **)&(h->debut_bas), sizeof(int), (long)h->nsom + 1) &&
+       LitTableau(fd, (void **)&(h->bas), sizeof(int), h->debut_bas[h->nsom]) &&
+       HierarchieValide(h);
+  fclose(fd);
+  if (!ok){
+    fprintf(stderr, "LitHierarchie : fichier %s invalide\n", nomfichier);
+    TermineHierarchie(h);
+    return NULL;
+  }
+  return h;
+}
+
+/* ====================================================================== */
+/* ====================================================================== */
+/* REQUETES */
+/* ====================================================================== */
+/* ====================================================================== */
+
+/* ====================================================================== */
+/*! \fn long RequeteHierarchie(Hierarchie *h, RechercheBidirectionnelle *rb, int s, int t)
+    \param h : une hiérarchie
+    \param rb : tampons de la recherche (pour h->nsom sommets)
+    \param s : sommet source
+    \param t : sommet cible
+    \return la longueur d'un plus court chemin de s à t, -1 s'il n'y en a pas
+    \brief Dijkstra montant depuis s et depuis t ; le côté de plus petite clé avance, un côté
+           dont la plus petite clé dépasse le meilleur chemin n'a plus rien à trouver.
+           Le sommet de rencontre est rangé dans rb->u et rb->v.
+*/
+long RequeteHierarchie(Hierarchie *h, RechercheBidirectionnelle *rb, int s, int t){
+  RechercheChemin *cotes[2] = {&(rb->avant), &(rb->arriere)}, *rc, *autre;
+  long meilleur = HIERARCHIE_INFINI, m[2], d, nd;
+  int milieu = -1, c, x, y, i, a, *debut, *liste;
+  unsigned int gen;
+
+  NouvelleRechercheChemin(&(rb->avant), s, 0);
+  NouvelleRechercheChemin(&(rb->arriere), t, 0);
+  for (;;){
+    for (c = 0; c < 2; c++) m[c] = (cotes[c]->tas.n > 0) ? cotes[c]->tas.cle[0] : HIERARCHIE_INFINI;
+    if (min(m[0], m[1]) >= meilleur) break;
+    c = (m[0] <= m[1]) ? 0 : 1;
+    rc = cotes[c];
+    autre = cotes[1 - c];
+    gen = rc->generation;
+    x = ExtraitTasQuaternaire(&(rc->tas));
+    rc->stabilises++;
+    d = rc->dist[x];
+    if ((DistanceAtteinte(autre, x) >= 0) && (d + autre->dist[x] < meilleur)){
+      meilleur = d + autre->dist[x];
+      milieu = x;
+    }
+    debut = c ? h->debut_bas : h->debut_haut;
+    liste = c ? h->bas : h->haut;
+    for (i = debut[x]; i < debut[x + 1]; i++){
+      a = liste[i];
+      y = c ? h->arcs[a].de : h->arcs[a].vers;
+      nd = d + h->arcs[a].poids;
+      if (rc->marque[y] != gen){
+        rc->marque[y] = gen;
+        rc->dist[y] = nd;
+        rc->pred[y] = x;
+        rc->atteints[rc->natteints++] = y;
+        MonteTasQuaternaire(&(rc->tas), rc->tas.n++, nd, y);
+      }
+      else if ((nd < rc->dist[y]) && (rc->tas.position[y] >= 0)){
+        rc->dist[y] = nd;
+        rc->pred[y] = x;
+        MonteTasQuaternaire(&(rc->tas), rc->tas.position[y], nd, y);
+      }
+    }
+  }
+  rb->meilleur = (milieu >= 0) ? meilleur : -1;
+  rb->u = rb->v = milieu;
+  rb->stabilises = rb->avant.stabilises + rb->arriere.stabilises;
+  return rb->meilleur;
+}
+
+/* ====================================================================== */
+/*! \fn void RechercheMontante(Hierarchie *h, RechercheChemin *rc, int s, int descendante)
+    \param h : une hiérarchie
+    \param rc : tampons de la recherche (pour h->nsom sommets)
+    \param s : sommet de départ
+    \param descendante : si non nul, recherche depuis une cible sur les arcs descendants
+    \brief Dijkstra montant complet depuis s, sans critère d'arrêt. Un sommet x est bloqué
+           (stall-on-demand) si un sommet plus haut déjà atteint y donne, par l'arc qui
+           descend de y à x, une distance plus courte que dist[x] : ses arcs ne sont pas
+           suivis, et il est retiré de rc->atteints à la fin. rc->atteints énumère alors
+           les sommets dont rc->dist est la distance montante exacte, et seuls ceux-là
+           peuvent porter un plus court chemin.
+*/
+void RechercheMontante(Hierarchie *h, RechercheChemin *rc, int s, int descendante){
+  int *debut = descendante ? h->debut_bas : h->debut_haut, *liste = descendante ? h->bas : h->haut;
+  int *debut_retour = descendante ? h->debut_haut : h->debut_bas, *retour = descendante ? h->haut : h->bas;
+  unsigned int gen;
+  int x, y, i, a, k;
+  long d, nd;
+
+  NouvelleRechercheChemin(rc, s, 0);
+  gen = rc->generation;
+  while (rc->tas.n > 0){
+    x = ExtraitTasQuaternaire(&(rc->tas));
+    rc->stabilises++;
+    d = rc->dist[x];
+    for (i = debut_retour[x]; i < debut_retour[x + 1]; i++){ /* blocage */
+      a = retour[i];
+      y = descendante ? h->arcs[a].vers : h->arcs[a].de;
+      if ((rc->marque[y] == gen) && (rc->dist[y] + h->arcs[a].poids < d)) break;
+    }
+    if (i < debut_retour[x + 1]){
+      rc->pred[x] = -2;
+      continue;
+    }
+    for (i = debut[x]; i < debut[x + 1]; i++){
+      a = liste[i];
+      y = descendante ? h->arcs[a].de : h->arcs[a].vers;
+      nd = d + h->arcs[a].poids;
+      if (rc->marque[y] != gen){
+        rc->marque[y] = gen;
+        rc->dist[y] = nd;
+        rc->pred[y] = x;
+        rc->atteints[rc->natteints++] = y;
+        MonteTasQuaternaire(&(rc->tas), rc->tas.n++, nd, y);
+      }
+      else if ((nd < rc->dist[y]) && (rc->tas.position[y] >= 0)){
+        rc->dist[y] = nd;
+        rc->pred[y] = x;
+        MonteTasQuaternaire(&(rc->tas), rc->tas.position[y], nd, y);
+      }
+    }
+  }
+  for (i = k = 0; i < rc->natteints; i++)
+    if (rc->pred[rc->atteints[i]] != -2) rc->atteints[k++] = rc->atteints[i];
+  rc->natteints = k;
+}
+
+/* ====================================================================== */
+/*! \fn static int ArcSuivi(Hierarchie *h, RechercheChemin *rc, int c, int x)
+    \return l'arc par lequel le côté c (0 : depuis la source) a atteint x depuis pred[x]
+*/
+static int ArcSuivi(Hierarchie *h, RechercheChemin *rc, int c, int x){
+  int p = rc->pred[x], i, a;
+  int *debut = c ? h->debut_bas : h->debut_haut, *liste = c ? h->bas : h->haut;
+  for (i = debut[p]; i < debut[p + 1]; i++){
+    a = liste[i];
+    if (((c ? h->arcs[a].de : h->arcs[a].vers) == x) && (rc->dist[p] + h->arcs[a].poids == rc->dist[x])) return a;
+  }
+  return -1;
+}
+
+/* ====================================================================== */
+/*! \fn static void DeplieArc(Hierarchie *h, int a, int *chemin, int *l)
+    \brief écrit dans chemin (si non NULL) les sommets de l'arc a déplié, sauf le premier,
+           et en ajoute le nombre à *l
+*/
+static void DeplieArc(Hierarchie *h, int a, int *chemin, int *l){
+  if (h->arcs[a].fils[0] < 0){
+    if (chemin != NULL) chemin[*l] = h->arcs[a].vers;
+    (*l)++;
+    return;
+  }
+  DeplieArc(h, h->arcs[a].fils[0], chemin, l);
+  DeplieArc(h, h->arcs[a].fils[1], chemin, l);
+}
+
+/* ====================================================================== */
+/*! \fn int* CheminHierarchie(Hierarchie *h, RechercheBidirectionnelle *rb, int *longueur)
+    \param h : une hiérarchie
+    \param rb : tampons de la dernière requête RequeteHierarchie
+    \param longueur : (sortie) nombre de sommets du chemin
+    \return les sommets du chemin de la source à la cible dans le graphe d'origine
+            (à libérer par l'appelant), NULL s'il n'y en a pas
+*/
+int* CheminHierarchie(Hierarchie *h, RechercheBidirectionnelle *rb, int *longueur){
+  int *arcs, *chemin, na = 0, l, i, x;
+
+  if (rb->meilleur < 0) return NULL;
+  for (x = rb->u; rb->avant.pred[x] != -1; x = rb->avant.pred[x]) na++;
+  for (x = rb->u; rb->arriere.pred[x] != -1; x = rb->arriere.pred[x]) na++;
+  arcs = (int *)malloc((na + 1) * sizeof(int));
+  if (arcs == NULL)
+  {   fprintf(stderr, "CheminHierarchie : malloc failed\n");
+      exit(0);
+  }
+  i = 0;
+  for (x = rb->u; rb->avant.pred[x] != -1; x = rb->avant.pred[x]) i++;
+  for (x = rb->u, l = i; rb->avant.pred[x] != -1; x = rb->avant.pred[x]) arcs[--l] = ArcSuivi(h, &(rb->avant), 0, x);
+  for (x = rb->u; rb->arriere.pred[x] != -1; x = rb->arriere.pred[x]) arcs[i++] = ArcSuivi(h, &(rb->arriere), 1, x);
+
+  l = 1; /* premier passage : longueur */
+  for (i = 0; i < na; i++) DeplieArc(h, arcs[i], NULL, &l);
+  chemin = (int *)malloc(l * sizeof(int));
+  if (chemin == NULL)
+  {   fprintf(stderr, "CheminHierarchie : malloc failed\n");
+      exit(0);
+  }
+  *longueur = l;
+  for (x = rb->u; rb->avant.pred[x] != -1; x = rb->avant.pred[x]);
+  chemin[0] = x;
+  for (i = 0, l = 1; i < na; i++) DeplieArc(h, arcs[i], chemin, &l);
+  free(arcs);
+  return chemin;
+}
@@ -0,0 +1,59 @@
+/*! \file hierarchie.h
+    \brief hiérarchies de contraction : prétraitement de la carte routière pour des
+           requêtes point à point rapides
+*/
+#ifndef HIERARCHIE_H
+#define HIERARCHIE_H
+
+#include "chemins.h"
+#include "fermeture.h"
+
+/*! \def HIERARCHIE_TEMOINS
+    \brief nombre maximum de sommets stabilisés par une recherche de témoins (défaut)
+*/
+#define HIERARCHIE_TEMOINS 100
+
+/*! \struct ArcHierarchie
+    \brief arc du graphe ou raccourci ; un raccourci remplace le chemin fils[0] puis fils[1]
+*/
+typedef struct ArcHierarchie {
+//! extrémité initiale
+  int de;
+//! extrémité finale
+  int vers;
+//! arcs remplacés par le raccourci, -1 pour un arc du graphe
+  int fils[2];
+//! poids
+  long poids;
+} ArcHierarchie;
+
+/*! \struct Hierarchie
+    \brief graphe des arcs montants : depuis la source, une requête ne suit que des arcs vers
+           des sommets de rang plus élevé, et depuis la cible des arcs qui en descendent
+*/
+typedef struct Hierarchie {
+//! nombre de sommets
+  int nsom;
+//! nombre d'arcs (arcs du graphe et raccourcis)
+  int narc;
+//! nombre d'arcs du réseau d'origine (contrôle à la lecture)
+  int narc_graphe;
+//! ordre de contraction de chaque sommet
+  int *rang;
+//! tous les arcs (les arcs remplacés par un raccourci plus court restent pour le dépliage)
+  ArcHierarchie *arcs;
+//! arcs (x,y) avec rang[x] < rang[y], rangés par x : haut[debut_haut[x] .. debut_haut[x+1]-1]
+  int *debut_haut, *haut;
+//! arcs (y,x) avec rang[x] < rang[y], rangés par x et parcourus à rebours depuis la cible
+  int *debut_bas, *bas;
+} Hierarchie;
+
+Hierarchie* ConstruitHierarchie(ReseauRoutier *r, int temoins);
+void TermineHierarchie(Hierarchie *h);
+int EcritHierarchie(Hierarchie *h, char *nomfichier);
+Hierarchie* LitHierarchie(char *nomfichier);
+void RechercheMontante(Hierarchie *h, RechercheChemin *rc, int s, int descendante);
+long RequeteHierarchie(Hierarchie *h, RechercheBidirectionnelle *rb, int s, int t);
+int* CheminHierarchie(Hierarchie *h, RechercheBidirectionnelle *rb, int *longueur);
+
+#endif /* HIERARCHIE_H */
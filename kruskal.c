@@ -8,6 +8,7 @@
 #define GRAPHE_INC
 
 #include "kruskal.h"
+#include "espace.h"
 
 /* ====================================================================== */
 /*! \fn ListeFIFO* initListeFIFO(int capacite)
@@ -36,6 +37,17 @@ void termineListeFIFO(ListeFIFO *l){
   free(l);  
 }
 
+/* ====================================================================== */
+/*! \fn void viderListeFIFO(ListeFIFO *l)
+    \param l : liste FIFO
+    \brief vide la liste FIFO sans libérer sa mémoire
+*/
+void viderListeFIFO(ListeFIFO *l){
+  l->n = 0;
+  l->prem = 0;
+  l->der = 0;
+}
+
 /* ====================================================================== */
 /*! \fn int selectionSuppressionListeFIFO(ListeFIFO *l)
     \param l : liste FIFO
@@ -96,47 +108,43 @@ booleen estNonVideListeFIFO(ListeFIFO *l){
 */
 booleen * explorationLargeur(graphe* G, int x){
   booleen *Z;       /* tableau booleens pour stocker l'exploration */
-  ListeFIFO *E, *D; /* Liste pour les ensembles de sommets */
-  ListeFIFO *tmp;   /* variable temporaire pour permettre l'echange des liste E et D */
-  pcell p; /* pointeur-maillon pour parcourir des listes de successeurs */
-  int y, z;         /* sommets du graphe */
-  int k;            /* num�ro d'iteration */
+  EspaceTravail *ws = CreeEspaceTravail();
 
-  
-  /* initialisation de l'ensemble E : E := {x}*/
-  E = initListeFIFO(G->nsom);
-  insertionListeFIFO(E, x);
-  
-  /* initialisation de l'ensemble Z : Z := {x}*/
+  explorationLargeurEspace(ws, G, x);
   Z = (booleen*) calloc(G->nsom, sizeof(booleen));
-  Z[x] = VRAI;
-  /* initialisation de l'ensemble D */
-  D = initListeFIFO(G->nsom);
-  
-  for(k = 1 ; k < G->nsom; k++){
-
-    while(estNonVideListeFIFO(E)){
-      y = selectionSuppressionListeFIFO(E);
-      for(p = G->gamma[y]; p != NULL; p = p->next){
-	z = p->som;
-	if(Z[z] == FAUX){
-	  insertionListeFIFO(D, z);
-	  Z[z] = VRAI;
-	}
-      }
-    }
-    /* On echange E et D */
-    tmp = E;
-    E = D;
-    D = tmp;
-      
-    }
-  termineListeFIFO(D);
-  termineListeFIFO(E);
-  
+  for(int i = 0; i < G->nsom; i++) Z[i] = EstMarque(ws, i);
+
+  TermineEspaceTravail(ws);
   return Z;
 }
 
+/* ====================================================================== */
+/*! \fn void fermetureSymDans(graphe * g, graphe * g_1)
+    \param g (entrée) : un graphe.
+    \param g_1 (sortie) : un graphe vide à g->nsom sommets et au moins 2*g->narc arcs.
+    \brief construit dans g_1 la fermeture symétrique du graphe g (arcs et liste d'arêtes I, T, poids).
+*/
+void fermetureSymDans(graphe * g, graphe * g_1)
+/* ====================================================================== */
+{
+  int x;
+  pcell p;
+  int i = 0;
+
+  for (x = 0; x < g->nsom; x++) /* pour tout i sommet de g */
+    for(p = g->gamma[x]; p != NULL; p = p->next){
+      g_1->I[i] = p->som;
+      g_1->T[i] = x;
+      g_1->poids[i] = p->v_arc;
+      AjouteArcValue(g_1, p->som, x, p->v_arc);
+      g_1->I[i+1] = x;
+      g_1->T[i+1] = p->som;
+      g_1->poids[i+1] = p->v_arc;
+      AjouteArcValue(g_1, x, p->som, p->v_arc);
+      i+=2;
+    }
+} /* fermetureSymDans() */
+
 /* ====================================================================== */
 /*! \fn graphe * fermetureSymEfficace(graphe * g)
     \param g (entr�e) : un graphe.
@@ -148,10 +156,7 @@ graphe * fermetureSymEfficace(graphe * g)
 /* ====================================================================== */
 {
   graphe *g_1;
-  int nsom, narc, x;
-  pcell p;
-  int i = 0;
-  int j = 0;
+  int nsom, narc;
 
   nsom = g->nsom;
   narc = g->narc;
@@ -162,19 +167,7 @@ graphe * fermetureSymEfficace(graphe * g)
     g_1 = InitGraphe(nsom, 2*narc);
   }
 
-  for (x = 0; x < nsom; x++) /* pour tout i sommet de g */
-    for(p = g->gamma[x]; p != NULL; p = p->next){
-      g_1->I[i] = p->som;
-      g_1->T[i] = x;
-      g_1->poids[i] = g->poids[j];
-      AjouteArc(g_1, p->som, x);
-      g_1->I[i+1] = x;
-      g_1->T[i+1] = p->som;
-      g_1->poids[i+1] = g->poids[j];
-      AjouteArc(g_1, x, p->som);
-      i+=2;
-      j++;
-    }
+  fermetureSymDans(g, g_1);
   return g_1;
 } /* Sym() */
 
@@ -188,9 +181,13 @@ graphe * fermetureSymEfficace(graphe * g)
 */
 booleen * CC(graphe* G, int x){
   booleen *Z;
-  graphe *GG = fermetureSymEfficace(G);
-  Z = explorationLargeur(GG, x);
-  TermineGraphe(GG);
+  EspaceTravail *ws = CreeEspaceTravail();
+
+  CCEspace(ws, G, x);
+  Z = (booleen*) calloc(G->nsom, sizeof(booleen));
+  for(int i = 0; i < G->nsom; i++) Z[i] = EstMarque(ws, i);
+
+  TermineEspaceTravail(ws);
   return Z;
 }
 
@@ -296,40 +293,28 @@ int* triAretes(graphe *Gp){
 */
 graphe* initGraphMin(graphe* G, double* poidsArbreMin){
     graphe *T; /* pour stocker l'arbre de poids minimum */
-    int *O;          /* tableau pour ranger les index des arcs par ordre croissant de poids*/
-    int x, y; // index pour des sommets
-    booleen *Z; // pour stocker les composantes connexes
-    int i=0, k=0;
-
-    T = InitGraphe(G->nsom, G->nsom-1);
-                
-    O = triAretes(G); /* O[i] est l'index de la i-�me ar�te par ordre croissant de poids; les extremites de la i-�me aretes sont donc Gp->I[O[i]] et Gp->T[O[i]] */
-    
-    while(k<((G->nsom)-1)){
-        x = G->I[O[i]];
-        y = G->T[O[i]];
-        Z = CC(T,x);
-        if(!Z[y]){
-            AjouteArcValue(T, x, y,G->poids[O[i]]);
-            k++;
-            *poidsArbreMin+= G->poids[O[i]];
-        }       
-        i++;
-        free(Z);
-    }
-    free(O);
+    EspaceTravail *ws = CreeEspaceTravail();
+
+    T = initGraphMinEspace(ws, G, poidsArbreMin);
+    ws->arbre.g = NULL; /* l'arbre est rendu a l'appelant */
+
+    TermineEspaceTravail(ws);
     return T;
 }
 
+/* ====================================================================== */
+/*! \fn int isConnexe(graphe* G, int x)
+    \param G : le graphe utilisé
+    \param x : un sommet du graphe (non utilisé : la connexité ne dépend pas du sommet de départ)
+    \return 1 si le graphe, vu comme non orienté, est connexe, 0 sinon
+*/
 int isConnexe(graphe* G, int x){
-  unsigned char *Z = CC(G,x);
-  
-  for (int i = 0; i < G->nsom; i++)
-  {
-    if(Z[i]==0) return 0;
-  }
+  Connexite c;
+  int res;
 
-  free(Z);
+  InitConnexite(&c);
+  res = EstConnexe(&c, G);
+  TermineConnexite(&c);
 
-  return 1;
-}
\ No newline at end of file
+  return res;
+}
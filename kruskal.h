@@ -1,3 +1,6 @@
+#ifndef KRUSKAL_H
+#define KRUSKAL_H
+
 #include "graphaux.h"
 #include "graphes.h"
 #include <stdio.h>
@@ -23,15 +26,19 @@ typedef struct ListeFIFO{
 ListeFIFO* initListeFIFO(int capacite);
 
 void termineListeFIFO(ListeFIFO *l);
+void viderListeFIFO(ListeFIFO *l);
 int selectionSuppressionListeFIFO(ListeFIFO *l);
 booleen insertionListeFIFO(ListeFIFO *l, int x);
 booleen estNonVideListeFIFO(ListeFIFO *l);
 booleen * explorationLargeur(graphe* G, int x);
 graphe * fermetureSymEfficace(graphe * g);
+void fermetureSymDans(graphe * g, graphe * g_1);
 booleen * CC(graphe* G, int x);
 int Partitionner(int *A, double *T, int p, int r);
 int PartitionStochastique(int *A, double *T, int p, int r);
 void TriRapideStochastique (int * A, double *T, int p, int r);
 int* triAretes(graphe *Gp);
 graphe* initGraphMin(graphe* G,double* poidsArbreMin);
-int isConnexe(graphe* G, int x);
\ No newline at end of file
+int isConnexe(graphe* G, int x);
+
+#endif /* KRUSKAL_H */
@@ -0,0 +1,311 @@
+/*! \file lot.c
+    \brief résolution par lots : un graphe chargé une fois, un flot de requêtes résolues par un groupe de threads
+
+    Usage : AEtoile.exe batch graphe [requetes|-] [options]
+      --threads n          nombre de threads de résolution (défaut : nombre de processeurs)
+      --heuristique h      heuristique de toutes les requêtes (défaut : 3)
+      --metrique           distances de plus court chemin (voir fermeture.c) ; les tournées
+                           sont alors écrites dépliées en chemins routiers
+      --floyd              comme --metrique, distances calculées par Floyd-Warshall (voir floyd.c)
+
+    Chaque ligne de requêtes est "depart ville ville ..." (indices du graphe de base) ;
+    la ville de départ est ajoutée à l'ensemble si elle n'y figure pas, les doublons
+    sont ignorés, une ligne réduite au départ désigne toutes les villes du graphe.
+    Les lignes vides et celles qui commencent par # sont ignorées.
+
+    Chaque requête produit une ligne, dans l'ordre des requêtes :
+      numero cout ville ville ... ville   (tournée fermée ou chemin routier, dans les indices de base)
+      numero -1                           (pas de solution ou requête invalide)
+*/
+#include "lot.h"
+#include "floyd.h"
+#include <unistd.h>
+
+/* ====================================================================== */
+/*! \fn int LitRequeteLot(char *ligne, int nsom, int *marque, RequeteLot *r)
+    \param ligne : texte de la requête
+    \param nsom : nombre de villes du graphe de base
+    \param marque : tableau de nsom entiers nuls (rendu nul)
+    \param r : requête à remplir (villes est alloué ici)
+    \return 1 si une requête a été lue, 0 si la ligne est vide ou un commentaire, -1 si elle est invalide
+    \brief analyse une ligne "depart ville ville ..."
+*/
+int LitRequeteLot(char *ligne, int nsom, int *marque, RequeteLot *r){
+  char *p = ligne, *fin;
+  long v;
+  int i, ok = 1;
+
+  while ((*p == ' ') || (*p == '\t')) p++;
+  if ((*p == '\0') || (*p == '\n') || (*p == '\r') || (*p == '#')) return 0;
+
+  r->villes = (int *)malloc(nsom * sizeof(int));
+  if (r->villes == NULL)
+  {   fprintf(stderr, "LitRequeteLot : malloc failed\n");
+      exit(0);
+  }
+  r->k = 0;
+  r->cout = -1;
+  r->tournee = NULL;
+  r->longueur = 0;
+  r->interrompue = 0;
+  r->resolue = 0;
+
+  for (;;){
+    v = strtol(p, &fin, 10);
+    if (fin == p) break;
+    p = fin;
+    if ((v < 0) || (v >= nsom)){ ok = 0; continue; }
+    if (marque[v]) continue;
+    marque[v] = 1;
+    r->villes[r->k++] = (int)v;
+  }
+  while ((*p == ' ') || (*p == '\t') || (*p == '\n') || (*p == '\r')) p++;
+  if (*p != '\0') ok = 0;
+
+  if (ok && (r->k == 1)){ /* départ seul : toutes les villes */
+    for (i = 0; i < nsom; i++)
+      if (!marque[i]){
+        marque[i] = 1;
+        r->villes[r->k++] = i;
+      }
+  }
+  for (i = 0; i < r->k; i++) marque[r->villes[i]] = 0;
+  if (!ok || (r->k == 0)){
+    r->k = 0;
+    return -1;
+  }
+  return 1;
+}
+
+/* ====================================================================== */
+/*! \fn void ResoutRequeteLot(ContexteSolveur *base, OptionsSolveur *options, EspaceTravail *ws, RequeteLot *r)
+    \param base : contexte du graphe de base (lecture seule)
+    \param options : heuristique et échéance à utiliser
+    \param ws : espace de travail du thread
+    \param r : requête ; cout, tournee, longueur et interrompue sont remplis
+    \brief résout la requête sur la vue du sous-problème induit par ses villes ;
+           si le contexte de base est métrique, la tournée est dépliée en chemin routier
+*/
+void ResoutRequeteLot(ContexteSolveur *base, OptionsSolveur *options, EspaceTravail *ws, RequeteLot *r){
+  ContexteSolveur *ctx;
+  OptionsSolveur opt = *options;
+  pnode res;
+  int i;
+
+  r->cout = -1;
+  r->tournee = NULL;
+  r->longueur = 0;
+  r->interrompue = 0;
+  if (r->k == 0) return;
+
+  opt.depart = 0;
+  ctx = ContexteInduit(base, r->villes, r->k, &opt);
+  res = Resoudre(ctx, &opt, ws, NULL);
+  if (res != NULL){
+    r->cout = res->estim_g;
+    r->tournee = (int *)malloc(res->len * sizeof(int));
+    if (r->tournee == NULL)
+    {   fprintf(stderr, "ResoutRequeteLot : malloc failed\n");
+        exit(0);
+    }
+    for (i = 0; i < res->len; i++) r->tournee[i] = r->villes[res->listsom[i]];
+    r->longueur = res->len;
+    freeNode(res);
+    if (base->metrique){
+      int *chemin = DeplieTournee(base, r->tournee, r->longueur, &(r->longueur));
+      free(r->tournee);
+      r->tournee = chemin;
+    }
+  }
+  r->interrompue = ws->stats.interrompue;
+  TermineContexte(ctx);
+}
+
+/* ====================================================================== */
+/*! \fn void EcritRequeteLot(FILE *f, RequeteLot *r)
+    \param f : fichier de sortie
+    \param r : requête résolue
+    \brief écrit la ligne de résultat de la requête et libère ses tableaux
+*/
+void EcritRequeteLot(FILE *f, RequeteLot *r){
+  int i;
+
+  fprintf(f, "%ld %ld", r->numero, r->cout);
+  if (r->tournee != NULL)
+    for (i = 0; i < r->longueur; i++) fprintf(f, " %d", r->tournee[i]);
+  fprintf(f, "\n");
+  free(r->villes);
+  free(r->tournee);
+  r->villes = NULL;
+  r->tournee = NULL;
+}
+
+/* ====================================================================== */
+/*! \fn static void EcritResolues(FileLot *q)
+    \param q : la file (verrouillée par l'appelant)
+    \brief écrit, dans l'ordre, les résultats des plus anciennes requêtes déjà résolues
+*/
+static void EcritResolues(FileLot *q){
+  int ecrit = 0;
+  while ((q->premiere < q->suivante) && q->fenetre[q->premiere % q->taille].resolue){
+    EcritRequeteLot(stdout, &(q->fenetre[q->premiere % q->taille]));
+    q->premiere++;
+    ecrit = 1;
+  }
+  if (ecrit) fflush(stdout);
+}
+
+/* ====================================================================== */
+/*! \fn static void * TravailleurLot(void *arg)
+    \param arg : la file partagée
+    \brief boucle d'un thread : prend la plus ancienne requête non prise et la résout
+*/
+static void * TravailleurLot(void *arg){
+  FileLot *q = (FileLot *)arg;
+  EspaceTravail *ws = CreeEspaceTravail();
+  RequeteLot *r;
+
+  for (;;){
+    pthread_mutex_lock(&(q->verrou));
+    while ((q->a_traiter == q->suivante) && !q->fin)
+      pthread_cond_wait(&(q->travail), &(q->verrou));
+    if (q->a_traiter == q->suivante){ /* fin de l'entrée et plus rien à prendre */
+      pthread_mutex_unlock(&(q->verrou));
+      break;
+    }
+    r = &(q->fenetre[q->a_traiter % q->taille]);
+    q->a_traiter++;
+    pthread_mutex_unlock(&(q->verrou));
+
+    ResoutRequeteLot(q->base, &(q->options), ws, r);
+
+    pthread_mutex_lock(&(q->verrou));
+    r->resolue = 1;
+    pthread_cond_signal(&(q->resolue));
+    pthread_mutex_unlock(&(q->verrou));
+  }
+
+  TermineEspaceTravail(ws);
+  return NULL;
+}
+
+/* ====================================================================== */
+/*! \fn int ModeLot(int argc, char **argv)
+    \param argc : nombre d'arguments (après "batch")
+    \param argv : arguments (après "batch")
+    \return 0 si tout s'est bien passé
+    \brief point d'entrée de "AEtoile.exe batch" (voir l'en-tête du fichier)
+*/
+int ModeLot(int argc, char **argv){
+  char *nomgraphe = NULL, *nomrequetes = NULL;
+  int nthreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+  int heuristique = 3, metrique = 0;
+  int i, lu, *marque;
+  FILE *entree;
+  graphe *G;
+  FileLot q;
+  pthread_t *threads;
+  char *ligne = NULL;
+  size_t capacite = 0;
+  long long debut, invalides = 0;
+
+  for (i = 0; i < argc; i++){
+    if (!strcmp(argv[i], "--threads") && (i + 1 < argc)) nthreads = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--heuristique") && (i + 1 < argc)) heuristique = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--metrique")) metrique = 1;
+    else if (!strcmp(argv[i], "--floyd")) metrique = 2;
+    else if (nomgraphe == NULL) nomgraphe = argv[i];
+    else if (nomrequetes == NULL) nomrequetes = argv[i];
+    else {
+      fprintf(stderr, "batch : argument inconnu %s\n", argv[i]);
+      return 1;
+    }
+  }
+  if (nomgraphe == NULL){
+    fprintf(stderr, "Usage : ./AEtoile.exe batch graphe [requetes|-] [--threads n] [--heuristique h] [--metrique|--floyd]\n");
+    return 1;
+  }
+  if ((heuristique < 1) || (heuristique > 3)){
+    fprintf(stderr, "batch : heuristique inconnue %d\n", heuristique);
+    return 1;
+  }
+  if (nthreads < 1) nthreads = 1;
+
+  if ((nomrequetes == NULL) || !strcmp(nomrequetes, "-")) entree = stdin;
+  else if ((entree = fopen(nomrequetes, "r")) == NULL){
+    fprintf(stderr, "batch : impossible d'ouvrir %s\n", nomrequetes);
+    return 1;
+  }
+
+  debut = horloge_ns();
+  if ((G = ReadGraphe(nomgraphe)) == NULL){
+    if (entree != stdin) fclose(entree);
+    return 1;
+  }
+  memset(&q, 0, sizeof(FileLot));
+  OptionsParDefaut(&(q.options));
+  q.options.heuristique = heuristique;
+  if (metrique == 2) q.base = ContexteFloyd(G, &(q.options));
+  else q.base = metrique ? ContexteMetrique(G, &(q.options)) : CreeContexte(G, &(q.options));
+  q.taille = 4 * nthreads;
+  q.fenetre = (RequeteLot *)calloc(q.taille, sizeof(RequeteLot));
+  marque = (int *)calloc(G->nsom, sizeof(int));
+  threads = (pthread_t *)malloc(nthreads * sizeof(pthread_t));
+  if ((q.fenetre == NULL) || (marque == NULL) || (threads == NULL))
+  {   fprintf(stderr, "ModeLot : malloc failed\n");
+      exit(0);
+  }
+  pthread_mutex_init(&(q.verrou), NULL);
+  pthread_cond_init(&(q.travail), NULL);
+  pthread_cond_init(&(q.resolue), NULL);
+  for (i = 0; i < nthreads; i++)
+    pthread_create(&threads[i], NULL, TravailleurLot, &q);
+
+  while (getline(&ligne, &capacite, entree) != -1){
+    RequeteLot r;
+    lu = LitRequeteLot(ligne, G->nsom, marque, &r);
+    if (lu == 0) continue;
+    if (lu < 0){
+      fprintf(stderr, "batch : requête %ld invalide : %s", q.suivante, ligne);
+      invalides++;
+    }
+
+    pthread_mutex_lock(&(q.verrou));
+    EcritResolues(&q);
+    while (q.suivante - q.premiere == q.taille){ /* fenêtre pleine */
+      pthread_cond_wait(&(q.resolue), &(q.verrou));
+      EcritResolues(&q);
+    }
+    r.numero = q.suivante; /* une requête invalide (k = 0) sort avec le coût -1 */
+    q.fenetre[q.suivante % q.taille] = r;
+    q.suivante++;
+    pthread_cond_signal(&(q.travail));
+    pthread_mutex_unlock(&(q.verrou));
+  }
+
+  pthread_mutex_lock(&(q.verrou));
+  q.fin = 1;
+  pthread_cond_broadcast(&(q.travail));
+  EcritResolues(&q);
+  while (q.premiere < q.suivante){
+    pthread_cond_wait(&(q.resolue), &(q.verrou));
+    EcritResolues(&q);
+  }
+  pthread_mutex_unlock(&(q.verrou));
+  for (i = 0; i < nthreads; i++) pthread_join(threads[i], NULL);
+
+  fprintf(stderr, "batch : %ld requêtes (%lld invalides), %d threads, %.3f s\n",
+          q.suivante, invalides, nthreads, (horloge_ns() - debut) / 1e9);
+
+  pthread_mutex_destroy(&(q.verrou));
+  pthread_cond_destroy(&(q.travail));
+  pthread_cond_destroy(&(q.resolue));
+  if (entree != stdin) fclose(entree);
+  free(ligne);
+  free(threads);
+  free(marque);
+  free(q.fenetre);
+  TermineContexte(q.base);
+  TermineGraphe(G);
+  return 0;
+}
@@ -0,0 +1,66 @@
+/*! \file lot.h
+    \brief résolution par lots : un graphe chargé une fois, un flot de requêtes résolues par un groupe de threads
+*/
+#ifndef LOT_H
+#define LOT_H
+
+#include "vdc.h"
+#include <pthread.h>
+
+/*! \struct RequeteLot
+    \brief une requête : un sous-ensemble de villes du graphe de base et sa ville de départ
+*/
+typedef struct RequeteLot {
+//! numéro de la requête dans le flot d'entrée (à partir de 0)
+  long numero;
+//! villes du graphe de base, villes[0] est la ville de départ
+  int *villes;
+//! nombre de villes
+  int k;
+//! coût de la tournée, -1 si pas de solution
+  long cout;
+//! tournée dans les indices du graphe de base, départ répété à la fin ; NULL si pas de solution
+  int *tournee;
+//! nombre de villes de tournee : k+1, ou plus si la tournée est dépliée en chemin routier
+  int longueur;
+//! 1 si la recherche a été abandonnée à l'échéance
+  int interrompue;
+//! 1 quand la requête est résolue
+  int resolue;
+} RequeteLot;
+
+/*! \struct FileLot
+    \brief fenêtre circulaire des requêtes en cours, partagée entre le lecteur et les threads.
+           La requête de numéro r occupe la case r % taille ; les résultats sont
+           écrits dans l'ordre des numéros, dès que la plus ancienne requête est résolue.
+*/
+typedef struct FileLot {
+  pthread_mutex_t verrou;
+//! signalée quand une requête arrive ou quand l'entrée est terminée
+  pthread_cond_t travail;
+//! signalée quand une requête est résolue
+  pthread_cond_t resolue;
+//! cases de la fenêtre
+  RequeteLot *fenetre;
+//! nombre de cases
+  int taille;
+//! plus ancienne requête dont le résultat n'est pas encore écrit
+  long premiere;
+//! prochaine requête qui n'a pas encore été lue
+  long suivante;
+//! prochaine requête qu'aucun thread n'a encore prise
+  long a_traiter;
+//! vrai quand l'entrée est épuisée
+  int fin;
+//! contexte du graphe de base (lecture seule)
+  ContexteSolveur *base;
+//! options communes à toutes les requêtes (la ville de départ est celle de la requête)
+  OptionsSolveur options;
+} FileLot;
+
+int LitRequeteLot(char *ligne, int nsom, int *marque, RequeteLot *r);
+void ResoutRequeteLot(ContexteSolveur *base, OptionsSolveur *options, EspaceTravail *ws, RequeteLot *r);
+void EcritRequeteLot(FILE *f, RequeteLot *r);
+int ModeLot(int argc, char **argv);
+
+#endif /* LOT_H */
@@ -0,0 +1,172 @@
+/*! \file minorant.c
+    \brief heuristique 1 vectorisée (voir minorant.h)
+
+    L'heuristique 1 d'un noeud est g plus la somme des arêtes minimum (ctx->arcmin) des
+    villes qu'il n'a pas visitées. ComputeH la calculait ville par ville avec NotInListSom,
+    qui parcourt la liste du noeud. Avec le masque des villes visitées (voir
+    successeurs.h), c'est une somme horizontale masquée : 8 villes par pas en AVX-512
+    (chargement masqué, ce qui traite aussi la fin de la ligne), 4 en AVX2 (le quartet du
+    masque est étendu en 4 masques de 64 bits).
+
+    Les successeurs d'un noeud ne diffèrent de lui que par leur dernière ville v : leur
+    somme est celle du noeud moins arcmin[v]. MinorantsH1 évalue donc tous les
+    successeurs d'un coup, f = g + base - arcmin[v], avec un chargement indexé (gather)
+    des arcmin[v] ; DevelopNode y prépare base une fois par noeud.
+*/
+#include "minorant.h"
+#include <string.h>
+
+// les noyaux lisent les long par lanes de 64 bits : x86-64 seulement (long fait 4 octets en i386)
+#if defined(__x86_64__)
+#include <immintrin.h>
+
+/* ====================================================================== */
+/*! \fn static long SommeLibresAVX512(const long *arcmin, const unsigned long long *visite, int nsom)
+    \brief noyau AVX-512 de SommeLibres, par blocs de 8 villes
+*/
+__attribute__((target("avx512f")))
+static long SommeLibresAVX512(const long *arcmin, const unsigned long long *visite, int nsom){
+  __m512i somme = _mm512_setzero_si512();
+  __mmask8 libres;
+  long t[8];
+  int i;
+
+  for (i = 0; i < nsom; i += 8){
+    // i est multiple de 8 : l'octet ne chevauche pas deux mots du masque
+    libres = (__mmask8)~(visite[i >> 6] >> (i & 63));
+    if (nsom - i < 8) libres &= (__mmask8)((1u << (nsom - i)) - 1);
+    somme = _mm512_add_epi64(somme, _mm512_maskz_loadu_epi64(libres, arcmin + i));
+  }
+  _mm512_storeu_si512((void *)t, somme);
+  return t[0] + t[1] + t[2] + t[3] + t[4] + t[5] + t[6] + t[7];
+}
+
+/* ====================================================================== */
+/*! \fn static long SommeLibresAVX2(const long *arcmin, const unsigned long long *visite, int nsom)
+    \brief noyau AVX2 de SommeLibres, par blocs de 4 villes (le reste en scalaire)
+*/
+__attribute__((target("avx2")))
+static long SommeLibresAVX2(const long *arcmin, const unsigned long long *visite, int nsom){
+  const __m256i bits = _mm256_set_epi64x(8, 4, 2, 1), zero = _mm256_setzero_si256();
+  __m256i somme = zero, visitees;
+  long t[4], s;
+  int i;
+
+  for (i = 0; i + 4 <= nsom; i += 4){
+    // lanes des villes non visitées : bit du quartet à 0
+    visitees = _mm256_and_si256(_mm256_set1_epi64x((long long)(visite[i >> 6] >> (i & 63))), bits);
+    somme = _mm256_add_epi64(somme, _mm256_and_si256(_mm256_cmpeq_epi64(visitees, zero),
+                                                     _mm256_loadu_si256((const __m256i *)(arcmin + i))));
+  }
+  _mm256_storeu_si256((__m256i *)t, somme);
+  s = t[0] + t[1] + t[2] + t[3];
+  for (; i < nsom; i++)
+    if (!((visite[i >> 6] >> (i & 63)) & 1)) s += arcmin[i];
+  return s;
+}
+
+/* ====================================================================== */
+/*! \fn static void MinorantsH1AVX512(const long *arcmin, long base, const int *villes, const long *couts, int nsucc, long *f)
+    \brief noyau AVX-512 de MinorantsH1, par blocs de 8 successeurs
+*/
+__attribute__((target("avx512f")))
+static void MinorantsH1AVX512(const long *arcmin, long base, const int *villes, const long *couts, int nsucc,
+                              long *f){
+  const __m512i b = _mm512_set1_epi64(base);
+  __mmask8 m;
+  __m512i a, c;
+  __m256i indices;
+  int k, fin[8];
+
+  for (k = 0; k < nsucc; k += 8){
+    m = (nsucc - k < 8) ? (__mmask8)((1u << (nsucc - k)) - 1) : (__mmask8)0xFF;
+    if (nsucc - k >= 8) indices = _mm256_loadu_si256((const __m256i *)(villes + k));
+    else { // dernier bloc : indices recopiés dans un tampon complété par des zéros
+      memset(fin, 0, sizeof(fin));
+      memcpy(fin, villes + k, (nsucc - k) * sizeof(int));
+      indices = _mm256_loadu_si256((const __m256i *)fin);
+    }
+    a = _mm512_mask_i32gather_epi64(_mm512_setzero_si512(), m, indices, arcmin, 8);
+    c = _mm512_maskz_loadu_epi64(m, couts + k);
+    _mm512_mask_storeu_epi64(f + k, m, _mm512_sub_epi64(_mm512_add_epi64(c, b), a));
+  }
+}
+
+/* ====================================================================== */
+/*! \fn static void MinorantsH1AVX2(const long *arcmin, long base, const int *villes, const long *couts, int nsucc, long *f)
+    \brief noyau AVX2 de MinorantsH1, par blocs de 4 successeurs (le reste en scalaire)
+*/
+__attribute__((target("avx2")))
+static void MinorantsH1AVX2(const long *arcmin, long base, const int *villes, const long *couts, int nsucc,
+                            long *f){
+  const __m256i b = _mm256_set1_epi64x(base);
+  __m256i a, c;
+  int k;
+
+  for (k = 0; k + 4 <= nsucc; k += 4){
+    a = _mm256_i32gather_epi64((const long long *)arcmin, _mm_loadu_si128((const __m128i *)(villes + k)), 8);
+    c = _mm256_loadu_si256((const __m256i *)(couts + k));
+    _mm256_storeu_si256((__m256i *)(f + k), _mm256_sub_epi64(_mm256_add_epi64(c, b), a));
+  }
+  for (; k < nsucc; k++) f[k] = couts[k] + base - arcmin[villes[k]];
+}
+#endif
+
+/* ====================================================================== */
+/*! \fn long SommeLibresScalaire(const long *arcmin, const unsigned long long *visite, int nsom)
+    \brief version scalaire de SommeLibres
+*/
+long SommeLibresScalaire(const long *arcmin, const unsigned long long *visite, int nsom){
+  long s = 0;
+  int i;
+  for (i = 0; i < nsom; i++)
+    if (!((visite[i >> 6] >> (i & 63)) & 1)) s += arcmin[i];
+  return s;
+}
+
+/* ====================================================================== */
+/*! \fn long SommeLibres(const long *arcmin, const unsigned long long *visite, int nsom)
+    \param arcmin : arête minimum de chaque ville (ctx->arcmin)
+    \param visite : masque des villes visitées (MOTS_MASQUE(nsom) mots)
+    \param nsom : nombre de villes
+    \return la somme des arcmin des villes non visitées
+*/
+long SommeLibres(const long *arcmin, const unsigned long long *visite, int nsom){
+#if defined(__x86_64__)
+  if (__builtin_cpu_supports("avx512f")) return SommeLibresAVX512(arcmin, visite, nsom);
+  if (__builtin_cpu_supports("avx2")) return SommeLibresAVX2(arcmin, visite, nsom);
+#endif
+  return SommeLibresScalaire(arcmin, visite, nsom);
+}
+
+/* ====================================================================== */
+/*! \fn void MinorantsH1Scalaire(const long *arcmin, long base, const int *villes, const long *couts, int nsucc, long *f)
+    \brief version scalaire de MinorantsH1
+*/
+void MinorantsH1Scalaire(const long *arcmin, long base, const int *villes, const long *couts, int nsucc, long *f){
+  int k;
+  for (k = 0; k < nsucc; k++) f[k] = couts[k] + base - arcmin[villes[k]];
+}
+
+/* ====================================================================== */
+/*! \fn void MinorantsH1(const long *arcmin, long base, const int *villes, const long *couts, int nsucc, long *f)
+    \param arcmin : arête minimum de chaque ville (ctx->arcmin)
+    \param base : somme des arcmin des villes libres du noeud père (plus celle du départ si
+                  ses successeurs n'attendent plus que le retour)
+    \param villes, couts : les nsucc successeurs produits par Successeurs
+    \param f : reçoit l'évaluation de chaque successeur, couts[k] + base - arcmin[villes[k]]
+    \brief heuristique 1 de tous les successeurs d'un noeud
+*/
+void MinorantsH1(const long *arcmin, long base, const int *villes, const long *couts, int nsucc, long *f){
+#if defined(__x86_64__)
+  if (__builtin_cpu_supports("avx512f")){
+    MinorantsH1AVX512(arcmin, base, villes, couts, nsucc, f);
+    return;
+  }
+  if (__builtin_cpu_supports("avx2")){
+    MinorantsH1AVX2(arcmin, base, villes, couts, nsucc, f);
+    return;
+  }
+#endif
+  MinorantsH1Scalaire(arcmin, base, villes, couts, nsucc, f);
+}
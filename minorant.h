@@ -0,0 +1,16 @@
+/*! \file minorant.h
+    \brief heuristique 1 vectorisée : somme des arêtes minimum des villes non visitées,
+           pour un noeud ou pour tous les successeurs d'un noeud à la fois (AVX-512 ou
+           AVX2 selon le processeur, scalaire sinon)
+*/
+#ifndef MINORANT_H
+#define MINORANT_H
+
+#include "successeurs.h"
+
+long SommeLibresScalaire(const long *arcmin, const unsigned long long *visite, int nsom);
+long SommeLibres(const long *arcmin, const unsigned long long *visite, int nsom);
+void MinorantsH1Scalaire(const long *arcmin, long base, const int *villes, const long *couts, int nsucc, long *f);
+void MinorantsH1(const long *arcmin, long base, const int *villes, const long *couts, int nsucc, long *f);
+
+#endif /* MINORANT_H */
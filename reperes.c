@@ -0,0 +1,441 @@
+/*! \file reperes.c
+    \brief estimation ALT (A*, repères, inégalité triangulaire) : minorants des distances
+           tirés des distances précalculées depuis et vers quelques sommets repères
+
+    Pour un repère L, l'inégalité triangulaire donne d(x,t) >= d(L,t) - d(L,x) et
+    d(x,t) >= d(x,L) - d(t,L) ; le maximum sur les repères est un minorant monotone,
+    utilisable par A* sur les graphes sans coordonnées (les cartes carte_france_* n'ont
+    que des noms de sommets). EstimationDistance le combine avec l'écart des coordonnées
+    quand le réseau en a.
+
+    Choix des repères :
+      - aléatoires ;
+      - éloignés : le premier est le sommet le plus éloigné d'un sommet tiré au hasard,
+        chacun des suivants maximise la distance au plus proche des repères déjà choisis ;
+      - évitement ("avoid", Goldberg et Werneck) : dans un arbre de plus courts chemins
+        issu d'un sommet tiré au hasard, chaque sommet pèse l'écart entre sa distance et
+        le minorant des repères déjà choisis ; on descend depuis le sous-arbre le plus
+        lourd qui ne contient aucun repère, en suivant le fils le plus lourd, jusqu'à une
+        feuille, qui devient le repère suivant.
+    Les deux derniers choix sont séquentiels (chaque repère dépend des distances des
+    précédents) ; les distances qu'ils n'ont pas calculées (toutes pour les repères
+    aléatoires, celles vers les repères sur un réseau orienté) le sont ensuite en
+    parallèle, un Dijkstra par repère et par sens.
+
+    Les distances sont rangées par sommet sur 32 bits : les k distances d'un sommet
+    tiennent dans une ligne de cache pour k = 16. Le fichier des repères (EcritReperes)
+    a la même disposition que la mémoire, et LitReperes le projette en mémoire (mmap)
+    sans le recopier.
+*/
+#include "reperes.h"
+#include "graphaux.h"
+#include <omp.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/*! \def REPERES_MAGIQUE
+    \brief en-tête des fichiers de repères (8 octets)
+*/
+#define REPERES_MAGIQUE "AEREPE01"
+
+/*! \def REPERES_ALIGNEMENT
+    \brief taille de l'en-tête du fichier, et alignement des tableaux qui le suivent
+*/
+#define REPERES_ALIGNEMENT 64
+
+/*! \def Aligne(n)
+    \brief n arrondi au multiple de REPERES_ALIGNEMENT supérieur
+*/
+#define Aligne(n) ((((n) + REPERES_ALIGNEMENT - 1) / REPERES_ALIGNEMENT) * REPERES_ALIGNEMENT)
+
+/* ====================================================================== */
+/* ====================================================================== */
+/* CHOIX DES REPERES */
+/* ====================================================================== */
+/* ====================================================================== */
+
+/* ====================================================================== */
+/*! \fn static Reperes* AlloueReperes(int nsom, int narc_graphe, int k, int oriente)
+    \return des tables de repères non remplies
+*/
+static Reperes* AlloueReperes(int nsom, int narc_graphe, int k, int oriente){
+  Reperes *rp = (Reperes *)calloc(1, sizeof(Reperes));
+  long taille = (long)nsom * k;
+
+  if (rp == NULL)
+  {   fprintf(stderr, "AlloueReperes : calloc failed\n");
+      exit(0);
+  }
+  rp->nsom = nsom;
+  rp->narc_graphe = narc_graphe;
+  rp->nreperes = k;
+  rp->oriente = oriente;
+  rp->sommets = (int *)malloc(((k > 0) ? k : 1) * sizeof(int));
+  rp->depuis = (unsigned int *)malloc(((taille > 0) ? taille : 1) * sizeof(unsigned int));
+  rp->vers = oriente ? (unsigned int *)malloc(((taille > 0) ? taille : 1) * sizeof(unsigned int)) : rp->depuis;
+  if ((rp->sommets == NULL) || (rp->depuis == NULL) || (rp->vers == NULL))
+  {   fprintf(stderr, "AlloueReperes : malloc failed\n");
+      exit(0);
+  }
+  return rp;
+}
+
+/* ====================================================================== */
+/*! \fn static void DistancesRepere(ReseauRoutier *r, RechercheChemin *rc, int l, int vers, unsigned int *colonne)
+    \param r : un réseau
+    \param rc : tampons de la recherche (un par thread)
+    \param l : un repère
+    \param vers : si non nul, distances de chaque sommet à l (Dijkstra sur le réseau inverse),
+                  sinon distances de l à chaque sommet
+    \param colonne : (sortie) les r->g->nsom distances, REPERE_INFINI pour les sommets non reliés
+*/
+static void DistancesRepere(ReseauRoutier *r, RechercheChemin *rc, int l, int vers, unsigned int *colonne){
+  ReseauRoutier inverse = *r;
+  int x;
+  long d;
+
+  inverse.g = r->inverse; /* sans estimation, Dijkstra ne lit que les successeurs */
+  DijkstraToutes(vers ? &inverse : r, rc, l);
+  for (x = 0; x < r->g->nsom; x++){
+    d = DistanceAtteinte(rc, x);
+    if (d >= (long)REPERE_INFINI){
+      fprintf(stderr, "ChoisitReperes : distance %ld trop grande pour les tables 32 bits\n", d);
+      exit(0);
+    }
+    colonne[x] = (d < 0) ? REPERE_INFINI : (unsigned int)d;
+  }
+}
+
+/* ====================================================================== */
+/*! \fn static int SommetEloigne(unsigned int *eloignement, char *repere, int n)
+    \return le sommet de plus grand eloignement qui n'est pas un repère (les sommets non
+            reliés, à REPERE_INFINI, d'abord), -1 s'il n'y en a pas
+*/
+static int SommetEloigne(unsigned int *eloignement, char *repere, int n){
+  int x, choisi = -1;
+  for (x = 0; x < n; x++)
+    if (!repere[x] && ((choisi < 0) || (eloignement[x] > eloignement[choisi]))) choisi = x;
+  return choisi;
+}
+
+/* ====================================================================== */
+/*! \fn static int RepereEvitement(ReseauRoutier *r, RechercheChemin *rc, unsigned int **colonnes, int nchoisis, char *repere, int racine, long *poids, int *nfils, int *debut, int *fils)
+    \param colonnes : distances depuis les nchoisis repères déjà choisis
+    \param repere : repere[x] non nul si x est déjà un repère
+    \param racine : racine de l'arbre de plus courts chemins
+    \param poids, nfils, debut, fils : tableaux de travail de r->g->nsom éléments (+1 pour debut)
+    \return le repère suivant de la stratégie "avoid", -1 si l'arbre est entièrement couvert
+*/
+static int RepereEvitement(ReseauRoutier *r, RechercheChemin *rc, unsigned int **colonnes, int nchoisis, char *repere,
+                           int racine, long *poids, int *nfils, int *debut, int *fils){
+  int n = r->g->nsom, i, j, l, x, p, choisi;
+  long borne, e;
+
+  DijkstraToutes(r, rc, racine);
+  for (x = 0; x < n; x++) nfils[x] = 0;
+  for (i = 0; i < rc->natteints; i++){
+    x = rc->atteints[i];
+    for (borne = 0, l = 0; l < nchoisis; l++){ /* minorant de d(racine, x) */
+      if ((colonnes[l][x] == REPERE_INFINI) || (colonnes[l][racine] == REPERE_INFINI)) continue;
+      e = (long)colonnes[l][x] - (long)colonnes[l][racine];
+      if (e > borne) borne = e;
+    }
+    poids[x] = rc->dist[x] - borne;
+    if (rc->pred[x] >= 0) nfils[rc->pred[x]]++;
+  }
+
+  /* fils de chaque sommet de l'arbre, rangés par parent */
+  debut[0] = 0;
+  for (x = 0; x < n; x++) debut[x + 1] = debut[x] + nfils[x];
+  for (i = 0; i < rc->natteints; i++){
+    x = rc->atteints[i];
+    if ((p = rc->pred[x]) >= 0) fils[debut[p] + --nfils[p]] = x;
+  }
+
+  /* poids des sous-arbres, des feuilles vers la racine (un sommet n'est traité qu'après tous
+     ses fils) ; -1 pour un sous-arbre qui contient un repère. rc->atteints sert de file. */
+  for (j = 0, i = 0; i < rc->natteints; i++){
+    x = rc->atteints[i];
+    nfils[x] = debut[x + 1] - debut[x];
+    if (repere[x]) poids[x] = -1;
+    if (nfils[x] == 0) rc->atteints[j++] = x;
+  }
+  for (i = 0; i < j; i++){
+    x = rc->atteints[i];
+    if ((p = rc->pred[x]) < 0) continue;
+    if (poids[x] < 0) poids[p] = -1;
+    else if (poids[p] >= 0) poids[p] += poids[x];
+    if (--nfils[p] == 0) rc->atteints[j++] = p;
+  }
+
+  /* descente depuis le sous-arbre le plus lourd, par le fils le plus lourd */
+  for (choisi = -1, i = 0; i < j; i++)
+    if ((poids[rc->atteints[i]] > 0) && ((choisi < 0) || (poids[rc->atteints[i]] > poids[choisi])))
+      choisi = rc->atteints[i];
+  if (choisi < 0) return -1;
+  while (debut[choisi + 1] > debut[choisi]){
+    x = fils[debut[choisi]];
+    for (i = debut[choisi] + 1; i < debut[choisi + 1]; i++)
+      if (poids[fils[i]] > poids[x]) x = fils[i];
+    choisi = x;
+  }
+  return choisi;
+}
+
+/* ====================================================================== */
+/*! \fn Reperes* ChoisitReperes(ReseauRoutier *r, int k, ChoixReperes choix, unsigned long long graine)
+    \param r : un réseau
+    \param k : nombre de repères (au plus le nombre de sommets)
+    \param choix : stratégie de choix des repères
+    \param graine : graine des tirages
+    \return les repères et leurs tables de distances
+    \brief les distances sont d'abord calculées par repère (une colonne de nsom distances
+           par repère et par sens), puis rangées par sommet
+*/
+Reperes* ChoisitReperes(ReseauRoutier *r, int k, ChoixReperes choix, unsigned long long graine){
+  int n = r->g->nsom, oriente = (r->inverse != r->g), ncolonnes, l, x, y;
+  unsigned int **colonnes;
+  char *repere;
+  RechercheChemin rc;
+  Reperes *rp;
+  Alea a;
+
+  k = max(1, min(k, n));
+  ncolonnes = oriente ? 2 * k : k;
+  rp = AlloueReperes(n, r->g->narc, k, oriente);
+  colonnes = (unsigned int **)malloc(ncolonnes * sizeof(unsigned int *));
+  repere = (char *)calloc(n + 1, sizeof(char));
+  if ((colonnes == NULL) || (repere == NULL))
+  {   fprintf(stderr, "ChoisitReperes : malloc failed\n");
+      exit(0);
+  }
+  for (l = 0; l < ncolonnes; l++){
+    colonnes[l] = (unsigned int *)malloc((n + 1) * sizeof(unsigned int));
+    if (colonnes[l] == NULL)
+    {   fprintf(stderr, "ChoisitReperes : malloc failed\n");
+        exit(0);
+    }
+  }
+  InitAlea(&a, graine);
+  InitRechercheChemin(&rc, n);
+
+  if (choix == REPERES_ALEATOIRES)
+    for (l = 0; l < k; l++){
+      do x = AleaEntier(&a, n); while (repere[x]);
+      repere[x] = 1;
+      rp->sommets[l] = x;
+    }
+  else if (choix == REPERES_ELOIGNES){
+    /* distance au plus proche repère (au sommet tiré au hasard avant le premier repère) */
+    unsigned int *eloignement = (unsigned int *)malloc((n + 1) * sizeof(unsigned int));
+    if (eloignement == NULL)
+    {   fprintf(stderr, "ChoisitReperes : malloc failed\n");
+        exit(0);
+    }
+    DistancesRepere(r, &rc, AleaEntier(&a, n), 0, eloignement);
+    for (l = 0; l < k; l++){
+      x = SommetEloigne(eloignement, repere, n);
+      if (x < 0) break; /* plus de sommet libre (impossible tant que k <= n) */
+      repere[x] = 1;
+      rp->sommets[l] = x;
+      DistancesRepere(r, &rc, x, 0, colonnes[l]);
+      for (y = 0; y < n; y++) eloignement[y] = (l > 0) ? min(eloignement[y], colonnes[l][y]) : colonnes[l][y];
+    }
+    free(eloignement);
+  }
+  else {
+    long *poids = (long *)malloc((n + 1) * sizeof(long));
+    int *nfils = (int *)malloc((n + 1) * sizeof(int));
+    int *debut = (int *)malloc((n + 1) * sizeof(int));
+    int *fils = (int *)malloc((n + 1) * sizeof(int));
+    if ((poids == NULL) || (nfils == NULL) || (debut == NULL) || (fils == NULL))
+    {   fprintf(stderr, "ChoisitReperes : malloc failed\n");
+        exit(0);
+    }
+    for (l = 0; l < k; l++){
+      x = RepereEvitement(r, &rc, colonnes, l, repere, AleaEntier(&a, n), poids, nfils, debut, fils);
+      if (x < 0) do x = AleaEntier(&a, n); while (repere[x]); /* arbre couvert : au hasard */
+      repere[x] = 1;
+      rp->sommets[l] = x;
+      DistancesRepere(r, &rc, x, 0, colonnes[l]);
+    }
+    free(poids);
+    free(nfils);
+    free(debut);
+    free(fils);
+  }
+  TermineRechercheChemin(&rc);
+
+  /* distances restantes, un Dijkstra par repère et par sens */
+#pragma omp parallel
+  {
+    RechercheChemin rcl;
+    int j;
+    InitRechercheChemin(&rcl, n);
+#pragma omp for schedule(dynamic, 1)
+    for (j = 0; j < ncolonnes; j++)
+      if ((j >= k) || (choix == REPERES_ALEATOIRES))
+        DistancesRepere(r, &rcl, rp->sommets[j % k], j >= k, colonnes[j]);
+    TermineRechercheChemin(&rcl);
+  }
+
+  /* rangement par sommet */
+#pragma omp parallel for private(l) schedule(static)
+  for (x = 0; x < n; x++)
+    for (l = 0; l < k; l++){
+      rp->depuis[(long)x * k + l] = colonnes[l][x];
+      if (oriente) rp->vers[(long)x * k + l] = colonnes[k + l][x];
+    }
+
+  for (l = 0; l < ncolonnes; l++) free(colonnes[l]);
+  free(colonnes);
+  free(repere);
+  return rp;
+}
+
+/* ====================================================================== */
+/*! \fn void TermineReperes(Reperes *rp)
+    \param rp : des repères (alloués par ChoisitReperes ou projetés par LitReperes)
+*/
+void TermineReperes(Reperes *rp){
+  if (rp->projection != NULL) munmap(rp->projection, rp->taille);
+  else {
+    if (rp->vers != rp->depuis) free(rp->vers);
+    free(rp->depuis);
+    free(rp->sommets);
+  }
+  free(rp);
+}
+
+/* ====================================================================== */
+/*! \fn long BorneReperes(Reperes *rp, int x, int t)
+    \param rp : des repères
+    \param x : un sommet
+    \param t : la cible
+    \return un minorant monotone de la distance de x à t : le plus grand des
+            d(L,t) - d(L,x) et d(x,L) - d(t,L) sur les repères L qui relient les sommets
+            concernés (|d(L,t) - d(L,x)| si le réseau n'est pas orienté)
+*/
+long BorneReperes(Reperes *rp, int x, int t){
+  int k = rp->nreperes, l;
+  unsigned int *dx = rp->depuis + (long)x * k, *dt = rp->depuis + (long)t * k;
+  long borne = 0, e;
+
+  for (l = 0; l < k; l++){
+    if ((dx[l] == REPERE_INFINI) || (dt[l] == REPERE_INFINI)) continue;
+    e = (long)dt[l] - (long)dx[l];
+    if (!rp->oriente && (e < 0)) e = -e;
+    if (e > borne) borne = e;
+  }
+  if (rp->oriente){
+    dx = rp->vers + (long)x * k;
+    dt = rp->vers + (long)t * k;
+    for (l = 0; l < k; l++){
+      if ((dx[l] == REPERE_INFINI) || (dt[l] == REPERE_INFINI)) continue;
+      e = (long)dx[l] - (long)dt[l];
+      if (e > borne) borne = e;
+    }
+  }
+  return borne;
+}
+
+/* ====================================================================== */
+/* ====================================================================== */
+/* FICHIERS */
+/* ====================================================================== */
+/* ====================================================================== */
+
+/* ====================================================================== */
+/*! \fn static size_t TailleFichierReperes(long nsom, long k, int oriente)
+    \return la taille en octets du fichier de repères
+*/
+static size_t TailleFichierReperes(long nsom, long k, int oriente){
+  return REPERES_ALIGNEMENT + Aligne(k * sizeof(int)) + (oriente ? 2 : 1) * nsom * k * sizeof(unsigned int);
+}
+
+/* ====================================================================== */
+/*! \fn int EcritReperes(Reperes *rp, char *nomfichier)
+    \param rp : des repères
+    \param nomfichier : fichier à écrire
+    \return 1 si le fichier est écrit, 0 sinon
+    \brief format binaire (ordre des octets de la machine), chaque partie alignée sur
+           REPERES_ALIGNEMENT octets : en-tête (REPERES_MAGIQUE, nsom, narc_graphe,
+           nreperes, oriente), sommets, depuis, puis vers si le réseau est orienté
+*/
+int EcritReperes(Reperes *rp, char *nomfichier){
+  FILE *fd = fopen(nomfichier, "wb");
+  static const char zeros[REPERES_ALIGNEMENT] = {0};
+  char entete[REPERES_ALIGNEMENT];
+  long n = (long)rp->nsom * rp->nreperes;
+  size_t remplissage = Aligne(rp->nreperes * sizeof(int)) - rp->nreperes * sizeof(int);
+  int ok;
+
+  if (fd == NULL){
+    fprintf(stderr, "EcritReperes : impossible d'ouvrir %s\n", nomfichier);
+    return 0;
+  }
+  memset(entete, 0, REPERES_ALIGNEMENT);
+  memcpy(entete, REPERES_MAGIQUE, 8);
+  memcpy(entete + 8, &(rp->nsom), sizeof(int));
+  memcpy(entete + 12, &(rp->narc_graphe), sizeof(int));
+  memcpy(entete + 16, &(rp->nreperes), sizeof(int));
+  memcpy(entete + 20, &(rp->oriente), sizeof(int));
+  ok = (fwrite(entete, 1, REPERES_ALIGNEMENT, fd) == REPERES_ALIGNEMENT) &&
+       (fwrite(rp->sommets, sizeof(int), rp->nreperes, fd) == (size_t)rp->nreperes) &&
+       (fwrite(zeros, 1, remplissage, fd) == remplissage) &&
+       (fwrite(rp->depuis, sizeof(unsigned int), n, fd) == (size_t)n) &&
+       (!rp->oriente || (fwrite(rp->vers, sizeof(unsigned int), n, fd) == (size_t)n));
+  if (fclose(fd) != 0) ok = 0;
+  if (!ok) fprintf(stderr, "EcritReperes : erreur d'écriture dans %s\n", nomfichier);
+  return ok;
+}
+
+/* ====================================================================== */
+/*! \fn Reperes* LitReperes(char *nomfichier)
+    \param nomfichier : fichier écrit par EcritReperes
+    \return les repères, dont les tables pointent dans le fichier projeté en mémoire
+            (lecture seule), NULL si le fichier est absent ou invalide
+*/
+Reperes* LitReperes(char *nomfichier){
+  int fd = open(nomfichier, O_RDONLY), entete[4];
+  struct stat infos;
+  char *p;
+  Reperes *rp;
+
+  if (fd < 0) return NULL;
+  if ((fstat(fd, &infos) != 0) || (infos.st_size < REPERES_ALIGNEMENT)){
+    close(fd);
+    fprintf(stderr, "LitReperes : fichier %s invalide\n", nomfichier);
+    return NULL;
+  }
+  p = (char *)mmap(NULL, infos.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (p == MAP_FAILED){
+    fprintf(stderr, "LitReperes : projection de %s impossible\n", nomfichier);
+    return NULL;
+  }
+  memcpy(entete, p + 8, 4 * sizeof(int));
+  if (memcmp(p, REPERES_MAGIQUE, 8) || (entete[0] < 0) || (entete[2] < 1) ||
+      ((size_t)infos.st_size != TailleFichierReperes(entete[0], entete[2], entete[3]))){
+    munmap(p, infos.st_size);
+    fprintf(stderr, "LitReperes : fichier %s invalide\n", nomfichier);
+    return NULL;
+  }
+  rp = (Reperes *)calloc(1, sizeof(Reperes));
+  if (rp == NULL)
+  {   fprintf(stderr, "LitReperes : calloc failed\n");
+      exit(0);
+  }
+  rp->nsom = entete[0];
+  rp->narc_graphe = entete[1];
+  rp->nreperes = entete[2];
+  rp->oriente = entete[3] != 0;
+  rp->projection = p;
+  rp->taille = infos.st_size;
+  rp->sommets = (int *)(p + REPERES_ALIGNEMENT);
+  rp->depuis = (unsigned int *)(p + REPERES_ALIGNEMENT + Aligne(rp->nreperes * sizeof(int)));
+  rp->vers = rp->oriente ? rp->depuis + (long)rp->nsom * rp->nreperes : rp->depuis;
+  return rp;
+}
@@ -0,0 +1,63 @@
+/*! \file reperes.h
+    \brief estimation ALT (A*, repères, inégalité triangulaire) : minorants des distances
+           tirés des distances précalculées depuis et vers quelques sommets repères
+*/
+#ifndef REPERES_H
+#define REPERES_H
+
+#include "chemins.h"
+
+/*! \def REPERES_DEFAUT
+    \brief nombre de repères par défaut
+*/
+#define REPERES_DEFAUT 16
+
+/*! \def REPERE_INFINI
+    \brief distance entre un repère et un sommet qu'il ne relie pas
+*/
+#define REPERE_INFINI 0xffffffffu
+
+/*! \enum ChoixReperes
+    \brief stratégie de choix des repères
+*/
+typedef enum ChoixReperes {
+//! tirés au hasard
+  REPERES_ALEATOIRES,
+//! chaque repère est le sommet le plus éloigné des repères déjà choisis
+  REPERES_ELOIGNES,
+//! "avoid" : feuille du sous-arbre le moins bien couvert d'un arbre de plus courts chemins
+  REPERES_EVITEMENT
+} ChoixReperes;
+
+/*! \struct Reperes
+    \brief tables des distances aux repères, rangées par sommet (les k distances d'un sommet
+           sont contiguës) ; en lecture seule, partagées entre threads
+*/
+typedef struct Reperes {
+//! nombre de sommets
+  int nsom;
+//! nombre d'arcs du réseau (contrôle à la lecture)
+  int narc_graphe;
+//! nombre de repères k
+  int nreperes;
+//! non nul si les distances vers les repères sont différentes des distances depuis
+  int oriente;
+//! les k repères
+  int *sommets;
+//! depuis[x * k + l] : distance du repère l à x, REPERE_INFINI s'il ne l'atteint pas
+  unsigned int *depuis;
+//! vers[x * k + l] : distance de x au repère l (égal à depuis si le réseau n'est pas orienté)
+  unsigned int *vers;
+//! fichier projeté en mémoire dont les tableaux sont tirés, NULL s'ils ont été alloués
+  void *projection;
+//! taille de la projection en octets
+  size_t taille;
+} Reperes;
+
+Reperes* ChoisitReperes(ReseauRoutier *r, int k, ChoixReperes choix, unsigned long long graine);
+void TermineReperes(Reperes *rp);
+long BorneReperes(Reperes *rp, int x, int t);
+int EcritReperes(Reperes *rp, char *nomfichier);
+Reperes* LitReperes(char *nomfichier);
+
+#endif /* REPERES_H */
@@ -0,0 +1,483 @@
+/*! \file serveur.c
+    \brief serveur de requêtes local : le graphe et ses précalculs restent chargés entre les requêtes
+
+    Usage : AEtoile.exe serve graphe (--unix chemin | --port p) [--threads n] [--metrique|--floyd]
+            AEtoile.exe charge (--unix chemin | --port p) [options]
+      --connexions c       connexions simultanées du générateur de charge (défaut : 4)
+      --requetes n         nombre total de requêtes (défaut : 1000)
+      --villes k           villes tirées au hasard par requête (défaut : 8)
+      --heuristique h      heuristique demandée (défaut : 3)
+      --delai ms           échéance de chaque requête, 0 pour aucune (défaut : 0)
+      --graine s           graine des tirages (défaut : 1)
+
+    Le serveur écoute sur une socket Unix ou sur 127.0.0.1 ; chaque thread accepte
+    une connexion et la sert jusqu'à sa fermeture. Protocole ligne à ligne :
+      INFO                                  -> OK nsom n
+      TOURNEE h delai_ms depart ville ...   -> OK cout ville ... ville (chemin routier avec --metrique)
+                                               AUCUNE     (pas de tournée)
+                                               ECHEANCE   (délai dépassé)
+                                               ERREUR message
+    Les villes d'une requête TOURNEE suivent les règles du mode batch (voir lot.c),
+    le délai (0 : aucun) court à partir de la réception de la requête.
+*/
+#include "serveur.h"
+#include "floyd.h"
+#include "bench.h"
+#include <unistd.h>
+#include <errno.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+/* ====================================================================== */
+/* ====================================================================== */
+/* SOCKETS */
+/* ====================================================================== */
+/* ====================================================================== */
+
+/* ====================================================================== */
+/*! \fn int OuvreEcoute(const char *chemin, int port)
+    \param chemin : chemin de la socket Unix, ou NULL pour TCP
+    \param port : port TCP sur 127.0.0.1 (si chemin est NULL)
+    \return la socket d'écoute, -1 en cas d'erreur
+    \brief ouvre la socket d'écoute du serveur (un ancien fichier de socket est remplacé)
+*/
+int OuvreEcoute(const char *chemin, int port){
+  int s, un = 1;
+
+  if (chemin != NULL){
+    struct sockaddr_un adr;
+    if (strlen(chemin) >= sizeof(adr.sun_path)){
+      fprintf(stderr, "OuvreEcoute : chemin trop long\n");
+      return -1;
+    }
+    s = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (s < 0){ perror("OuvreEcoute : socket"); return -1; }
+    memset(&adr, 0, sizeof(adr));
+    adr.sun_family = AF_UNIX;
+    strcpy(adr.sun_path, chemin);
+    unlink(chemin);
+    if (bind(s, (struct sockaddr *)&adr, sizeof(adr)) < 0){
+      perror("OuvreEcoute : bind");
+      close(s);
+      return -1;
+    }
+  } else {
+    struct sockaddr_in adr;
+    s = socket(AF_INET, SOCK_STREAM, 0);
+    if (s < 0){ perror("OuvreEcoute : socket"); return -1; }
+    setsockopt(s, SOL_SOCKET, SO_REUSEADDR, &un, sizeof(un));
+    memset(&adr, 0, sizeof(adr));
+    adr.sin_family = AF_INET;
+    adr.sin_port = htons(port);
+    adr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (bind(s, (struct sockaddr *)&adr, sizeof(adr)) < 0){
+      perror("OuvreEcoute : bind");
+      close(s);
+      return -1;
+    }
+  }
+  if (listen(s, 128) < 0){
+    perror("OuvreEcoute : listen");
+    close(s);
+    return -1;
+  }
+  return s;
+}
+
+/* ====================================================================== */
+/*! \fn int ConnecteServeur(const char *chemin, int port)
+    \param chemin : chemin de la socket Unix, ou NULL pour TCP
+    \param port : port TCP sur 127.0.0.1 (si chemin est NULL)
+    \return la socket connectée, -1 en cas d'erreur
+*/
+int ConnecteServeur(const char *chemin, int port){
+  int s, un = 1;
+
+  if (chemin != NULL){
+    struct sockaddr_un adr;
+    s = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (s < 0){ perror("ConnecteServeur : socket"); return -1; }
+    memset(&adr, 0, sizeof(adr));
+    adr.sun_family = AF_UNIX;
+    strncpy(adr.sun_path, chemin, sizeof(adr.sun_path) - 1);
+    if (connect(s, (struct sockaddr *)&adr, sizeof(adr)) < 0){
+      perror("ConnecteServeur : connect");
+      close(s);
+      return -1;
+    }
+  } else {
+    struct sockaddr_in adr;
+    s = socket(AF_INET, SOCK_STREAM, 0);
+    if (s < 0){ perror("ConnecteServeur : socket"); return -1; }
+    memset(&adr, 0, sizeof(adr));
+    adr.sin_family = AF_INET;
+    adr.sin_port = htons(port);
+    adr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(s, (struct sockaddr *)&adr, sizeof(adr)) < 0){
+      perror("ConnecteServeur : connect");
+      close(s);
+      return -1;
+    }
+    setsockopt(s, IPPROTO_TCP, TCP_NODELAY, &un, sizeof(un));
+  }
+  return s;
+}
+
+/* ====================================================================== */
+/* ====================================================================== */
+/* SERVEUR */
+/* ====================================================================== */
+/* ====================================================================== */
+
+/* ====================================================================== */
+/*! \fn void TraiteRequeteServeur(Serveur *s, EspaceTravail *ws, int *marque, char *ligne, FILE *sortie)
+    \param s : le serveur
+    \param ws : espace de travail du thread
+    \param marque : tableau de s->G->nsom entiers nuls (voir LitRequeteLot)
+    \param ligne : la requête
+    \param sortie : flot où écrire la réponse (une ligne)
+    \brief traite une ligne du protocole (voir l'en-tête du fichier)
+*/
+void TraiteRequeteServeur(Serveur *s, EspaceTravail *ws, int *marque, char *ligne, FILE *sortie){
+  long long recue = horloge_ns();
+  OptionsSolveur options;
+  RequeteLot r;
+  int h, lu, pos = 0, i;
+  long delai;
+
+  if (!strncmp(ligne, "INFO", 4)){
+    fprintf(sortie, "OK nsom %d\n", s->G->nsom);
+    return;
+  }
+  if ((sscanf(ligne, "TOURNEE %d %ld %n", &h, &delai, &pos) != 2) || (pos == 0)){
+    fprintf(sortie, "ERREUR requete inconnue\n");
+    return;
+  }
+  if ((h < 1) || (h > 3)){
+    fprintf(sortie, "ERREUR heuristique inconnue\n");
+    return;
+  }
+  lu = LitRequeteLot(ligne + pos, s->G->nsom, marque, &r);
+  if (lu <= 0){
+    if (lu < 0) free(r.villes);
+    fprintf(sortie, "ERREUR villes invalides\n");
+    return;
+  }
+
+  OptionsParDefaut(&options);
+  options.heuristique = h;
+  options.echeance_ns = (delai > 0) ? recue + delai * 1000000LL : 0;
+  ResoutRequeteLot(s->base, &options, ws, &r);
+
+  if (r.tournee != NULL){
+    fprintf(sortie, "OK %ld", r.cout);
+    for (i = 0; i < r.longueur; i++) fprintf(sortie, " %d", r.tournee[i]);
+    fprintf(sortie, "\n");
+  }
+  else if (r.interrompue) fprintf(sortie, "ECHEANCE\n");
+  else fprintf(sortie, "AUCUNE\n");
+  free(r.villes);
+  free(r.tournee);
+}
+
+/* ====================================================================== */
+/*! \fn static void * TravailleurServeur(void *arg)
+    \param arg : le serveur
+    \brief boucle d'un thread : accepte une connexion et répond à ses requêtes jusqu'à sa fermeture
+*/
+static void * TravailleurServeur(void *arg){
+  Serveur *s = (Serveur *)arg;
+  EspaceTravail *ws = CreeEspaceTravail();
+  int *marque = (int *)calloc(s->G->nsom, sizeof(int));
+  char *ligne = NULL;
+  size_t capacite = 0;
+  int fd, un = 1;
+
+  if (marque == NULL)
+  {   fprintf(stderr, "TravailleurServeur : calloc failed\n");
+      exit(0);
+  }
+  for (;;){
+    fd = accept(s->ecoute, NULL, NULL);
+    if (fd < 0){
+      if (errno == EINTR) continue;
+      perror("serveur : accept");
+      break;
+    }
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &un, sizeof(un)); /* sans effet sur une socket Unix */
+    FILE *entree = fdopen(fd, "r");
+    FILE *sortie = fdopen(dup(fd), "w");
+    if ((entree == NULL) || (sortie == NULL)){
+      perror("serveur : fdopen");
+      if (entree) fclose(entree); else close(fd);
+      if (sortie) fclose(sortie);
+      continue;
+    }
+    while (getline(&ligne, &capacite, entree) != -1){
+      TraiteRequeteServeur(s, ws, marque, ligne, sortie);
+      fflush(sortie);
+      pthread_mutex_lock(&(s->verrou));
+      s->requetes++;
+      pthread_mutex_unlock(&(s->verrou));
+    }
+    fclose(entree);
+    fclose(sortie);
+  }
+
+  free(ligne);
+  free(marque);
+  TermineEspaceTravail(ws);
+  return NULL;
+}
+
+/* ====================================================================== */
+/*! \fn int ModeServeur(int argc, char **argv)
+    \param argc : nombre d'arguments (après "serve")
+    \param argv : arguments (après "serve")
+    \return 0 si tout s'est bien passé
+    \brief point d'entrée de "AEtoile.exe serve" (voir l'en-tête du fichier)
+*/
+int ModeServeur(int argc, char **argv){
+  char *nomgraphe = NULL, *chemin = NULL;
+  int port = -1, nthreads = (int)sysconf(_SC_NPROCESSORS_ONLN), metrique = 0, i;
+  long long debut;
+  pthread_t *threads;
+  Serveur s;
+
+  for (i = 0; i < argc; i++){
+    if (!strcmp(argv[i], "--unix") && (i + 1 < argc)) chemin = argv[++i];
+    else if (!strcmp(argv[i], "--port") && (i + 1 < argc)) port = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--threads") && (i + 1 < argc)) nthreads = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--metrique")) metrique = 1;
+    else if (!strcmp(argv[i], "--floyd")) metrique = 2;
+    else if (nomgraphe == NULL) nomgraphe = argv[i];
+    else {
+      fprintf(stderr, "serve : argument inconnu %s\n", argv[i]);
+      return 1;
+    }
+  }
+  if ((nomgraphe == NULL) || ((chemin == NULL) && (port < 0))){
+    fprintf(stderr, "Usage : ./AEtoile.exe serve graphe (--unix chemin | --port p) [--threads n] [--metrique|--floyd]\n");
+    return 1;
+  }
+  if (nthreads < 1) nthreads = 1;
+  signal(SIGPIPE, SIG_IGN); /* un client qui part ne doit pas arrêter le serveur */
+
+  memset(&s, 0, sizeof(Serveur));
+  s.ecoute = OuvreEcoute(chemin, port);
+  if (s.ecoute < 0) return 1;
+
+  debut = horloge_ns();
+  if ((s.G = ReadGraphe(nomgraphe)) == NULL){
+    close(s.ecoute);
+    if (chemin != NULL) unlink(chemin);
+    return 1;
+  }
+  if (metrique == 2) s.base = ContexteFloyd(s.G, NULL);
+  else s.base = metrique ? ContexteMetrique(s.G, NULL) : CreeContexte(s.G, NULL);
+  pthread_mutex_init(&(s.verrou), NULL);
+  fprintf(stderr, "serveur : %d villes chargées en %.3f s, %d threads\n",
+          s.G->nsom, (horloge_ns() - debut) / 1e9, nthreads);
+  if (chemin != NULL) fprintf(stderr, "serveur : à l'écoute sur %s\n", chemin);
+  else fprintf(stderr, "serveur : à l'écoute sur 127.0.0.1:%d\n", port);
+
+  threads = (pthread_t *)malloc(nthreads * sizeof(pthread_t));
+  if (threads == NULL)
+  {   fprintf(stderr, "ModeServeur : malloc failed\n");
+      exit(0);
+  }
+  for (i = 0; i < nthreads; i++)
+    pthread_create(&threads[i], NULL, TravailleurServeur, &s);
+  for (i = 0; i < nthreads; i++) pthread_join(threads[i], NULL);
+
+  close(s.ecoute);
+  if (chemin != NULL) unlink(chemin);
+  pthread_mutex_destroy(&(s.verrou));
+  free(threads);
+  TermineContexte(s.base);
+  TermineGraphe(s.G);
+  return 0;
+}
+
+/* ====================================================================== */
+/* ====================================================================== */
+/* GENERATEUR DE CHARGE */
+/* ====================================================================== */
+/* ====================================================================== */
+
+/*! \struct ClientCharge
+    \brief une connexion du générateur de charge et ses mesures
+*/
+typedef struct ClientCharge {
+  const char *chemin;
+  int port;
+  int heuristique;
+  int delai;
+  int villes;
+  unsigned long long graine;
+//! nombre de requêtes à envoyer
+  int nb;
+//! latence de chaque requête en microsecondes
+  double *latences;
+//! réponses par type
+  long ok, aucune, echeance, erreur;
+} ClientCharge;
+
+/* ====================================================================== */
+/*! \fn static void * ClientChargeThread(void *arg)
+    \param arg : la connexion à simuler
+    \brief envoie nb requêtes TOURNEE sur des villes tirées au hasard, une à la fois,
+           et mesure le temps entre l'envoi et la réception de chaque réponse
+*/
+static void * ClientChargeThread(void *arg){
+  ClientCharge *c = (ClientCharge *)arg;
+  char *ligne = NULL;
+  size_t capacite = 0;
+  int fd, nsom = 0, i, j, k, *villes;
+  Alea a;
+  FILE *entree, *sortie;
+
+  fd = ConnecteServeur(c->chemin, c->port);
+  if (fd < 0) exit(1);
+  entree = fdopen(fd, "r");
+  sortie = fdopen(dup(fd), "w");
+
+  fprintf(sortie, "INFO\n");
+  fflush(sortie);
+  if ((getline(&ligne, &capacite, entree) == -1) || (sscanf(ligne, "OK nsom %d", &nsom) != 1) || (nsom < 1)){
+    fprintf(stderr, "charge : réponse INFO inattendue\n");
+    exit(1);
+  }
+  villes = (int *)malloc(nsom * sizeof(int));
+  if (villes == NULL)
+  {   fprintf(stderr, "ClientChargeThread : malloc failed\n");
+      exit(0);
+  }
+  for (i = 0; i < nsom; i++) villes[i] = i;
+  k = (c->villes < nsom) ? c->villes : nsom;
+  InitAlea(&a, c->graine);
+
+  for (i = 0; i < c->nb; i++){
+    for (j = 0; j < k; j++){ /* Fisher-Yates partiel : k villes distinctes */
+      int r = j + AleaEntier(&a, nsom - j), t = villes[j];
+      villes[j] = villes[r];
+      villes[r] = t;
+    }
+    fprintf(sortie, "TOURNEE %d %d", c->heuristique, c->delai);
+    for (j = 0; j < k; j++) fprintf(sortie, " %d", villes[j]);
+    fprintf(sortie, "\n");
+
+    long long t0 = horloge_ns();
+    fflush(sortie);
+    if (getline(&ligne, &capacite, entree) == -1){
+      fprintf(stderr, "charge : connexion fermée par le serveur\n");
+      exit(1);
+    }
+    c->latences[i] = (horloge_ns() - t0) / 1e3;
+
+    if (!strncmp(ligne, "OK", 2)) c->ok++;
+    else if (!strncmp(ligne, "AUCUNE", 6)) c->aucune++;
+    else if (!strncmp(ligne, "ECHEANCE", 8)) c->echeance++;
+    else c->erreur++;
+  }
+
+  fclose(entree);
+  fclose(sortie);
+  free(villes);
+  free(ligne);
+  return NULL;
+}
+
+/* ====================================================================== */
+/*! \fn int ModeCharge(int argc, char **argv)
+    \param argc : nombre d'arguments (après "charge")
+    \param argv : arguments (après "charge")
+    \return 0 si tout s'est bien passé
+    \brief générateur de charge en boucle fermée : chaque connexion envoie une requête,
+           attend la réponse, puis envoie la suivante. Affiche le débit et les
+           quantiles de latence.
+*/
+int ModeCharge(int argc, char **argv){
+  char *chemin = NULL;
+  int port = -1, connexions = 4, requetes = 1000, villes = 8, heuristique = 3, delai = 0;
+  unsigned long long graine = 1;
+  int i, j, n, r;
+  long long debut;
+  double duree, *latences;
+  ClientCharge *clients;
+  pthread_t *threads;
+  MesureBench m;
+  long ok = 0, aucune = 0, echeance = 0, erreur = 0;
+
+  for (i = 0; i < argc; i++){
+    if (!strcmp(argv[i], "--unix") && (i + 1 < argc)) chemin = argv[++i];
+    else if (!strcmp(argv[i], "--port") && (i + 1 < argc)) port = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--connexions") && (i + 1 < argc)) connexions = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--requetes") && (i + 1 < argc)) requetes = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--villes") && (i + 1 < argc)) villes = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--heuristique") && (i + 1 < argc)) heuristique = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--delai") && (i + 1 < argc)) delai = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--graine") && (i + 1 < argc)) graine = strtoull(argv[++i], NULL, 10);
+    else {
+      fprintf(stderr, "charge : argument inconnu %s\n", argv[i]);
+      return 1;
+    }
+  }
+  if (((chemin == NULL) && (port < 0)) || (connexions < 1) || (requetes < 1) || (villes < 1)){
+    fprintf(stderr, "Usage : ./AEtoile.exe charge (--unix chemin | --port p) [--connexions c] [--requetes n]\n"
+                    "        [--villes k] [--heuristique h] [--delai ms] [--graine s]\n");
+    return 1;
+  }
+  if (connexions > requetes) connexions = requetes;
+
+  clients = (ClientCharge *)calloc(connexions, sizeof(ClientCharge));
+  threads = (pthread_t *)malloc(connexions * sizeof(pthread_t));
+  latences = (double *)malloc(requetes * sizeof(double));
+  if ((clients == NULL) || (threads == NULL) || (latences == NULL))
+  {   fprintf(stderr, "ModeCharge : malloc failed\n");
+      exit(0);
+  }
+
+  for (i = 0, n = 0; i < connexions; i++){
+    clients[i].chemin = chemin;
+    clients[i].port = port;
+    clients[i].heuristique = heuristique;
+    clients[i].delai = delai;
+    clients[i].villes = villes;
+    clients[i].graine = graine + 1000003ULL * i;
+    clients[i].nb = requetes / connexions + (i < requetes % connexions);
+    clients[i].latences = latences + n;
+    n += clients[i].nb;
+  }
+
+  debut = horloge_ns();
+  for (i = 0; i < connexions; i++)
+    pthread_create(&threads[i], NULL, ClientChargeThread, &clients[i]);
+  for (i = 0; i < connexions; i++) pthread_join(threads[i], NULL);
+  duree = (horloge_ns() - debut) / 1e9;
+
+  for (i = 0; i < connexions; i++){
+    ok += clients[i].ok;
+    aucune += clients[i].aucune;
+    echeance += clients[i].echeance;
+    erreur += clients[i].erreur;
+  }
+  StatistiquesBench(latences, requetes, &m); /* trie latences */
+  r = (int)ceil(0.99 * requetes) - 1;
+  j = (r < 0) ? 0 : r;
+
+  printf("charge : %d requêtes, %d connexions, %d villes, heuristique %d, en %.3f s : %.1f requêtes/s\n",
+         requetes, connexions, villes, heuristique, duree, requetes / duree);
+  printf("latence (us) : p50 %.1f  p95 %.1f  p99 %.1f  max %.1f  moyenne %.1f\n",
+         m.mediane, m.p95, latences[j], latences[requetes - 1], m.moyenne);
+  printf("réponses : ok %ld, aucune %ld, échéance %ld, erreur %ld\n", ok, aucune, echeance, erreur);
+
+  free(latences);
+  free(threads);
+  free(clients);
+  return 0;
+}
@@ -0,0 +1,30 @@
+/*! \file serveur.h
+    \brief serveur de requêtes local : le graphe et ses précalculs restent chargés entre les requêtes
+*/
+#ifndef SERVEUR_H
+#define SERVEUR_H
+
+#include "lot.h"
+
+/*! \struct Serveur
+    \brief état partagé par les threads du serveur
+*/
+typedef struct Serveur {
+//! socket d'écoute
+  int ecoute;
+//! graphe de base
+  graphe *G;
+//! contexte du graphe de base (lecture seule)
+  ContexteSolveur *base;
+//! nombre de requêtes traitées (statistique, sous verrou)
+  long requetes;
+  pthread_mutex_t verrou;
+} Serveur;
+
+int OuvreEcoute(const char *chemin, int port);
+int ConnecteServeur(const char *chemin, int port);
+void TraiteRequeteServeur(Serveur *s, EspaceTravail *ws, int *marque, char *ligne, FILE *sortie);
+int ModeServeur(int argc, char **argv);
+int ModeCharge(int argc, char **argv);
+
+#endif /* SERVEUR_H */
@@ -0,0 +1,194 @@
+/*! \file solveur.c
+    \brief contexte de résolution : précalculs partagés par toutes les recherches sur un même graphe
+*/
+#include "solveur.h"
+
+/* ====================================================================== */
+/*! \fn void OptionsParDefaut(OptionsSolveur *options)
+    \param options : options à initialiser
+    \brief heuristique 3, départ de la ville 0
+*/
+void OptionsParDefaut(OptionsSolveur *options){
+  memset(options, 0, sizeof(OptionsSolveur));
+  options->heuristique = 3;
+  options->depart = 0;
+}
+
+/* ====================================================================== */
+/*! \fn ContexteSolveur* AlloueContexte(int nsom, OptionsSolveur *options)
+    \param nsom : nombre de villes
+    \param options : options par défaut des résolutions (NULL : OptionsParDefaut)
+    \return un contexte dont la table des distances reste à remplir avant PrecalculeContexte
+*/
+ContexteSolveur* AlloueContexte(int nsom, OptionsSolveur *options){
+  ContexteSolveur *ctx;
+  long n = nsom;
+
+  ctx = (ContexteSolveur*)calloc(1, sizeof(ContexteSolveur));
+  if (ctx == NULL)
+  {   fprintf(stderr, "AlloueContexte : calloc failed\n");
+      exit(0);
+  }
+  ctx->nsom = nsom;
+  if (options != NULL) ctx->options = *options; else OptionsParDefaut(&(ctx->options));
+
+  ctx->dist = (long*)malloc(n * n * sizeof(long));
+  ctx->arcmin = (long*)malloc(n * sizeof(long));
+  ctx->arcArbre = (long*)calloc(n, sizeof(long));
+  if ((ctx->dist == NULL) || (ctx->arcmin == NULL) || (ctx->arcArbre == NULL))
+  {   fprintf(stderr, "AlloueContexte : malloc failed\n");
+      exit(0);
+  }
+  return ctx;
+}
+
+/* ====================================================================== */
+/*! \fn void PrecalculeContexte(ContexteSolveur *ctx)
+    \param ctx : un contexte dont la table des distances est remplie
+    \brief calcule les arêtes minimum (heuristique 1) et la forêt de poids minimum
+           par l'algorithme de Prim sur la table (heuristique 2)
+*/
+void PrecalculeContexte(ContexteSolveur *ctx){
+  int n = ctx->nsom;
+  int x, i, u;
+  long a, *cle;
+  int *dans;
+
+  /* arête minimum dans les deux sens, pour que l'heuristique 1 reste minorante */
+  for (x = 0; x < n; x++){
+    long m = LONG_MAX;
+    for (i = 0; i < n; i++)
+      if ((i != x) && (DISTANCE(ctx, x, i) >= 0) && (DISTANCE(ctx, x, i) < m)) m = DISTANCE(ctx, x, i);
+    ctx->arcmin[x] = (m == LONG_MAX) ? 0 : m;
+  }
+
+  /* Prim, relancé sur chaque composante : arcArbre[x] est le poids de l'arête vers le père */
+  cle = (long*)malloc(n * sizeof(long));
+  dans = (int*)calloc(n, sizeof(int));
+  if ((cle == NULL) || (dans == NULL))
+  {   fprintf(stderr, "PrecalculeContexte : malloc failed\n");
+      exit(0);
+  }
+  for (x = 0; x < n; x++) cle[x] = -1;
+  ctx->poidsArbreMin = 0;
+  for (i = 0; i < n; i++){
+    u = -1;
+    for (x = 0; x < n; x++) /* sommet hors de l'arbre le plus proche de l'arbre */
+      if (!dans[x] && (cle[x] >= 0) && ((u == -1) || (cle[x] < cle[u]))) u = x;
+    if (u == -1){ /* nouvelle composante : racine au premier sommet libre */
+      for (x = 0; dans[x]; x++);
+      u = x;
+      cle[u] = 0;
+    }
+    dans[u] = 1;
+    ctx->arcArbre[u] = cle[u];
+    ctx->poidsArbreMin += cle[u];
+    for (x = 0; x < n; x++)
+      if (!dans[x] && ((a = ARETE(ctx, u, x)) >= 0) && ((cle[x] < 0) || (a < cle[x]))) cle[x] = a;
+  }
+  free(cle);
+  free(dans);
+}
+
+/* ====================================================================== */
+/*! \fn ContexteSolveur* CreeContexte(graphe *G, OptionsSolveur *options)
+    \param G : le graphe des villes (doit rester valide tant que le contexte est utilisé)
+    \param options : options par défaut des résolutions (NULL : OptionsParDefaut)
+    \return le contexte
+    \brief calcule la table des distances de G, les arêtes minimum et l'arbre de poids minimum
+*/
+ContexteSolveur* CreeContexte(graphe *G, OptionsSolveur *options){
+  ContexteSolveur *ctx = AlloueContexte(G->nsom, options);
+  long n = G->nsom, i;
+  int x;
+  pcell p;
+
+  ctx->G = G;
+
+  /* mêmes valeurs que get_distance : l'arc (a,b) d'abord, puis (b,a) */
+  for (i = 0; i < n * n; i++) ctx->dist[i] = -1;
+  for (x = 0; x < n; x++)
+    for (p = G->gamma[x]; p != NULL; p = p->next)
+      if (DISTANCE(ctx, x, p->som) == -1) DISTANCE(ctx, x, p->som) = p->v_arc;
+  for (x = 0; x < n; x++)
+    for (p = G->gamma[x]; p != NULL; p = p->next)
+      if (DISTANCE(ctx, p->som, x) == -1) DISTANCE(ctx, p->som, x) = p->v_arc;
+
+  PrecalculeContexte(ctx);
+  return ctx;
+}
+
+/* ====================================================================== */
+/*! \fn ContexteSolveur* ContexteInduit(ContexteSolveur *base, int *villes, int k, OptionsSolveur *options)
+    \param base : contexte du graphe de base (lecture seule)
+    \param villes : k villes distinctes du contexte de base
+    \param k : nombre de villes
+    \param options : options par défaut des résolutions (NULL : celles de base)
+    \return le contexte du sous-problème ; la ville i est villes[i] dans le contexte de base
+    \brief vue du sous-problème induit par villes : ses distances sont recopiées de
+           la table de base en O(k^2), sans construire de graphe
+*/
+ContexteSolveur* ContexteInduit(ContexteSolveur *base, int *villes, int k, OptionsSolveur *options){
+  ContexteSolveur *ctx = AlloueContexte(k, (options != NULL) ? options : &(base->options));
+  int i, j;
+
+  ctx->villes = (int*)malloc(k * sizeof(int));
+  if (ctx->villes == NULL)
+  {   fprintf(stderr, "ContexteInduit : malloc failed\n");
+      exit(0);
+  }
+  memcpy(ctx->villes, villes, k * sizeof(int));
+
+  for (i = 0; i < k; i++){
+    long *ligne = base->dist + (long)villes[i] * base->nsom;
+    for (j = 0; j < k; j++) DISTANCE(ctx, i, j) = ligne[villes[j]];
+  }
+
+  PrecalculeContexte(ctx);
+  return ctx;
+}
+
+/* ====================================================================== */
+/*! \fn void TermineContexte(ContexteSolveur *ctx)
+    \param ctx : un contexte
+    \brief libère le contexte (mais pas le graphe)
+*/
+void TermineContexte(ContexteSolveur *ctx){
+  free(ctx->dist);
+  free(ctx->pred);
+  free(ctx->arcmin);
+  free(ctx->arcArbre);
+  free(ctx->villes);
+  free(ctx);
+}
+
+/* ====================================================================== */
+/*! \fn long PoidsArbreMin(ContexteSolveur *ctx, int *S, int k, long *cle)
+    \param ctx : un contexte
+    \param S : k villes distinctes (le tableau est permuté)
+    \param k : nombre de villes
+    \param cle : tableau de travail d'au moins k entrées
+    \return le poids de l'arbre de poids minimum couvrant S, -1 si S n'est pas connexe
+    \brief algorithme de Prim en O(k^2) sur la table des distances : les villes de
+           S[0..j-1] sont dans l'arbre, cle[i] est le poids de la plus petite arête
+           qui relie S[i] à l'arbre
+*/
+long PoidsArbreMin(ContexteSolveur *ctx, int *S, int k, long *cle){
+  long poids = 0, a;
+  int i, j, u, t;
+
+  if (k <= 1) return 0;
+  for (i = 1; i < k; i++) cle[i] = ARETE(ctx, S[0], S[i]);
+  for (j = 1; j < k; j++){
+    u = -1;
+    for (i = j; i < k; i++)
+      if ((cle[i] >= 0) && ((u == -1) || (cle[i] < cle[u]))) u = i;
+    if (u == -1) return -1;
+    poids += cle[u];
+    t = S[u]; S[u] = S[j]; S[j] = t;
+    cle[u] = cle[j];
+    for (i = j + 1; i < k; i++)
+      if (((a = ARETE(ctx, t, S[i])) >= 0) && ((cle[i] < 0) || (a < cle[i]))) cle[i] = a;
+  }
+  return poids;
+}
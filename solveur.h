@@ -0,0 +1,78 @@
+/*! \file solveur.h
+    \brief contexte de résolution : précalculs partagés par toutes les recherches sur un même graphe.
+
+    Un contexte est construit une fois par graphe (CreeContexte) puis n'est plus
+    que lu pendant les recherches : plusieurs threads peuvent appeler Resoudre
+    en même temps sur le même contexte, chacun avec son propre EspaceTravail.
+
+    Les recherches ne lisent que la table des distances : un sous-problème sur
+    k villes d'un grand graphe (ContexteInduit) se construit en O(k^2) en
+    recopiant les distances du contexte de base, sans toucher aux listes d'adjacence.
+*/
+#ifndef SOLVEUR_H
+#define SOLVEUR_H
+
+#include "espace.h"
+
+/*! \struct OptionsSolveur
+    \brief paramètres d'une résolution
+*/
+typedef struct OptionsSolveur {
+//! heuristique : 1 (arc minimum), 2 (arbre de poids minimum précalculé), 3 (arbre recalculé)
+  int heuristique;
+//! ville de départ (et d'arrivée) de la tournée
+  int depart;
+//! instant (horloge_ns) au-delà duquel la recherche est abandonnée, 0 : pas d'échéance
+  long long echeance_ns;
+//! 1 : évaluation paresseuse, l'heuristique d'un noeud n'est calculée qu'en tête de la
+//! liste ouverte (voir Resoudre ; sans effet pour l'heuristique 1)
+  int paresseuse;
+} OptionsSolveur;
+
+/*! \struct ContexteSolveur
+    \brief précalculs sur un graphe, en lecture seule pendant les recherches
+*/
+typedef struct ContexteSolveur {
+//! graphe des villes (non possédé par le contexte), NULL pour un sous-problème
+  graphe *G;
+//! pour un sous-problème : la ville i est la ville villes[i] du contexte de base ; NULL sinon
+  int *villes;
+//! nombre de villes
+  int nsom;
+//! distances : dist[a*nsom+b] vaut le poids de l'arc (a,b), à défaut celui de (b,a), à défaut -1
+  long *dist;
+//! 1 si dist est la fermeture métrique de G (les tournées se déplient en chemins routiers)
+  int metrique;
+//! si non NULL : pred[a*nsom+b] précède b sur un plus court chemin de a à b (-1 si aucun)
+  int *pred;
+//! poids de la plus petite arête incidente à chaque ville (0 si la ville est isolée)
+  long *arcmin;
+//! poids de l'arbre (de la forêt) de poids minimum (heuristique 2)
+  double poidsArbreMin;
+//! poids de l'arête qui relie chaque ville à son père dans l'arbre (0 pour une racine)
+  long *arcArbre;
+//! options utilisées quand Resoudre reçoit NULL
+  OptionsSolveur options;
+} ContexteSolveur;
+
+/*! \def DISTANCE(ctx, a, b)
+    \brief distance entre les villes a et b, -1 si elles ne sont pas reliées
+*/
+#define DISTANCE(ctx, a, b) ((ctx)->dist[(long)(a) * (ctx)->nsom + (b)])
+
+/*! \def ARETE(ctx, a, b)
+    \brief poids de l'arête {a,b} vue sans orientation (le plus petit des deux sens), -1 si absente
+*/
+#define ARETE(ctx, a, b) ((DISTANCE(ctx, a, b) < 0) ? DISTANCE(ctx, b, a) : \
+                          (DISTANCE(ctx, b, a) < 0) ? DISTANCE(ctx, a, b) : \
+                          min(DISTANCE(ctx, a, b), DISTANCE(ctx, b, a)))
+
+void OptionsParDefaut(OptionsSolveur *options);
+ContexteSolveur* AlloueContexte(int nsom, OptionsSolveur *options);
+void PrecalculeContexte(ContexteSolveur *ctx);
+ContexteSolveur* CreeContexte(graphe *G, OptionsSolveur *options);
+ContexteSolveur* ContexteInduit(ContexteSolveur *base, int *villes, int k, OptionsSolveur *options);
+void TermineContexte(ContexteSolveur *ctx);
+long PoidsArbreMin(ContexteSolveur *ctx, int *S, int k, long *cle);
+
+#endif /* SOLVEUR_H */
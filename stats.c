@@ -0,0 +1,65 @@
+/*! \file stats.c
+    \brief instrumentation de la recherche : compteurs de noeuds et chronomètres par phase
+*/
+#include "stats.h"
+#include <math.h>
+
+/* ====================================================================== */
+/*! \fn void InitStats(StatsRecherche *st)
+    \param st : mesures d'une recherche
+    \brief remet toutes les mesures à zéro
+*/
+void InitStats(StatsRecherche *st){
+  memset(st, 0, sizeof(StatsRecherche));
+}
+
+/* ====================================================================== */
+/*! \fn void TermineStats(StatsRecherche *st, int profondeur)
+    \param st : mesures d'une recherche
+    \param profondeur : nombre d'arcs de la solution (0 si pas de solution)
+    \brief calcule le facteur de branchement effectif par dichotomie sur
+           noeuds_generes = b + b^2 + ... + b^profondeur
+*/
+void TermineStats(StatsRecherche *st, int profondeur){
+  double bas = 0.0, haut, N = (double)st->noeuds_generes;
+  int i, k;
+
+  st->profondeur = profondeur;
+  st->branchement_effectif = 0.0;
+  if ((profondeur <= 0) || (N <= 0)) return;
+
+  haut = (N > 1.0) ? N : 1.0;
+  for (k = 0; k < 100; k++){
+    double b = (bas + haut) / 2, somme = 0.0, puissance = 1.0;
+    for (i = 0; (i < profondeur) && (somme <= N); i++){
+      puissance *= b;
+      somme += puissance;
+    }
+    if (somme > N) haut = b; else bas = b;
+  }
+  st->branchement_effectif = (bas + haut) / 2;
+}
+
+/* ====================================================================== */
+/*! \fn void EcritStatsJSON(FILE *f, StatsRecherche *st)
+    \param f : fichier de sortie
+    \param st : mesures d'une recherche
+    \brief écrit les mesures sous forme d'un objet JSON sur une ligne
+*/
+void EcritStatsJSON(FILE *f, StatsRecherche *st){
+#ifdef STATS_RECHERCHE
+  int active = 1;
+#else
+  int active = 0;
+#endif
+  fprintf(f, "{\"stats_actives\": %s, \"noeuds_developpes\": %ld, \"noeuds_generes\": %ld, "
+             "\"noeuds_elagues\": %ld, \"ouverte_max\": %ld, \"octets_max\": %ld, "
+             "\"appels_heuristique\": %ld, \"noeuds_reinseres\": %ld, \"profondeur\": %d, \"branchement_effectif\": %.4f, "
+             "\"ns_heuristique\": %lld, \"ns_extraction\": %lld, \"ns_insertion\": %lld, \"ns_developpement\": %lld, "
+             "\"ns_allocation\": %lld, \"ns_total\": %lld, \"interrompue\": %s}\n",
+          active ? "true" : "false", st->noeuds_developpes, st->noeuds_generes,
+          st->noeuds_elagues, st->ouverte_max, st->octets_max,
+          st->appels_heuristique, st->noeuds_reinseres, st->profondeur, st->branchement_effectif,
+          st->ns_heuristique, st->ns_extraction, st->ns_insertion, st->ns_developpement,
+          st->ns_allocation, st->ns_total, st->interrompue ? "true" : "false");
+}
@@ -0,0 +1,68 @@
+/*! \file stats.h
+    \brief instrumentation de la recherche : compteurs de noeuds et chronomètres par phase.
+
+    Les compteurs ne sont compilés qu'avec -DSTATS_RECHERCHE (make STATS=1, le défaut) ;
+    sans ce drapeau les macros STAT_* sont vides et la recherche ne paie rien.
+*/
+#ifndef STATS_H
+#define STATS_H
+
+#include "graphaux.h"
+
+/*! \struct StatsRecherche
+    \brief mesures d'une recherche. Les durées sont en nanosecondes, les tailles en octets.
+*/
+typedef struct StatsRecherche {
+//! noeuds extraits de la liste ouverte et développés
+  long noeuds_developpes;
+//! noeuds successeurs créés par DevelopNode
+  long noeuds_generes;
+//! successeurs rejetés sans entrer dans la liste ouverte
+  long noeuds_elagues;
+//! taille maximale atteinte par la liste ouverte
+  long ouverte_max;
+//! mémoire occupée par les noeuds vivants
+  long octets;
+//! maximum de octets au cours de la recherche
+  long octets_max;
+//! nombre d'appels à ComputeH
+  long appels_heuristique;
+//! noeuds remis dans la liste ouverte après le calcul de leur heuristique (évaluation paresseuse)
+  long noeuds_reinseres;
+//! profondeur de la solution (nombre d'arcs de la tournée), 0 si pas de solution
+  int profondeur;
+//! facteur de branchement effectif b* : noeuds_generes = b* + b*^2 + ... + b*^profondeur
+  double branchement_effectif;
+//! temps passé dans ComputeH
+  long long ns_heuristique;
+//! temps passé dans ExtractFirstOpen
+  long long ns_extraction;
+//! temps passé à insérer les successeurs dans la liste ouverte
+  long long ns_insertion;
+//! temps passé dans DevelopNode (heuristique et allocation comprises)
+  long long ns_developpement;
+//! temps passé à allouer et copier les noeuds successeurs
+  long long ns_allocation;
+//! durée totale de la recherche
+  long long ns_total;
+//! 1 si la recherche a été abandonnée à l'échéance (mesure toujours tenue, même sans STATS_RECHERCHE)
+  int interrompue;
+} StatsRecherche;
+
+#ifdef STATS_RECHERCHE
+#define STAT_AJOUTE(st, champ, v) ((st)->champ += (v))
+#define STAT_MAX(st, champ, v) do { if ((v) > (st)->champ) (st)->champ = (v); } while (0)
+#define STAT_DEBUT(t) long long t = horloge_ns()
+#define STAT_FIN(st, champ, t) ((st)->champ += horloge_ns() - (t))
+#else
+#define STAT_AJOUTE(st, champ, v) ((void)(st))
+#define STAT_MAX(st, champ, v) ((void)(st))
+#define STAT_DEBUT(t) ((void)0)
+#define STAT_FIN(st, champ, t) ((void)(st))
+#endif
+
+void InitStats(StatsRecherche *st);
+void TermineStats(StatsRecherche *st, int profondeur);
+void EcritStatsJSON(FILE *f, StatsRecherche *st);
+
+#endif /* STATS_H */
@@ -0,0 +1,101 @@
+/*! \file successeurs.c
+    \brief successeurs d'un noeud en bloc (voir successeurs.h)
+
+    DevelopNode essayait chaque ville l'une après l'autre : lecture de la distance, puis
+    NotInListSom, qui parcourt la liste des villes du noeud. Avec la ligne de distances de
+    la dernière ville (contiguë dans ctx->dist) et un masque des villes visitées, le filtre
+    (arc présent et ville non visitée) et le coût g + d des successeurs se calculent par
+    blocs de 4 villes : une comparaison à -1 et une addition sur 4 entiers de 64 bits, un
+    quartet du masque, puis les successeurs permis sont tassés en tête du bloc par une
+    permutation tabulée et écrits d'un coup.
+
+    Les successeurs sortent par ville croissante, comme dans la boucle scalaire : l'ordre
+    des noeuds développés, donc la tournée trouvée, ne dépend pas du noyau utilisé.
+*/
+#include "successeurs.h"
+
+// les noyaux lisent les long par lanes de 64 bits : x86-64 seulement (long fait 4 octets en i386)
+#if defined(__x86_64__)
+#include <immintrin.h>
+
+//! pour chaque quartet de villes permises, les rangs des villes permises en tête
+static const int COMPRESSION_VILLES[16][4] = {
+  {0, 0, 0, 0}, {0, 0, 0, 0}, {1, 0, 0, 0}, {0, 1, 0, 0},
+  {2, 0, 0, 0}, {0, 2, 0, 0}, {1, 2, 0, 0}, {0, 1, 2, 0},
+  {3, 0, 0, 0}, {0, 3, 0, 0}, {1, 3, 0, 0}, {0, 1, 3, 0},
+  {2, 3, 0, 0}, {0, 2, 3, 0}, {1, 2, 3, 0}, {0, 1, 2, 3}
+};
+
+//! les mêmes rangs en moitiés de 32 bits, pour tasser 4 coûts de 64 bits
+static const int COMPRESSION_COUTS[16][8] = {
+  {0, 1, 0, 1, 0, 1, 0, 1}, {0, 1, 0, 1, 0, 1, 0, 1}, {2, 3, 0, 1, 0, 1, 0, 1}, {0, 1, 2, 3, 0, 1, 0, 1},
+  {4, 5, 0, 1, 0, 1, 0, 1}, {0, 1, 4, 5, 0, 1, 0, 1}, {2, 3, 4, 5, 0, 1, 0, 1}, {0, 1, 2, 3, 4, 5, 0, 1},
+  {6, 7, 0, 1, 0, 1, 0, 1}, {0, 1, 6, 7, 0, 1, 0, 1}, {2, 3, 6, 7, 0, 1, 0, 1}, {0, 1, 2, 3, 6, 7, 0, 1},
+  {4, 5, 6, 7, 0, 1, 0, 1}, {0, 1, 4, 5, 6, 7, 0, 1}, {2, 3, 4, 5, 6, 7, 0, 1}, {0, 1, 2, 3, 4, 5, 6, 7}
+};
+
+/* ====================================================================== */
+/*! \fn static int SuccesseursAVX2(const long *ligne, const unsigned long long *visite, int nsom, long g, int *villes, long *couts)
+    \brief noyau AVX2 de Successeurs, par blocs de 4 villes (le reste en scalaire)
+*/
+__attribute__((target("avx2")))
+static int SuccesseursAVX2(const long *ligne, const unsigned long long *visite, int nsom, long g, int *villes,
+                           long *couts){
+  const __m256i absent = _mm256_set1_epi64x(-1), base = _mm256_set1_epi64x(g);
+  int i, m = 0, arcs, libres;
+  __m256i d, c;
+
+  for (i = 0; i + 4 <= nsom; i += 4){
+    d = _mm256_loadu_si256((const __m256i *)(ligne + i));
+    arcs = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(d, absent)));
+    // i est multiple de 4 : le quartet ne chevauche pas deux mots du masque
+    libres = ~(arcs | (int)(visite[i >> 6] >> (i & 63))) & 0xF;
+    if (libres == 0) continue;
+    c = _mm256_permutevar8x32_epi32(_mm256_add_epi64(d, base),
+                                    _mm256_loadu_si256((const __m256i *)COMPRESSION_COUTS[libres]));
+    _mm256_storeu_si256((__m256i *)(couts + m), c);
+    _mm_storeu_si128((__m128i *)(villes + m),
+                     _mm_add_epi32(_mm_set1_epi32(i), _mm_loadu_si128((const __m128i *)COMPRESSION_VILLES[libres])));
+    m += __builtin_popcount(libres);
+  }
+  for (; i < nsom; i++)
+    if ((ligne[i] != -1) && !((visite[i >> 6] >> (i & 63)) & 1)){
+      villes[m] = i;
+      couts[m++] = g + ligne[i];
+    }
+  return m;
+}
+#endif
+
+/* ====================================================================== */
+/*! \fn int SuccesseursScalaire(const long *ligne, const unsigned long long *visite, int nsom, long g, int *villes, long *couts)
+    \brief version scalaire de Successeurs (processeurs sans AVX2)
+*/
+int SuccesseursScalaire(const long *ligne, const unsigned long long *visite, int nsom, long g, int *villes,
+                        long *couts){
+  int i, m = 0;
+  for (i = 0; i < nsom; i++)
+    if ((ligne[i] != -1) && !((visite[i >> 6] >> (i & 63)) & 1)){
+      villes[m] = i;
+      couts[m++] = g + ligne[i];
+    }
+  return m;
+}
+
+/* ====================================================================== */
+/*! \fn int Successeurs(const long *ligne, const unsigned long long *visite, int nsom, long g, int *villes, long *couts)
+    \param ligne : distances de la dernière ville du noeud vers les nsom villes (-1 : pas d'arc)
+    \param visite : masque des villes interdites (MOTS_MASQUE(nsom) mots)
+    \param nsom : nombre de villes
+    \param g : coût du noeud
+    \param villes : reçoit les villes permises, par ordre croissant (nsom + SUCCESSEURS_MARGE cases)
+    \param couts : reçoit g + ligne[v] pour chacune (nsom + SUCCESSEURS_MARGE cases)
+    \return le nombre de successeurs
+    \brief choisit le noyau AVX2 si le processeur le permet
+*/
+int Successeurs(const long *ligne, const unsigned long long *visite, int nsom, long g, int *villes, long *couts){
+#if defined(__x86_64__)
+  if (__builtin_cpu_supports("avx2")) return SuccesseursAVX2(ligne, visite, nsom, g, villes, couts);
+#endif
+  return SuccesseursScalaire(ligne, visite, nsom, g, villes, couts);
+}
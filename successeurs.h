@@ -0,0 +1,29 @@
+/*! \file successeurs.h
+    \brief successeurs d'un noeud en bloc : à partir de la ligne de distances de sa
+           dernière ville et du masque des villes visitées, les villes permises et le coût
+           g de chaque successeur (AVX2 si le processeur le permet, scalaire sinon)
+*/
+#ifndef SUCCESSEURS_H
+#define SUCCESSEURS_H
+
+/*! \def SUCCESSEURS_MARGE
+    \brief cases en plus de nsom que doivent avoir les tableaux villes et couts de
+           Successeurs (le noyau AVX2 écrit des blocs de 4 successeurs)
+*/
+#define SUCCESSEURS_MARGE 4
+
+/*! \def MOTS_MASQUE(nsom)
+    \brief nombre de mots de 64 bits d'un masque de nsom villes
+*/
+#define MOTS_MASQUE(nsom) (((nsom) + 63) / 64)
+
+/*! \def MARQUE_VISITE(visite, i) / EFFACE_VISITE(visite, i)
+    \brief met à 1 / à 0 le bit de la ville i du masque visite
+*/
+#define MARQUE_VISITE(visite, i) ((visite)[(i) >> 6] |= 1ULL << ((i) & 63))
+#define EFFACE_VISITE(visite, i) ((visite)[(i) >> 6] &= ~(1ULL << ((i) & 63)))
+
+int SuccesseursScalaire(const long *ligne, const unsigned long long *visite, int nsom, long g, int *villes, long *couts);
+int Successeurs(const long *ligne, const unsigned long long *visite, int nsom, long g, int *villes, long *couts);
+
+#endif /* SUCCESSEURS_H */
@@ -0,0 +1,248 @@
+/*! \file table.c
+    \brief tables de distances plusieurs-à-plusieurs sur la carte routière : toutes les
+           distances entre un ensemble de sources et un ensemble de cibles
+
+    Avec une hiérarchie de contraction (hierarchie.c), la table se calcule par seaux :
+    une recherche montante complète depuis chaque cible, sur les arcs descendants, dépose
+    dans le seau de chaque sommet atteint x le couple (cible, d(x, cible)) ; puis une
+    recherche montante depuis chaque source s parcourt les seaux des sommets qu'elle
+    atteint, et d(s, cible) est le plus petit d(s, x) + d(x, cible). Chaque recherche ne
+    visite que quelques centaines de sommets, au lieu de tout le graphe pour un Dijkstra
+    depuis chaque source (TableDijkstra, qui sert de référence et de repli sans hiérarchie).
+
+    Les recherches des cibles, puis celles des sources, sont réparties entre les threads
+    OpenMP ; chaque ligne de la table n'est écrite que par le thread de sa source.
+
+    La table est rangée comme celle d'un contexte de résolution (dist[i * nc + j], -1 entre
+    sommets non reliés) : ContexteTable en fait directement le contexte du voyageur de
+    commerce sur les villes choisies.
+*/
+#include "table.h"
+#include "vdc.h"
+#include "graphaux.h"
+#include <omp.h>
+
+/* ====================================================================== */
+/*! \fn void TableDijkstra(ReseauRoutier *r, int *sources, int ns, int *cibles, int nc, long *dist)
+    \param r : un réseau
+    \param sources : ns sommets
+    \param ns : nombre de sources
+    \param cibles : nc sommets
+    \param nc : nombre de cibles
+    \param dist : (sortie) dist[i * nc + j] est la distance de sources[i] à cibles[j], -1 sans chemin
+    \brief un Dijkstra complet par source, les sources étant réparties entre les threads
+*/
+void TableDijkstra(ReseauRoutier *r, int *sources, int ns, int *cibles, int nc, long *dist){
+#pragma omp parallel
+  {
+    RechercheChemin rc;
+    int i, j;
+    InitRechercheChemin(&rc, r->g->nsom);
+#pragma omp for schedule(dynamic, 1)
+    for (i = 0; i < ns; i++){
+      DijkstraToutes(r, &rc, sources[i]);
+      for (j = 0; j < nc; j++) dist[(long)i * nc + j] = DistanceAtteinte(&rc, cibles[j]);
+    }
+    TermineRechercheChemin(&rc);
+  }
+}
+
+/* ====================================================================== */
+/*! \fn void TableHierarchie(Hierarchie *h, int *sources, int ns, int *cibles, int nc, long *dist)
+    \param h : une hiérarchie
+    \param sources : ns sommets
+    \param ns : nombre de sources
+    \param cibles : nc sommets
+    \param nc : nombre de cibles
+    \param dist : (sortie) dist[i * nc + j] est la distance de sources[i] à cibles[j], -1 sans chemin
+    \brief calcul par seaux (voir l'en-tête du fichier) ; les seaux sont rangés par sommet
+           (seau de x : indices debut[x] .. debut[x+1]-1 de seau_cible et seau_dist)
+*/
+void TableHierarchie(Hierarchie *h, int *sources, int ns, int *cibles, int nc, long *dist){
+  int n = h->nsom, j, e, x;
+  int **espaces, *tailles, *debut, *seau_cible;
+  long **distances, *seau_dist, total;
+
+  espaces = (int **)malloc(((nc > 0) ? nc : 1) * sizeof(int *));
+  distances = (long **)malloc(((nc > 0) ? nc : 1) * sizeof(long *));
+  tailles = (int *)malloc(((nc > 0) ? nc : 1) * sizeof(int));
+  debut = (int *)calloc(n + 2, sizeof(int));
+  if ((espaces == NULL) || (distances == NULL) || (tailles == NULL) || (debut == NULL))
+  {   fprintf(stderr, "TableHierarchie : malloc failed\n");
+      exit(0);
+  }
+
+  /* espaces de recherche des cibles */
+#pragma omp parallel
+  {
+    RechercheChemin rc;
+    int c, k;
+    InitRechercheChemin(&rc, n);
+#pragma omp for schedule(dynamic, 1)
+    for (c = 0; c < nc; c++){
+      RechercheMontante(h, &rc, cibles[c], 1);
+      tailles[c] = rc.natteints;
+      espaces[c] = (int *)malloc(rc.natteints * sizeof(int));
+      distances[c] = (long *)malloc(rc.natteints * sizeof(long));
+      if ((espaces[c] == NULL) || (distances[c] == NULL))
+      {   fprintf(stderr, "TableHierarchie : malloc failed\n");
+          exit(0);
+      }
+      for (k = 0; k < rc.natteints; k++){
+        espaces[c][k] = rc.atteints[k];
+        distances[c][k] = rc.dist[rc.atteints[k]];
+      }
+    }
+    TermineRechercheChemin(&rc);
+  }
+
+  /* seaux, par tri par dénombrement sur les sommets */
+  for (total = 0, j = 0; j < nc; j++){
+    total += tailles[j];
+    for (e = 0; e < tailles[j]; e++) debut[espaces[j][e] + 2]++;
+  }
+  for (x = 0; x < n; x++) debut[x + 2] += debut[x + 1];
+  seau_cible = (int *)malloc(((total > 0) ? total : 1) * sizeof(int));
+  seau_dist = (long *)malloc(((total > 0) ? total : 1) * sizeof(long));
+  if ((seau_cible == NULL) || (seau_dist == NULL))
+  {   fprintf(stderr, "TableHierarchie : malloc failed\n");
+      exit(0);
+  }
+  for (j = 0; j < nc; j++){
+    for (e = 0; e < tailles[j]; e++){
+      x = debut[espaces[j][e] + 1]++;
+      seau_cible[x] = j;
+      seau_dist[x] = distances[j][e];
+    }
+    free(espaces[j]);
+    free(distances[j]);
+  }
+
+  /* recherches des sources */
+#pragma omp parallel
+  {
+    RechercheChemin rc;
+    int i, k, b, y;
+    long d, nd, *ligne;
+    InitRechercheChemin(&rc, n);
+#pragma omp for schedule(dynamic, 1)
+    for (i = 0; i < ns; i++){
+      ligne = dist + (long)i * nc;
+      for (k = 0; k < nc; k++) ligne[k] = -1;
+      RechercheMontante(h, &rc, sources[i], 0);
+      for (k = 0; k < rc.natteints; k++){
+        y = rc.atteints[k];
+        d = rc.dist[y];
+        for (b = debut[y]; b < debut[y + 1]; b++){
+          nd = d + seau_dist[b];
+          if ((ligne[seau_cible[b]] < 0) || (nd < ligne[seau_cible[b]])) ligne[seau_cible[b]] = nd;
+        }
+      }
+    }
+    TermineRechercheChemin(&rc);
+  }
+
+  free(espaces);
+  free(distances);
+  free(tailles);
+  free(debut);
+  free(seau_cible);
+  free(seau_dist);
+}
+
+/* ====================================================================== */
+/*! \fn ContexteSolveur* ContexteTable(ReseauRoutier *r, Hierarchie *h, int *villes, int k, OptionsSolveur *options)
+    \param r : un réseau
+    \param h : sa hiérarchie, NULL pour un Dijkstra par ville
+    \param villes : k sommets distincts du réseau
+    \param k : nombre de villes
+    \param options : options par défaut des résolutions (NULL : OptionsParDefaut)
+    \return le contexte du voyageur de commerce sur les villes, la ville i étant le
+            sommet villes[i] du réseau, dont les distances sont les plus courts chemins
+*/
+ContexteSolveur* ContexteTable(ReseauRoutier *r, Hierarchie *h, int *villes, int k, OptionsSolveur *options){
+  ContexteSolveur *ctx = AlloueContexte(k, options);
+
+  ctx->villes = (int *)malloc(k * sizeof(int));
+  if (ctx->villes == NULL)
+  {   fprintf(stderr, "ContexteTable : malloc failed\n");
+      exit(0);
+  }
+  memcpy(ctx->villes, villes, k * sizeof(int));
+  if (h != NULL) TableHierarchie(h, villes, k, villes, k, ctx->dist);
+  else TableDijkstra(r, villes, k, villes, k, ctx->dist);
+  PrecalculeContexte(ctx);
+  return ctx;
+}
+
+/* ====================================================================== */
+/*! \fn int EssaiTable(ReseauRoutier *r, Hierarchie *h, int k, unsigned long long graine, int tournee)
+    \param r : un réseau
+    \param h : sa hiérarchie, NULL pour ne mesurer que les Dijkstra
+    \param k : nombre de villes tirées au hasard
+    \param graine : graine du tirage
+    \param tournee : si non nul, résout aussi le voyageur de commerce sur ces villes
+    \return 0 si les deux calculs donnent la même table, 1 sinon
+    \brief mesure le calcul de la table k x k par Dijkstra et par seaux (chemin --table)
+*/
+int EssaiTable(ReseauRoutier *r, Hierarchie *h, int k, unsigned long long graine, int tournee){
+  int n = r->g->nsom, i, *villes, ok = 1;
+  long *reference, *table, j;
+  long long t0;
+  char *choisi;
+  Alea a;
+
+  k = min(k, n);
+  villes = (int *)malloc(k * sizeof(int));
+  choisi = (char *)calloc(n, sizeof(char));
+  reference = (long *)malloc((long)k * k * sizeof(long));
+  table = (long *)malloc((long)k * k * sizeof(long));
+  if ((villes == NULL) || (choisi == NULL) || (reference == NULL) || (table == NULL))
+  {   fprintf(stderr, "EssaiTable : malloc failed\n");
+      exit(0);
+  }
+  InitAlea(&a, graine);
+  for (i = 0; i < k; i++){
+    do villes[i] = AleaEntier(&a, n); while (choisi[villes[i]]);
+    choisi[villes[i]] = 1;
+  }
+
+  t0 = horloge_ns();
+  TableDijkstra(r, villes, k, villes, k, reference);
+  printf("table %d x %d : dijkstra en %.3f s\n", k, k, (horloge_ns() - t0) / 1e9);
+  if (h != NULL){
+    t0 = horloge_ns();
+    TableHierarchie(h, villes, k, villes, k, table);
+    printf("table %d x %d : hierarchie en %.3f s\n", k, k, (horloge_ns() - t0) / 1e9);
+    for (j = 0; j < (long)k * k; j++)
+      if (table[j] != reference[j]){
+        fprintf(stderr, "table : %d -> %d, dijkstra %ld et hierarchie %ld diffèrent\n",
+                villes[j / k], villes[j % k], reference[j], table[j]);
+        ok = 0;
+        break;
+      }
+  }
+
+  if (tournee){
+    ContexteSolveur *ctx = ContexteTable(r, h, villes, k, NULL);
+    EspaceTravail *ws = CreeEspaceTravail();
+    pnode res;
+    t0 = horloge_ns();
+    res = Resoudre(ctx, NULL, ws, NULL);
+    if (res == NULL) printf("tournee : pas de solution\n");
+    else {
+      printf("tournee (cout %ld, %.3f s) :", res->estim_g, (horloge_ns() - t0) / 1e9);
+      for (i = 0; i < res->len; i++) printf(" %d", villes[res->listsom[i]]);
+      printf("\n");
+      freeNode(res);
+    }
+    TermineEspaceTravail(ws);
+    TermineContexte(ctx);
+  }
+
+  free(villes);
+  free(choisi);
+  free(reference);
+  free(table);
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,15 @@
+/*! \file table.h
+    \brief tables de distances plusieurs-à-plusieurs sur la carte routière : toutes les
+           distances entre un ensemble de sources et un ensemble de cibles
+*/
+#ifndef TABLE_H
+#define TABLE_H
+
+#include "hierarchie.h"
+
+void TableDijkstra(ReseauRoutier *r, int *sources, int ns, int *cibles, int nc, long *dist);
+void TableHierarchie(Hierarchie *h, int *sources, int ns, int *cibles, int nc, long *dist);
+ContexteSolveur* ContexteTable(ReseauRoutier *r, Hierarchie *h, int *villes, int k, OptionsSolveur *options);
+int EssaiTable(ReseauRoutier *r, Hierarchie *h, int k, unsigned long long graine, int tournee);
+
+#endif /* TABLE_H */
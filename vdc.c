@@ -1,5 +1,15 @@
 #include "vdc.h"
 #include "kruskal.h"
+#include "espace.h"
+#include "bench.h"
+#include "lot.h"
+#include "serveur.h"
+#include "floyd.h"
+#include "chemins.h"
+#include "amelioration.h"
+#include "faisceau.h"
+#include "compact.h"
+#include "minorant.h"
 #include <time.h>
 #ifdef GRAPHE_INC
 #include "graphaux.h"
@@ -10,9 +20,6 @@
 #endif
 #define GRAPHE_INC
 
-double poidsArbreMin = 0;
-graphe *ArbrePoidsMin;
-
 /* ====================================================================== */
 /*! \fn pnode AllocNode(int n)
     \param n : nombre de villes
@@ -36,6 +43,19 @@ void freeNode(pnode n){
     return;
 }
 
+/* ====================================================================== */
+/*! \fn void freeListe(pnode L)
+    \param L : liste de noeuds (peut être NULL)
+    \brief libère tous les noeuds de la liste
+*/
+void freeListe(pnode L){
+    while(L != NULL){
+        pnode suivant = L->next;
+        freeNode(L);
+        L = suivant;
+    }
+}
+
 /* ====================================================================== */
 /*! \fn pnode ExtractFirstOpen(pnode* Open)
     \param Open : liste des noeuds "ouverts"
@@ -176,26 +196,31 @@ long arcmin(int s, graphe* G){
 }
 
 /* ====================================================================== */
-/*! \fn long ComputeH(pnode p, graphe* G, int code)
-    \param p : un noeud
-    \param G : le graphe utilisé
-    \param code : le code de l'heuristique (choix parmi différentes possibilités)
-    \return : valeur de l'heuristique pour ce noeud
-    \brief calcule l'heuristique pour le noeud p
+/*! \fn static inline void MasqueNoeud(pnode p, ContexteSolveur *ctx, EspaceTravail* ws)
+    \brief construit dans ws->visite le masque des villes pour lesquelles NotInListSom(i, p)
+           est faux : celles du noeud, sauf le départ quand il ne manque que lui
 */
-long ComputeH(pnode p, graphe* G, int code){
+static inline void MasqueNoeud(pnode p, ContexteSolveur *ctx, EspaceTravail* ws){
+    ReserveEspaceSommets(ws, ctx->nsom);
+    memset(ws->visite, 0, MOTS_MASQUE(ctx->nsom) * sizeof(unsigned long long));
+    for(int k = 0; k < p->len; k++) MARQUE_VISITE(ws->visite, p->listsom[k]);
+    if(p->len == p->n-1) EFFACE_VISITE(ws->visite, p->listsom[0]);
+}
+
+/* ====================================================================== */
+/*! \fn static inline long CalculeH(pnode p, ContexteSolveur *ctx, const int code, EspaceTravail* ws)
+    \brief corps de ComputeH, toujours développé en ligne : appelé avec un code constant
+           (voir ResoudreSpecialise), le switch disparaît à la compilation
+*/
+static inline __attribute__((always_inline)) long CalculeH(pnode p, ContexteSolveur *ctx, const int code, EspaceTravail* ws){
     
     switch(code){
         // heuristique : g + distance sommet le + proche
         case 1:
             {
-                p->estim_f = p->estim_g;
-                for (int i = 0; i < G->nsom; i++)
-                {
-                    if(NotInListSom(i,p)){
-                        p->estim_f = p->estim_f + arcmin(i,G); // fonction H
-                    }
-                }
+                // somme des arcmin des villes non visitées (minorant.c)
+                MasqueNoeud(p, ctx, ws);
+                p->estim_f = p->estim_g + SommeLibres(ctx->arcmin, ws->visite, ctx->nsom);
             }    
             break;
             
@@ -203,83 +228,30 @@ long ComputeH(pnode p, graphe* G, int code){
         /* arbre poids minimum ici #KrusKalForever*/
         case 2:
             {
-                p->estim_f = poidsArbreMin;
+                p->estim_f = ctx->poidsArbreMin;
                 for(int i = 0; i<(p->len)-1;i++){
-                    pcell test = (ArbrePoidsMin->gamma[p->listsom[i]]);
-                    if(test != NULL){
-                        p->estim_f -= test->v_arc;
-                    }         
+                    p->estim_f -= ctx->arcArbre[p->listsom[i]];
                 }
                 p->estim_f += p->estim_g;
             }
             break;
 
-        /* abre de poids minimum re calculé */
+        /* arbre de poids minimum recalculé sur les villes restantes (Prim sur la table des distances) */
         case 3:
-            {   
-                graphe * GSym = fermetureSymEfficace(G);
-                int maxSoms = (G->nsom) - (p->len) + 2;
-                int maxArcs = GSym->narc;
-                graphe* inter = InitGraphe( maxSoms, maxArcs);
-                
-                int j = 0;
-                int correspondance[G->nsom];
-                for (int i = 0; i < G->nsom; i++)
-                {
-                    if( NotInListSom(i,p) || (p->listsom[(p->len)-1] == i) || (p->listsom[0] == i) ){
-                        correspondance[i] = j;
-                        j++;
-                    }else{
-                        correspondance[i] = -1;
-                    }
-                }
-                
+            {
+                ReserveEspaceSommets(ws, ctx->nsom);
+                int *S = ws->correspondance;
                 int k = 0;
-                for (int i = 0; i < maxArcs; i++)
+                for (int i = 0; i < ctx->nsom; i++)
                 {
-                    
-                    int somD = GSym->I[i];
-                    int corD = correspondance[somD];
-                    int somA = GSym->T[i];
-                    int corA = correspondance[somA];
-                    int poidsArc = GSym->poids[i];
-
-                    if( (corD != -1) && (corA != -1) && (somD != p->listsom[0]) && ( somA != p->listsom[(p->len)-1] ) ){
-                        inter->I[k] = corD;
-                        inter->T[k] = corA;
-                        inter->poids[k] = poidsArc;
-                        AjouteArcValue(inter, corD, corA, poidsArc);
-                        k++;
-                    }
-                    
-                }
-                
-                inter->narc = k;
-                bool test = true;
-                unsigned char* compCo = CC(inter,0);
-                for(int i = 0; i<maxSoms; i++){
-                    if(compCo[i] == 0){
-                        p->estim_f = LONG_MAX;
-                        test = false;
-                        break;
+                    if( NotInListSom(i,p) || (p->listsom[(p->len)-1] == i) || (p->listsom[0] == i) ){
+                        S[k++] = i;
                     }
                 }
-                free(compCo);
-
-                if(test && inter->narc>=1){
-                    double poidArbre = 0;
-                    graphe* useless = initGraphMin(inter,&poidArbre);
-                    p->estim_f = p->estim_g + poidArbre;
-                    TermineGraphe(useless); 
-                }else{
-                    p->estim_f = p->estim_g + 0;
-                }
-                
 
-                TermineGraphe(inter);
-                TermineGraphe(GSym);
-                    
-                         
+                long poidArbre = PoidsArbreMin(ctx, S, k, ws->cle);
+                // villes restantes non connexes (-1) : pas de minorant, on garde g
+                p->estim_f = p->estim_g + ((poidArbre > 0) ? poidArbre : 0);
             }
             break;
 
@@ -292,50 +264,114 @@ long ComputeH(pnode p, graphe* G, int code){
     return p->estim_f;
 }
 
+/* ====================================================================== */
+/*! \fn long ComputeH(pnode p, ContexteSolveur *ctx, int code, EspaceTravail* ws)
+    \param p : un noeud
+    \param ctx : contexte de résolution (précalculs du graphe)
+    \param code : le code de l'heuristique (choix parmi différentes possibilités)
+    \param ws : espace de travail de la recherche (tampons réutilisés)
+    \return : valeur de l'heuristique pour ce noeud
+    \brief calcule l'heuristique pour le noeud p
+*/
+long ComputeH(pnode p, ContexteSolveur *ctx, int code, EspaceTravail* ws){
+    return CalculeH(p, ctx, code, ws);
+}
+
 
 
 
 /* ====================================================================== */
-/*! \fn pnode DevelopNode(pnode p, graphe* G, int choix)
-    \param p : un noeud
-    \param G : table des distances entre villes
-    \param choix : choix de l'heuristique
-    \return la liste des nouveaux noeuds créés
-    \brief construit la liste des noeuds successeurs sur noeud p dans le graphe
+/*! \fn static inline pnode DevelopeNoeud(pnode p, ContexteSolveur *ctx, const int choix, EspaceTravail* ws, const int paresseuse)
+    \brief corps de DevelopNode, toujours développé en ligne (comme CalculeH). Si paresseuse,
+           les successeurs reçoivent un f provisoire, le plus grand de deux minorants :
+           l'heuristique 1, et pour l'heuristique 3 le h exact du père moins son arc le plus
+           court vers les villes restantes (l'arbre de poids minimum d'un ensemble privé
+           d'un sommet perd au plus l'arête la plus courte de ce sommet), f du père sinon
 */
-pnode DevelopNode(pnode p, graphe* G, int choix){
+static inline __attribute__((always_inline)) pnode DevelopeNoeud(pnode p, ContexteSolveur *ctx, const int choix, EspaceTravail* ws,
+                                                                 const int paresseuse){
+    STAT_DEBUT(t_dev);
+    StatsRecherche *st = &(ws->stats);
     pnode it_res = p;
-    long distance = 0;
-    for(int i = 0; i<G->nsom; i++){ //on parcours tous les sommets dans le graph
-        distance = get_distance(p->listsom[p->len-1],i,G);
-        if(NotInListSom(i,p) && distance!=-1) {
-            //printf("\nWeight entre %d et %d = %li", p->listsom[p->len-1], i,get_distance(p->listsom[p->len-1],i,G));
-            // si il n'est pas deja dans le noeud
-            // et il existe un arc
+    int nsucc, i;
+
+    // villes interdites : celles du noeud, sauf le départ quand il ne manque que lui
+    MasqueNoeud(p, ctx, ws);
+    // sommets non visités reliés à la dernière ville, et coût g de chaque successeur
+    nsucc = Successeurs(&DISTANCE(ctx, p->listsom[p->len-1], 0), ws->visite, ctx->nsom, p->estim_g,
+                        ws->succ_villes, ws->succ_couts);
+    if(choix == 1 || paresseuse){
+        // heuristique 1 de tous les successeurs d'un coup : celle du noeud moins arcmin[i],
+        // plus arcmin du départ pour les successeurs qui n'attendront plus que le retour
+        STAT_DEBUT(t_h);
+        long base = SommeLibres(ctx->arcmin, ws->visite, ctx->nsom);
+        if(p->len+1 == p->n-1) base += ctx->arcmin[p->listsom[0]];
+        MinorantsH1(ctx->arcmin, base, ws->succ_villes, ws->succ_couts, nsucc, ws->succ_estim);
+        STAT_FIN(st, ns_heuristique, t_h);
+        if(choix == 1) STAT_AJOUTE(st, appels_heuristique, nsucc);
+    }
+    long borne = p->estim_f;
+    if(paresseuse && choix == 3){
+        // arc le plus court de la dernière ville vers les villes restantes, départ compris
+        int u = p->listsom[p->len-1], depart = p->listsom[0];
+        long arc = (u != depart) ? DISTANCE(ctx, u, depart) : -1;
+        for(int s = 0; s < nsucc; s++)
+            if(arc == -1 || ws->succ_couts[s] - p->estim_g < arc) arc = ws->succ_couts[s] - p->estim_g;
+        borne = p->estim_f - p->estim_g - ((arc > 0) ? arc : 0); // g du successeur à ajouter
+    }
+    for(int s = 0; s < nsucc; s++){
+            i = ws->succ_villes[s];
 
+            STAT_DEBUT(t_alloc);
             pnode newnode = AllocNode(p->n);
             
             newnode->len = (p->len)+1;  // +1 sommet
             
             memcpy(newnode->listsom,p->listsom,sizeof(int) * p->n); // liste sommets d'avant
+            STAT_FIN(st, ns_allocation, t_alloc);
+            STAT_AJOUTE(st, noeuds_generes, 1);
+            STAT_AJOUTE(st, octets, TAILLE_NOEUD(p->n));
+            STAT_MAX(st, octets_max, st->octets);
             
             newnode->listsom[newnode->len-1] = i; // +1 sommet
 
             
-            newnode->estim_g = (p->estim_g) + distance ;//+ distance;
-            newnode->estim_f = ComputeH(newnode, G, choix) ;
+            newnode->estim_g = ws->succ_couts[s];
+            if(choix == 1) newnode->estim_f = ws->succ_estim[s];
+            else if(paresseuse){
+                newnode->estim_f = max(ws->succ_estim[s], (choix == 3) ? newnode->estim_g + borne : borne);
+                newnode->provisoire = 1;
+            }
+            else {
+                STAT_DEBUT(t_h);
+                newnode->estim_f = CalculeH(newnode, ctx, choix, ws) ;
+                STAT_FIN(st, ns_heuristique, t_h);
+                STAT_AJOUTE(st, appels_heuristique, 1);
+            }
             // MAJ des estimations
 
             it_res->next = newnode;  // ajoute node next
             it_res = it_res->next; 
-        }
-        
     }
     
+    STAT_FIN(st, ns_developpement, t_dev);
     return p->next;
 
 }
 
+/* ====================================================================== */
+/*! \fn pnode DevelopNode(pnode p, ContexteSolveur *ctx, int choix, EspaceTravail* ws)
+    \param p : un noeud
+    \param ctx : contexte de résolution (table des distances entre villes)
+    \param choix : choix de l'heuristique
+    \param ws : espace de travail de la recherche
+    \return la liste des nouveaux noeuds créés
+    \brief construit la liste des noeuds successeurs sur noeud p dans le graphe
+*/
+pnode DevelopNode(pnode p, ContexteSolveur *ctx, int choix, EspaceTravail* ws){
+    return DevelopeNoeud(p, ctx, choix, ws, 0);
+}
+
 /* ====================================================================== */
 /*! \fn void ajoutListe(pnode* L, pnode N)
     \param L : Liste de nodes
@@ -361,67 +397,128 @@ void ajoutListe(pnode* L, pnode N){
 }
 
 /* ====================================================================== */
-/*! \fn pnode AStar(int n, double *arc, int choix)
-    \param n : nombre de villes
+/*! \fn pnode AStar(int n, graphe *G, int choix)
+    \param n : nombre de villes + 1 (G->nsom+1)
     \param G : le graphe utilisé
     \param choix : le choix de l'heuristique (choix parmi différentes possibilités. 1 : heuristique des distances. 2 : arbre de poids minimum)
     \return le noeud de résolution A*
-    \brief algorithme A* pour le voyageur de commerce
+    \brief algorithme A* pour le voyageur de commerce, avec un contexte construit pour l'occasion
 */
 pnode AStar(int n, graphe *G, int choix){
+    OptionsSolveur options;
+    OptionsParDefaut(&options);
+    options.heuristique = choix;
+    ContexteSolveur *ctx = CreeContexte(G, &options);
+    pnode res = Resoudre(ctx, NULL, NULL, NULL);
+    TermineContexte(ctx);
+    return res;
+}
+
+/* ====================================================================== */
+/*! \fn static inline pnode ResoudreSpecialise(ContexteSolveur *ctx, OptionsSolveur *options, EspaceTravail *ws, StatsRecherche *stats, const int choix, const int paresseuse)
+    \param choix : l'heuristique ; les autres paramètres sont ceux de Resoudre (options non NULL)
+    \param paresseuse : évaluation paresseuse de l'heuristique (voir Resoudre)
+    \brief corps de Resoudre, toujours développé en ligne : chaque appel avec un choix
+           constant (ResoudreH1, ResoudreH2, ResoudreH3) produit une recherche dont
+           DevelopNode et ComputeH sont développés en ligne, sans switch par noeud
+*/
+static inline __attribute__((always_inline)) pnode ResoudreSpecialise(ContexteSolveur *ctx, OptionsSolveur *options,
+                                                                      EspaceTravail *ws, StatsRecherche *stats, const int choix,
+                                                                      const int paresseuse){
 
     // Initialisation
+    int n = ctx->nsom + 1;
+    int depart = options->depart;
+    // Tampons des heuristiques, réutilisés pour tous les noeuds
+    EspaceTravail *temporaire = NULL;
+    if(ws == NULL) ws = temporaire = CreeEspaceTravail();
+    InitStats(&(ws->stats));
+    StatsRecherche *st = &(ws->stats);
+    STAT_DEBUT(t_total);
 
     // Liste ouverte
     pnode LO = AllocNode(n);
-    LO->listsom[0] = 0;
+    LO->listsom[0] = depart;
     LO->len = 1;
+    LO->provisoire = paresseuse; // la racine aussi est évaluée à sa sortie
     int TLO = 1; //-> taille LO
     int i =0;
     // Iterateur sur la liste ouverte
     pnode ITLO = NULL;
+    pnode res = NULL;
+    STAT_AJOUTE(st, octets, TAILLE_NOEUD(n));
+    STAT_MAX(st, octets_max, st->octets);
+    STAT_MAX(st, ouverte_max, TLO);
 
+    long tours = 0;
     while(TLO > 0){
+        // échéance : l'horloge n'est lue qu'une itération sur 64
+        if(options->echeance_ns != 0 && (tours++ & 63) == 0 && horloge_ns() > options->echeance_ns){
+            freeListe(LO);
+            st->interrompue = 1;
+            break;
+        }
+
+        STAT_DEBUT(t_ext);
         ITLO = ExtractFirstOpen(&LO); // Si c'est le même que précédement alors break pour sortir de la boucle
+        STAT_FIN(st, ns_extraction, t_ext);
 
         ITLO->next = NULL;
         TLO--;
+
+        // évaluation paresseuse : l'heuristique n'est calculée qu'en tête de la liste ouverte,
+        // et le noeud y retourne si son f augmente (un noeud complet a déjà f = g). Le f
+        // exact est gardé même s'il est plus petit : ses successeurs partent de ce h.
+        if(paresseuse && ITLO->provisoire && ITLO->len < ITLO->n){
+            long provisoire = ITLO->estim_f;
+            STAT_DEBUT(t_h);
+            CalculeH(ITLO, ctx, choix, ws);
+            STAT_FIN(st, ns_heuristique, t_h);
+            STAT_AJOUTE(st, appels_heuristique, 1);
+            ITLO->provisoire = 0;
+            if(ITLO->estim_f > provisoire){
+                // remis en tête de liste, sans la parcourir (ExtractFirstOpen cherche le minimum partout)
+                ITLO->next = LO;
+                LO = ITLO;
+                TLO++;
+                STAT_AJOUTE(st, noeuds_reinseres, 1);
+                continue;
+            }
+        }
         
         if(ITLO->len == ITLO->n){ //Condition d'arret
 
-            pnode rem = LO;
-            if(rem != NULL){
-                pnode rem_next = rem->next;
-                while(rem_next!=NULL){
-                    freeNode(rem);
-                    rem = rem_next;
-                    rem_next = rem->next;
-                }
-                freeNode(rem);
-            }
-                
-            return ITLO;
+            freeListe(LO);
+            res = ITLO;
+            break;
         }
         
-        pnode developement = DevelopNode(ITLO,G,choix); // les nodes suivantes possibles (liste chainée)
+        STAT_AJOUTE(st, noeuds_developpes, 1);
+        pnode developement = DevelopeNoeud(ITLO,ctx,choix,ws,paresseuse); // les nodes suivantes possibles (liste chainée)
         
         freeNode(ITLO);
+        STAT_AJOUTE(st, octets, -TAILLE_NOEUD(n));
         
         pnode ITd = developement; // itération sur tt les possibilités
         
+        STAT_DEBUT(t_ins);
         while(ITd != NULL){ // on ajoute les noeuds possibles a LO
         
-            if(ITd->listsom[ITd->len - 1] == 0 && ITd->len != n){ //Si Pour une node : Listsom[len-1] = start->som et len != n (pas tt les villes parcourues)
+            if(ITd->listsom[ITd->len - 1] == depart && ITd->len != n){ //Si Pour une node : Listsom[len-1] = start->som et len != n (pas tt les villes parcourues)
                 pnode aFree = ITd;
                 ITd = ITd->next; // on passe a la possibilité suivante
                 freeNode(aFree);
+                STAT_AJOUTE(st, noeuds_elagues, 1);
+                STAT_AJOUTE(st, octets, -TAILLE_NOEUD(n));
                 continue;
             }
 
-            if(ITd->len == n && ITd->listsom[ITd->len - 1] != 0){ //Si Pour une node len = n et Listsom[n-1] != start->som (pas revenu au debut)
+            if(ITd->len == n && ITd->listsom[ITd->len - 1] != depart){ //Si Pour une node len = n et Listsom[n-1] != start->som (pas revenu au debut)
                 pnode aFree = ITd;
                 ITd = ITd->next; // on passe a la possibilité suivante
                 freeNode(aFree);
+                STAT_AJOUTE(st, noeuds_elagues, 1);
+                STAT_AJOUTE(st, octets, -TAILLE_NOEUD(n));
                 continue;
             }
 
@@ -434,12 +531,78 @@ pnode AStar(int n, graphe *G, int choix){
             TLO++;
             i++;
         }
+        STAT_FIN(st, ns_insertion, t_ins);
+        STAT_MAX(st, ouverte_max, TLO);
         
     }
-    return NULL; //Arrive là si aucune solution
+
+    STAT_FIN(st, ns_total, t_total);
+    if(stats != NULL){
+        *stats = ws->stats;
+        TermineStats(stats, (res != NULL) ? res->len - 1 : 0);
+    }
+    if(temporaire != NULL) TermineEspaceTravail(temporaire);
+    return res; // NULL si aucune solution
     
 }
 
+/*! \fn static pnode ResoudreH1(ContexteSolveur *ctx, OptionsSolveur *options, EspaceTravail *ws, StatsRecherche *stats)
+    \brief recherche spécialisée pour l'heuristique 1 (de même pour ResoudreH2 et ResoudreH3)
+*/
+static pnode ResoudreH1(ContexteSolveur *ctx, OptionsSolveur *options, EspaceTravail *ws, StatsRecherche *stats){
+    return ResoudreSpecialise(ctx, options, ws, stats, 1, 0);
+}
+
+static pnode ResoudreH2(ContexteSolveur *ctx, OptionsSolveur *options, EspaceTravail *ws, StatsRecherche *stats){
+    return ResoudreSpecialise(ctx, options, ws, stats, 2, 0);
+}
+
+static pnode ResoudreH3(ContexteSolveur *ctx, OptionsSolveur *options, EspaceTravail *ws, StatsRecherche *stats){
+    return ResoudreSpecialise(ctx, options, ws, stats, 3, 0);
+}
+
+static pnode ResoudreH3Paresseuse(ContexteSolveur *ctx, OptionsSolveur *options, EspaceTravail *ws, StatsRecherche *stats){
+    return ResoudreSpecialise(ctx, options, ws, stats, 3, 1);
+}
+
+/* ====================================================================== */
+/*! \fn pnode ResoudreGenerique(ContexteSolveur *ctx, OptionsSolveur *options, EspaceTravail *ws, StatsRecherche *stats)
+    \brief comme Resoudre, mais sans spécialisation : l'heuristique est choisie à chaque
+           noeud généré (référence du banc d'essai, moteur astar-generique)
+*/
+pnode ResoudreGenerique(ContexteSolveur *ctx, OptionsSolveur *options, EspaceTravail *ws, StatsRecherche *stats){
+    if(options == NULL) options = &(ctx->options);
+    return ResoudreSpecialise(ctx, options, ws, stats, options->heuristique, options->paresseuse);
+}
+
+/* ====================================================================== */
+/*! \fn pnode Resoudre(ContexteSolveur *ctx, OptionsSolveur *options, EspaceTravail *ws, StatsRecherche *stats)
+    \param ctx : contexte de résolution, qui n'est pas modifié
+    \param options : heuristique, ville de départ et échéance (NULL : options du contexte)
+    \param ws : espace de travail du thread appelant (NULL : un espace temporaire est créé)
+    \param stats : si non NULL, reçoit les mesures de la recherche (voir stats.h)
+    \return le noeud de résolution A* (tournée dans listsom, coût dans estim_g), NULL si pas de
+            solution ou si l'échéance est dépassée (ws->stats.interrompue vaut alors 1)
+    \brief algorithme A* pour le voyageur de commerce. La fonction est réentrante :
+           des threads qui utilisent des espaces de travail distincts peuvent
+           résoudre en même temps sur le même contexte. L'heuristique n'est lue qu'ici :
+           la recherche elle-même est spécialisée pour chaque heuristique.
+           Avec options->paresseuse, les successeurs entrent dans la liste ouverte avec un
+           f provisoire (heuristique 1, ou f du père s'il est plus grand) ; l'heuristique
+           choisie n'est calculée que pour les noeuds qui arrivent en tête, et un noeud dont
+           le f augmente y est remis. Les f provisoires étant des minorants, la tournée
+           reste optimale ; seuls les noeuds extraits paient l'arbre de poids minimum.
+*/
+pnode Resoudre(ContexteSolveur *ctx, OptionsSolveur *options, EspaceTravail *ws, StatsRecherche *stats){
+    if(options == NULL) options = &(ctx->options);
+    switch(options->heuristique){
+        case 1: return ResoudreH1(ctx, options, ws, stats);
+        case 2: return options->paresseuse ? ResoudreGenerique(ctx, options, ws, stats) : ResoudreH2(ctx, options, ws, stats);
+        case 3: return options->paresseuse ? ResoudreH3Paresseuse(ctx, options, ws, stats) : ResoudreH3(ctx, options, ws, stats);
+        default: return ResoudreGenerique(ctx, options, ws, stats); // heuristique inconnue : voir ComputeH
+    }
+}
+
 /* ====================================================================== */
 /*! \fn void AfficherArcs(graphe* G)
     \param G : le graphe utilisé
@@ -457,12 +620,23 @@ void AfficherArcs(graphe* G){
         
     }
 }
+/* ====================================================================== */
+/*! \fn graphe* randomConnexeGraphe(int n, int m, int code)
+    \param n : nombre de sommets
+    \param m : nombre d'arcs
+    \param code : disposition des arcs (voir GrapheAleatoire)
+    \return un graphe aléatoire connexe
+    \brief tire des graphes aléatoires jusqu'à en obtenir un connexe
+*/
 graphe* randomConnexeGraphe(int n, int m,int code){
+    Connexite c;
+    InitConnexite(&c);
     graphe* G = GrapheAleatoire(n,m,code);
-    while(!(isConnexe(G,0))){
-        free(G); // eliminer le new graphe si il est pas utile
+    while(!EstConnexe(&c, G)){
+        TermineGraphe(G); // eliminer le new graphe si il est pas utile
         G = GrapheAleatoire(n,m,code);
     }
+    TermineConnexite(&c);
     return G;
 }
 
@@ -472,8 +646,50 @@ int main(int argc, char **argv)
 /* ====================================================================== */
 {
       
-    if(argc != 3){
-        printf("Usage : ./AEtoile.exe file(null if bench) code(1/2/3)\n");
+    if(argc >= 2 && !strcmp(argv[1],"bench")){
+        return ModeBench(argc-2, argv+2);
+    }
+    if(argc >= 2 && !strcmp(argv[1],"batch")){
+        return ModeLot(argc-2, argv+2);
+    }
+    if(argc >= 2 && !strcmp(argv[1],"serve")){
+        return ModeServeur(argc-2, argv+2);
+    }
+    if(argc >= 2 && !strcmp(argv[1],"charge")){
+        return ModeCharge(argc-2, argv+2);
+    }
+    if(argc >= 2 && !strcmp(argv[1],"bench-fermeture")){
+        return ModeBenchFermeture(argc-2, argv+2);
+    }
+    if(argc >= 2 && !strcmp(argv[1],"chemin")){
+        return ModeChemin(argc-2, argv+2);
+    }
+    if(argc >= 2 && !strcmp(argv[1],"tournee")){
+        return ModeTournee(argc-2, argv+2);
+    }
+
+    // options du mode fichier
+    char *nomstats = NULL;
+    int metrique = 0, faisceau = 0, compact = 0, paresseuse = 0, erreur = (argc < 3);
+    for(int i = 3; i < argc; i++){
+        if(!strcmp(argv[i],"--stats") && i+1 < argc) nomstats = argv[++i];
+        else if(!strcmp(argv[i],"--metrique")) metrique = 1;
+        else if(!strcmp(argv[i],"--floyd")) metrique = 2;
+        else if(!strcmp(argv[i],"--faisceau") && i+1 < argc) faisceau = atoi(argv[++i]);
+        else if(!strcmp(argv[i],"--compact")) compact = 1;
+        else if(!strcmp(argv[i],"--paresseuse")) paresseuse = 1;
+        else erreur = 1;
+    }
+
+    if(erreur){
+        printf("Usage : ./AEtoile.exe file(null if bench) code(1/2/3) [--stats fichier|-] [--metrique|--floyd] [--faisceau largeur|--compact|--paresseuse]\n");
+        printf("        ./AEtoile.exe bench [options] (voir bench.c)\n");
+        printf("        ./AEtoile.exe batch graphe [requetes|-] [--threads n] [--heuristique h] [--metrique|--floyd] (voir lot.c)\n");
+        printf("        ./AEtoile.exe serve graphe (--unix chemin | --port p) [--threads n] [--metrique|--floyd] (voir serveur.c)\n");
+        printf("        ./AEtoile.exe charge (--unix chemin | --port p) [options] (voir serveur.c)\n");
+        printf("        ./AEtoile.exe bench-fermeture [options] (voir floyd.c)\n");
+        printf("        ./AEtoile.exe chemin graphe source cible [options] (voir chemins.c)\n");
+        printf("        ./AEtoile.exe tournee (graphe | --euclidien n) [options] (voir amelioration.c)\n");
         exit(-1);
     }
     
@@ -481,149 +697,52 @@ int main(int argc, char **argv)
     int code = atoi(argv[2]);
     graphe* G;	
     
-    if(!(strcasecmp(graphname,"null"))){
+    if(!(strcasecmp(graphname,"null"))){ // raccourci pour le banc d'essai
         printf("Mode Bench with code %d\n",code);
-        //Test incidence sommets
-        for (int j = 2; j < 10; j++){
-
-            char line[50];
-
-            FILE *fout1 = NULL;
-            char name[250];
-            sprintf(name,"H%d_incidence_som.txt",code);
-            fout1 = fopen(name,"a");
-
-            if(fout1==NULL){
-                printf("File not open lol\n");
-                exit(-1);
-            }
-
-            int nb_bench = 1;
-            double* values = (double*)malloc(nb_bench*sizeof(double));
-            double mean = 0.0;
-            int nb_arc = (((double)j * ((double)j - 1)) / 2);
-            printf("Pour %d sommets et %d arcs\n",j,nb_arc);
-
-            for (int i = 0; i < nb_bench; i++)
-            {    
-                struct timeval start,end;
-                pnode res = NULL;
-                do{
-                    G = randomConnexeGraphe(j,nb_arc,0);
-                             
-                    if(code == 2){ // si on fait du kruskal
-                        ArbrePoidsMin = initGraphMin(G,&poidsArbreMin);
-                    }
-
-                    
-                    gettimeofday(&start,NULL);
-                    res = AStar(G->nsom+1,G,code);
-                    gettimeofday(&end,NULL);
-                    if(code == 2){ // si on fait du kruskal
-                        TermineGraphe(ArbrePoidsMin);
-                    }
-                    TermineGraphe(G);
-                }while(res == NULL);
-
-                PrintSolution(res,G);
-                freeNode(res);
-                
-                values[i] = ((double) ((1000000 * end.tv_sec + end.tv_usec)- (1000000 * start.tv_sec + start.tv_usec)));
-                
-            }
-
-            //Sum of all values for mean
-            double sum = 0.0;
-            for (int i = 0; i < nb_bench; i++)
-            {
-                sum+=values[i];
-            }
-            mean = sum/nb_bench;//Compute mean value
-            printf("Average time taken : %.4f s\n\n",mean/1000000);
-        
-            sprintf(line,"%d;%d;%f\n",j,nb_arc,mean/1000000);
-            fprintf(fout1,"%s", line);
-            fclose(fout1);
-            free(values);
-        }
-
-        // Variation du nb d'arc
-        for (int j = 2; j < 10; j++){
-
-            char line[50];
-
-            FILE *fout1 = NULL;
-            char name[250];
-            sprintf(name,"H%d_incidence_arc.txt",code);
-            fout1 = fopen(name,"a");
-
-            if(fout1==NULL){
-                printf("File not open lol\n");
-                exit(-1);
-            }
-
-            for (int nb_arc = j; nb_arc <= (((double)j * ((double)j - 1)) / 2); nb_arc++){
-                int nb_bench = 1;
-                double* values = (double*)malloc(nb_bench*sizeof(double));
-                double mean = 0.0;
-                printf("Pour %d sommets et %d arcs\n",j,nb_arc);
-
-                for (int i = 0; i < nb_bench; i++)
-                {    
-                    struct timeval start,end;
-                    pnode res = NULL;
-                    do{
-                        G = randomConnexeGraphe(j,nb_arc,1);
-                                
-                        if(code == 2){ // si on fait du kruskal
-                            ArbrePoidsMin = initGraphMin(G,&poidsArbreMin);
-                        }
-
-                        
-                        gettimeofday(&start,NULL);
-                        res = AStar(G->nsom+1,G,code);
-                        gettimeofday(&end,NULL);
-                        if(code == 2){ // si on fait du kruskal
-                            TermineGraphe(ArbrePoidsMin);
-                        }
-                        TermineGraphe(G);
-                    }while(res == NULL);
-
-                    PrintSolution(res,G);
-                    freeNode(res);
-
-                    values[i] = ((double) ((1000000 * end.tv_sec + end.tv_usec)- (1000000 * start.tv_sec + start.tv_usec)));
-                    
-                }
-
-                //Sum of all values for mean
-                double sum = 0.0;
-                for (int i = 0; i < nb_bench; i++)
-                {
-                    sum+=values[i];
-                }
-                mean = sum/nb_bench;//Compute mean value
-                printf("Average time taken : %.4f s\n\n",mean/1000000);
-            
-                sprintf(line,"%d;%d;%f\n",j,nb_arc,mean/1000000);
-                fprintf(fout1,"%s", line);
-                free(values);
-            }
-            fclose(fout1);
-        }
+        char heuristique[16];
+        sprintf(heuristique,"%d",code);
+        char *options[] = {(char*)"--heuristiques", heuristique};
+        return ModeBench(2, options);
     }
     else{
         G = ReadGraphe(graphname);
         printf("Mode File with code %d\n",code);
-        if(code == 2){ // si on fait du kruskal
-            ArbrePoidsMin = initGraphMin(G,&poidsArbreMin);
-        }
+        OptionsSolveur options;
+        OptionsParDefaut(&options);
+        options.heuristique = code;
+        // --paresseuse : heuristique calculée en tête de la liste ouverte seulement (voir Resoudre)
+        options.paresseuse = paresseuse;
+        // --metrique : distances de plus court chemin, les routes manquantes sont contournées
+        // --floyd : mêmes distances, calculées par Floyd-Warshall (graphes denses)
+        ContexteSolveur *ctx;
+        if(metrique == 2) ctx = ContexteFloyd(G, &options);
+        else ctx = metrique ? ContexteMetrique(G, &options) : CreeContexte(G, &options);
 
         struct timeval start,end;
+        StatsRecherche stats;
         gettimeofday(&start,NULL);
         
-        pnode res = AStar(G->nsom+1,G,code);
+        // --faisceau k : recherche en faisceau de largeur k (tournée approchée, voir faisceau.c)
+        pnode res;
+        if(faisceau > 0){
+            Faisceau *f = CreeFaisceau(faisceau, ctx->nsom);
+            res = ResoudreFaisceau(f, ctx, NULL, &stats);
+            TermineFaisceau(f);
+        }
+        // --compact : A* sur noeuds de 24 octets (au plus 64 villes, voir compact.c)
+        else if(compact) res = ResoudreCompact(ctx, NULL, NULL, NULL, &stats);
+        else res = Resoudre(ctx, NULL, NULL, &stats);
         gettimeofday(&end,NULL);
+
+        if(nomstats != NULL){ // mesures de la recherche au format JSON
+            FILE *fstats = strcmp(nomstats,"-") ? fopen(nomstats,"w") : stdout;
+            if(fstats == NULL){
+                printf("Impossible d'ouvrir %s\n",nomstats);
+                exit(-1);
+            }
+            EcritStatsJSON(fstats,&stats);
+            if(fstats != stdout) fclose(fstats);
+        }
         
         if(res == NULL){ // si il n'y a pas de chemin possible
             printf("Pas de solution pour ce graphe.\n");
@@ -631,14 +750,19 @@ int main(int argc, char **argv)
         }
 
         PrintSolution(res,G);
+        if(metrique){ // chaque étape de la tournée suit un plus court chemin
+            int longueur;
+            int *chemin = DeplieTournee(ctx, res->listsom, res->len, &longueur);
+            printf("Chemin routier (cout %ld) :\n", res->estim_g);
+            for(int i = 0; i < longueur; i++) printf((i+1 < longueur) ? "%d -> " : "%d\n", chemin[i]);
+            free(chemin);
+        }
         freeNode(res);
     
         double values = ((double) ((1000000 * end.tv_sec + end.tv_usec)- (1000000 * start.tv_sec + start.tv_usec)));
         printf("Time taken :  %.4f s\n",values/1000000);
+        TermineContexte(ctx);
         TermineGraphe(G);
-        if(code == 2){
-            TermineGraphe(ArbrePoidsMin);
-        }
     }
     
 	return 0;
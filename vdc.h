@@ -1,3 +1,8 @@
+#ifndef VDC_H
+#define VDC_H
+
+#include "solveur.h"
+
 /*! \struct node
     \brief structure pour les noeuds du Graphe de Résolution de Problème (GRP)
 */
@@ -12,6 +17,8 @@ typedef struct node {
   int len;
 //! nombre total de villes
   int n;
+//! 1 si estim_f n'est qu'un minorant provisoire (évaluation paresseuse, voir Resoudre)
+  int provisoire;
 //! suite de la liste ou pointeur NULL
   struct node * next; 
 } node;
@@ -21,3 +28,28 @@ typedef struct node {
 */
 typedef node * pnode; 
 
+/*! \def TAILLE_NOEUD(n)
+    \brief mémoire occupée par un noeud de n villes
+*/
+#define TAILLE_NOEUD(n) ((long)(sizeof(node) + (n) * sizeof(int)))
+
+/* ================================================ */
+/* prototypes */
+/* ================================================ */
+
+pnode AllocNode(int n);
+void freeNode(pnode n);
+void freeListe(pnode L);
+pnode ExtractFirstOpen(pnode* Open);
+void PrintSolution(pnode P, graphe* G);
+int NotInListSom(int s, pnode p);
+long get_distance(int a, int b, graphe* G);
+long arcmin(int s, graphe* G);
+long ComputeH(pnode p, ContexteSolveur *ctx, int code, EspaceTravail* ws);
+pnode DevelopNode(pnode p, ContexteSolveur *ctx, int choix, EspaceTravail* ws);
+void ajoutListe(pnode* L, pnode N);
+pnode Resoudre(ContexteSolveur *ctx, OptionsSolveur *options, EspaceTravail *ws, StatsRecherche *stats);
+pnode ResoudreGenerique(ContexteSolveur *ctx, OptionsSolveur *options, EspaceTravail *ws, StatsRecherche *stats);
+pnode AStar(int n, graphe *G, int choix);
+
+#endif /* VDC_H */